@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name:   adc_sim.c
+*
+* Description: This file contains the simulated ADC. Each conversion returns the next
+*              point of a triangle wave plus noise from a linear congruential generator,
+*              so the sampler and the time-series store can run without a sensor.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "adc_sim.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Constants of the noise generator (Numerical Recipes) */
+#define LCG_MULTIPLIER           (1664525u)
+#define LCG_INCREMENT            (1013904223u)
+#define LCG_SEED                 (12345u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Position of each channel in its wave, in conversions */
+static uint32_t wave_position[ADC_SIM_CHANNELS];
+static uint32_t noise_state = LCG_SEED;
+
+/*******************************************************************************
+* Function Name: adc_sim_read
+********************************************************************************
+* Summary:
+*  Performs a simulated conversion. The cost is a few cycles, so it can be
+*  called from an interrupt.
+*
+* Parameters:
+*  uint32_t channel : Input to convert, below ADC_SIM_CHANNELS
+*
+* Return:
+*  int32_t : 12-bit result, or 0 for an invalid channel
+*
+*******************************************************************************/
+int32_t adc_sim_read(uint32_t channel)
+{
+    uint32_t period;
+    uint32_t position;
+    int32_t ramp;
+    int32_t noise;
+    int32_t code;
+
+    if (channel >= ADC_SIM_CHANNELS)
+    {
+        return 0;
+    }
+
+    period = ADC_SIM_WAVE_CONVERSIONS * (channel + 1u);
+    position = wave_position[channel];
+    wave_position[channel] = (position + 1u) % period;
+
+    /* Rises over the first half of the period and falls over the second */
+    ramp = (int32_t)((position < (period / 2u)) ? position : (period - position));
+    ramp = ((ramp * 4 * ADC_SIM_AMPLITUDE) / (int32_t)period) - ADC_SIM_AMPLITUDE;
+
+    noise_state = (noise_state * LCG_MULTIPLIER) + LCG_INCREMENT;
+    noise = (int32_t)((noise_state >> 16) % (uint32_t)((2 * ADC_SIM_NOISE) + 1)) - ADC_SIM_NOISE;
+
+    code = ADC_SIM_MID_CODE + ramp + noise;
+    if (code < 0)
+    {
+        code = 0;
+    }
+    else if (code > ADC_SIM_MAX_CODE)
+    {
+        code = ADC_SIM_MAX_CODE;
+    }
+    else
+    {
+        /* Within the range of the converter */
+    }
+
+    return code;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   adc_sim.h
+*
+* Description: This file contains the declarations of the simulated ADC that stands in
+*              for the sensor inputs of the sampler.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ADC_SIM_H
+#define ADC_SIM_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of simulated inputs */
+#define ADC_SIM_CHANNELS         (4u)
+
+/* 12-bit result: a triangle wave around mid-scale with uniform noise */
+#define ADC_SIM_MAX_CODE         (4095)
+#define ADC_SIM_MID_CODE         (2048)
+#define ADC_SIM_AMPLITUDE        (800)
+#define ADC_SIM_NOISE            (8)
+
+/* Conversions per period of the wave on channel 0; channel n is n+1 times
+ * slower */
+#define ADC_SIM_WAVE_CONVERSIONS (600u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int32_t adc_sim_read(uint32_t channel);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* ADC_SIM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,154 @@
+/******************************************************************************
+* File Name:   app_arena.c
+*
+* Description: This file contains the static scratch arena. The console flows
+*              never overlap, so their buffers are bump-allocated from one
+*              statically sized block and released in scope order with
+*              app_arena_mark() and app_arena_release().
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "app_arena.h"
+#include "string.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t arena[APP_ARENA_SIZE] CY_ALIGN(APP_ARENA_ALIGNMENT);
+static uint32_t arena_offset = 0u;
+static uint32_t arena_high_water = 0u;
+
+/*******************************************************************************
+* Function Name: app_arena_alloc
+********************************************************************************
+* Summary:
+*  Allocates a zero-initialized block from the arena. Over-allocation asserts
+*  in debug builds and returns NULL in release builds.
+*
+* Parameters:
+*  uint32_t size : Size of the block in bytes
+*
+* Return:
+*  void* : Start of the block, or NULL if the arena is exhausted
+*
+*******************************************************************************/
+void *app_arena_alloc(uint32_t size)
+{
+    uint8_t *block = NULL;
+    uint32_t end;
+
+    size = (size + APP_ARENA_ALIGNMENT - 1u) & ~(APP_ARENA_ALIGNMENT - 1u);
+    end = arena_offset + size;
+
+    /* The arena is statically sized for the deepest console flow */
+    CY_ASSERT(end <= APP_ARENA_SIZE);
+
+    if (end <= APP_ARENA_SIZE)
+    {
+        block = &arena[arena_offset];
+        arena_offset = end;
+
+        if (end > arena_high_water)
+        {
+            arena_high_water = end;
+        }
+
+        memset(block, 0, size);
+    }
+
+    return block;
+}
+
+/*******************************************************************************
+* Function Name: app_arena_mark
+********************************************************************************
+* Summary:
+*  Returns the current allocation offset, to be passed to app_arena_release()
+*  at the end of the scope.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  app_arena_mark_t : Current allocation offset
+*
+*******************************************************************************/
+app_arena_mark_t app_arena_mark(void)
+{
+    return arena_offset;
+}
+
+/*******************************************************************************
+* Function Name: app_arena_release
+********************************************************************************
+* Summary:
+*  Frees every block allocated since the mark was taken.
+*
+* Parameters:
+*  app_arena_mark_t mark : Offset returned by app_arena_mark()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void app_arena_release(app_arena_mark_t mark)
+{
+    CY_ASSERT(mark <= arena_offset);
+    arena_offset = mark;
+}
+
+/*******************************************************************************
+* Function Name: app_arena_high_water
+********************************************************************************
+* Summary:
+*  Returns the highest number of bytes in use at the same time since reset.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : High-water mark in bytes
+*
+*******************************************************************************/
+uint32_t app_arena_high_water(void)
+{
+    return arena_high_water;
+}
+
+/* [] END OF FILE */
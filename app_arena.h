@@ -0,0 +1,87 @@
+/******************************************************************************
+* File Name:   app_arena.h
+*
+* Description: This file contains the declarations of the static scratch arena
+*              shared by the console line buffers, the parsers and the formatted
+*              output.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_ARENA_H
+#define APP_ARENA_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Arena size in bytes. Sized for the deepest console flow, the event counter
+ * display: 31 day totals (124 bytes) plus one 80-byte output line. */
+#define APP_ARENA_SIZE          (208u)
+
+/* Alignment of every allocation in bytes */
+#define APP_ARENA_ALIGNMENT     (4u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Allocation offset saved on entry to a scope and restored on exit */
+typedef uint32_t app_arena_mark_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void *app_arena_alloc(uint32_t size);
+app_arena_mark_t app_arena_mark(void);
+void app_arena_release(app_arena_mark_t mark);
+uint32_t app_arena_high_water(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* APP_ARENA_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name:   app_config.h
+*
+* Description: This file contains the compile-time feature selection of the
+*              application. Each option defaults to enabled, or to the options it
+*              depends on, and can be overridden from the Makefile, for example
+*              DEFINES+=APP_CONFIG_DST_UI=0. The code of a disabled feature is not
+*              compiled, and the library code it used is left out by the linker.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Interactive console menus. When disabled, the console only passes the
+ * NMEA sentences to the GPS time source and answers the statistics
+ * commands f and g. */
+#if !defined(APP_CONFIG_MENUS)
+#define APP_CONFIG_MENUS         (1)
+#endif
+
+/* Interactive DST configuration (command 2), enabled with the menus. The
+ * DST rules kept across a warm reset are still restored when disabled. */
+#if !defined(APP_CONFIG_DST_UI)
+#define APP_CONFIG_DST_UI        (APP_CONFIG_MENUS)
+#endif
+
+/* Text formatting of the time: the status line printed every second and
+ * the recovery message. */
+#if !defined(APP_CONFIG_TEXT_FORMAT)
+#define APP_CONFIG_TEXT_FORMAT   (1)
+#endif
+
+/* Formatted input and output of the C library (snprintf, sscanf), enabled
+ * when a feature that uses it is enabled. */
+#if !defined(APP_CONFIG_STDIO)
+#define APP_CONFIG_STDIO         ((APP_CONFIG_MENUS) || (APP_CONFIG_TEXT_FORMAT))
+#endif
+
+/* Hot paths executed from SRAM instead of flash: the RTC and UART
+ * interrupt handlers, the work posting, the sampler trigger and the time
+ * formatting. SRAM has no wait states and does not compete with the flash
+ * cache. */
+#if !defined(APP_CONFIG_RAM_CODE)
+#define APP_CONFIG_RAM_CODE      (1)
+#endif
+
+/* Place a function between these macros to run it from SRAM when
+ * APP_CONFIG_RAM_CODE is enabled. The code is copied from flash with the
+ * initialized data by the startup code. */
+#if APP_CONFIG_RAM_CODE
+#define APP_RAMFUNC_BEGIN        CY_RAMFUNC_BEGIN
+#define APP_RAMFUNC_END          CY_RAMFUNC_END
+#else
+#define APP_RAMFUNC_BEGIN
+#define APP_RAMFUNC_END
+#endif
+
+/* Execution trace: the interrupt handlers, the work items, the sleeps of
+ * the main loop, the waits for UART TX queue space and the commands are
+ * recorded in a RAM ring, dumped by a console command. */
+#if !defined(APP_CONFIG_TRACE)
+#define APP_CONFIG_TRACE         (1)
+#endif
+
+#if (APP_CONFIG_DST_UI) && !(APP_CONFIG_MENUS)
+#error "APP_CONFIG_DST_UI requires APP_CONFIG_MENUS"
+#endif
+
+#if !(APP_CONFIG_STDIO) && ((APP_CONFIG_MENUS) || (APP_CONFIG_TEXT_FORMAT))
+#error "APP_CONFIG_MENUS and APP_CONFIG_TEXT_FORMAT require APP_CONFIG_STDIO"
+#endif
+
+#endif /* APP_CONFIG_H */
+
+/* [] END OF FILE */
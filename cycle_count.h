@@ -0,0 +1,144 @@
+/******************************************************************************
+* File Name:   cycle_count.h
+*
+* Description: This file contains inline helpers to read the DWT cycle counter,
+*              used to time code paths in CPU cycles.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCLE_COUNT_H
+#define CYCLE_COUNT_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Distribution of the cost of a code path, updated on every run */
+typedef struct
+{
+    uint32_t count;              /* Number of runs */
+    uint32_t last_start;         /* Cycle count at the start of the last run */
+    uint32_t last;               /* Cycles of the last run */
+    uint32_t max;                /* Highest cycles of a run */
+    uint64_t total;              /* Sum of the cycles of all runs */
+} cycle_stats_t;
+
+/*******************************************************************************
+* Function Name: cycle_count_init
+********************************************************************************
+* Summary:
+*  Enables the free-running DWT cycle counter. The counter is not cleared, so
+*  the function can be called again without disturbing running measurements.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void cycle_count_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*******************************************************************************
+* Function Name: cycle_count_get
+********************************************************************************
+* Summary:
+*  Returns the current value of the cycle counter. The counter wraps around,
+*  so only differences between two readings (computed with unsigned
+*  arithmetic) are meaningful.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : CPU cycles
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t cycle_count_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: cycle_stats_add
+********************************************************************************
+* Summary:
+*  Adds a run that started at 'start' and ends now to a distribution. Not
+*  reentrant: a distribution must be updated from a single context,
+*  typically one interrupt handler.
+*
+* Parameters:
+*  cycle_stats_t *stats : Distribution to update
+*  uint32_t start       : Cycle count at the start of the run
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void cycle_stats_add(cycle_stats_t *stats, uint32_t start)
+{
+    uint32_t cycles = cycle_count_get() - start;
+
+    stats->count++;
+    stats->last_start = start;
+    stats->last = cycles;
+    stats->total += cycles;
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CYCLE_COUNT_H */
+
+/* [] END OF FILE */
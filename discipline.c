@@ -0,0 +1,861 @@
+/******************************************************************************
+* File Name:   discipline.c
+*
+* Description: This file contains the clock discipline loop. The served time is the
+*              RTC time plus a correction with nanosecond resolution. Every RTC second,
+*              the correction advances by the frequency correction and by a slice of the
+*              remaining phase offset, limited to DISCIPLINE_MAX_SLEW_PPB, so the served
+*              time never jumps. The offsets measured against the reference drive a
+*              phase-locked loop, with a frequency-locked term for long update intervals.
+*              Whole seconds of correction are moved into the RTC, which keeps the RTC
+*              within half a second of the served time without affecting it. Between
+*              RTC seconds, the served time is interpolated with the cycle counter.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "discipline.h"
+#include "timekeeping.h"
+#include "rtc_tick.h"
+#include "event_log.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            (1000000000)
+#define NS_PER_HALF_SECOND       (NS_PER_SECOND / 2)
+#define NS_PER_MS                (1000000)
+
+/* The drift in the quality word is in units of 0.1 ppm */
+#define PPB_PER_DPPM             (100)
+
+/* Weight of a new sample in the jitter average is 1 / JITTER_FILTER */
+#define JITTER_FILTER            (8)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static discipline_stats_t discipline_stats;
+
+/* RTC time and cycle count at the last RTC second. When the CPU clock
+ * changes, tick_cycles moves to the change and the time before it is kept
+ * in tick_offset_ns. */
+static uint32_t tick_rtc_epoch = 0u;
+static uint32_t tick_cycles = 0u;
+static uint32_t tick_offset_ns = 0u;
+
+/* The RTC has no sub-second counter: the position in the second is only
+ * known from the first RTC second after boot */
+static bool have_tick = false;
+
+/* Served time minus RTC time at the last RTC second. Its whole seconds are
+ * moved into the RTC on the next tick once it reaches half a second */
+static int64_t correction_ns = 0;
+
+/* Served second at the last RTC second, as served at the interrupt. The
+ * correction is moved back to the interrupt at the new rate and can fall a
+ * few ns short of the second served then. */
+static uint32_t tick_served_epoch = 0u;
+
+/* RTC tick count at the last RTC second, for the monotonic clock */
+static uint32_t tick_count = 0u;
+
+/* Parts of the rate of the current second taken from the phase and from the
+ * operator adjustment */
+static int32_t rate_slew_ppb = 0;
+static int32_t rate_adjust_ppb = 0;
+
+/* Operator adjustment still to be slewed, in ns */
+static int64_t adjtime_remaining_ns = 0;
+
+/* Time of the first and of the last update */
+static uint32_t first_update_epoch = 0u;
+static uint32_t last_update_epoch = 0u;
+static bool have_update = false;
+static uint32_t lock_count = 0u;
+
+/*******************************************************************************
+* Function Name: clamp
+********************************************************************************
+* Summary:
+*  Limits a value to a symmetric range.
+*
+* Parameters:
+*  int32_t value : Value to limit
+*  int32_t limit : Largest magnitude allowed
+*
+* Return:
+*  int32_t : Limited value
+*
+*******************************************************************************/
+static int32_t clamp(int32_t value, int32_t limit)
+{
+    if (value > limit)
+    {
+        value = limit;
+    }
+    else if (value < -limit)
+    {
+        value = -limit;
+    }
+    else
+    {
+        /* Within range */
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: clamp64
+********************************************************************************
+* Summary:
+*  Limits a 64-bit value to a symmetric 32-bit range.
+*
+* Parameters:
+*  int64_t value : Value to limit
+*  int32_t limit : Largest magnitude allowed
+*
+* Return:
+*  int64_t : Limited value
+*
+*******************************************************************************/
+static int64_t clamp64(int64_t value, int32_t limit)
+{
+    if (value > limit)
+    {
+        value = limit;
+    }
+    else if (value < -limit)
+    {
+        value = -limit;
+    }
+    else
+    {
+        /* Within range */
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: take_slice
+********************************************************************************
+* Summary:
+*  Takes a slice from an amount still to be slewed. The slice is limited to
+*  the amount and is dropped if the amount changed its direction.
+*
+* Parameters:
+*  int64_t *remaining : Amount still to be slewed, reduced by the slice
+*  int64_t slice      : Slice requested
+*
+* Return:
+*  int64_t : Slice taken
+*
+*******************************************************************************/
+static int64_t take_slice(int64_t *remaining, int64_t slice)
+{
+    if ((slice > 0) && (*remaining > 0))
+    {
+        if (slice > *remaining)
+        {
+            slice = *remaining;
+        }
+    }
+    else if ((slice < 0) && (*remaining < 0))
+    {
+        if (slice < *remaining)
+        {
+            slice = *remaining;
+        }
+    }
+    else
+    {
+        slice = 0;
+    }
+
+    *remaining -= slice;
+    return slice;
+}
+
+/*******************************************************************************
+* Function Name: split_served
+********************************************************************************
+* Summary:
+*  Converts the RTC time and a correction into seconds and nanoseconds.
+*
+* Parameters:
+*  int64_t offset_ns : Correction plus interpolation, in ns
+*  uint32_t *sec     : Seconds of the served time
+*  uint32_t *ns      : Nanoseconds of the served time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void split_served(int64_t offset_ns, uint32_t *sec, uint32_t *ns)
+{
+    int64_t whole = offset_ns / NS_PER_SECOND;
+    int64_t frac = offset_ns % NS_PER_SECOND;
+
+    if (frac < 0)
+    {
+        frac += NS_PER_SECOND;
+        whole--;
+    }
+
+    *sec = tick_rtc_epoch + (uint32_t)(int32_t)whole;
+    *ns = (uint32_t)frac;
+}
+
+/*******************************************************************************
+* Function Name: elapsed_since_tick
+********************************************************************************
+* Summary:
+*  Returns the time since the last RTC second processed by
+*  discipline_on_tick(). The ticks counted since then, while the tick work
+*  item waited behind a long command, are whole seconds; the time since the
+*  last RTC interrupt is measured with the cycle counter and limited to one
+*  second. Must be called with interrupts disabled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time since the last processed RTC second, in ns
+*
+*******************************************************************************/
+static int64_t elapsed_since_tick(void)
+{
+    uint32_t pending = rtc_tick_count() - tick_count;
+    cycle_stats_t isr;
+    uint64_t elapsed;
+
+    if (0u == pending)
+    {
+        elapsed = tick_offset_ns +
+                  (((uint64_t)(cycle_count_get() - tick_cycles) * NS_PER_SECOND) /
+                   SystemCoreClock);
+    }
+    else
+    {
+        /* The CPU clock changes in the work items, after the pending tick
+         * item, so it has not changed since the interrupt */
+        rtc_tick_get_isr_cycles(&isr);
+        elapsed = ((uint64_t)(cycle_count_get() - isr.last_start) * NS_PER_SECOND) /
+                  SystemCoreClock;
+    }
+
+    if (elapsed >= NS_PER_SECOND)
+    {
+        elapsed = NS_PER_SECOND - 1;
+    }
+
+    return ((int64_t)pending * NS_PER_SECOND) + (int64_t)elapsed;
+}
+
+/*******************************************************************************
+* Function Name: rate_part
+********************************************************************************
+* Summary:
+*  Returns what a rate adds over a time.
+*
+* Parameters:
+*  int64_t elapsed  : Time in ns
+*  int32_t rate_ppb : Rate in ppb
+*
+* Return:
+*  int64_t : Amount added, in ns
+*
+*******************************************************************************/
+static int64_t rate_part(int64_t elapsed, int32_t rate_ppb)
+{
+    return (elapsed * rate_ppb) / NS_PER_SECOND;
+}
+
+/*******************************************************************************
+* Function Name: slewed
+********************************************************************************
+* Summary:
+*  Returns the correction added over a time since the last processed RTC
+*  second at the rate set for it: the frequency over the whole time, the
+*  slices of the phase and of the operator adjustment over the first second,
+*  and, past it, further slices taken from what remains of them.
+*
+* Parameters:
+*  int64_t elapsed : Time since the last processed RTC second, in ns
+*  int64_t *phase  : Phase still to be slewed, reduced by the slices taken
+*  int64_t *adjust : Adjustment still to be slewed, reduced by the slices
+*                    taken
+*
+* Return:
+*  int64_t : Correction added, in ns
+*
+*******************************************************************************/
+static int64_t slewed(int64_t elapsed, int64_t *phase, int64_t *adjust)
+{
+    int32_t freq = discipline_stats.rate_ppb - rate_slew_ppb - rate_adjust_ppb;
+    int64_t first = (elapsed < NS_PER_SECOND) ? elapsed : NS_PER_SECOND;
+
+    return rate_part(elapsed, freq) + rate_part(first, rate_slew_ppb) +
+           rate_part(first, rate_adjust_ppb) +
+           take_slice(phase, rate_part(elapsed - first, rate_slew_ppb)) +
+           take_slice(adjust, rate_part(elapsed - first, rate_adjust_ppb));
+}
+
+/*******************************************************************************
+* Function Name: discipline_init
+********************************************************************************
+* Summary:
+*  Starts the served time on the RTC time, without correction.
+*
+* Parameters:
+*  uint32_t rtc_epoch : RTC time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_init(uint32_t rtc_epoch)
+{
+    memset(&discipline_stats, 0, sizeof(discipline_stats));
+    tick_rtc_epoch = rtc_epoch;
+    tick_served_epoch = rtc_epoch;
+    tick_cycles = cycle_count_get();
+    tick_offset_ns = 0u;
+    tick_count = rtc_tick_count();
+    have_tick = false;
+    correction_ns = 0;
+    rate_slew_ppb = 0;
+    rate_adjust_ppb = 0;
+    adjtime_remaining_ns = 0;
+    have_update = false;
+    lock_count = 0u;
+}
+
+/*******************************************************************************
+* Function Name: discipline_clock_changed
+********************************************************************************
+* Summary:
+*  Carries the time since the last RTC second over a change of the CPU
+*  clock, which also changes the rate of the cycle counter. Must be called
+*  with interrupts disabled, after SystemCoreClock has been updated.
+*
+* Parameters:
+*  uint32_t old_hz : CPU clock before the change
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_clock_changed(uint32_t old_hz)
+{
+    uint32_t now = cycle_count_get();
+    uint64_t elapsed = tick_offset_ns +
+                       (((uint64_t)(now - tick_cycles) * NS_PER_SECOND) / old_hz);
+
+    if (elapsed >= NS_PER_SECOND)
+    {
+        elapsed = NS_PER_SECOND - 1;
+    }
+
+    tick_offset_ns = (uint32_t)elapsed;
+    tick_cycles = now;
+}
+
+/*******************************************************************************
+* Function Name: discipline_on_tick
+********************************************************************************
+* Summary:
+*  Advances the served time on an RTC second: adds the rate of the seconds
+*  since the last call to the correction, then sets the rate of the next
+*  second from the frequency correction, a slice of the remaining phase and
+*  a slice of the operator adjustment, limited to DISCIPLINE_MAX_RATE_PPB.
+*  When the correction reaches half a second, its nearest whole seconds are
+*  moved into the RTC. The RTC is written here, right after its interrupt,
+*  so that the write ends before the next second.
+*
+*  Merged tick work items leave more than one second since the last call.
+*  The rate held over all of them, except that the phase and the adjustment
+*  are only applied up to what remained of them. The new rate applies from
+*  this call, not from the RTC second: the time since the interrupt is
+*  counted at the previous rate, as discipline_now() served it, so that the
+*  served time does not jump when the rate changes.
+*
+* Parameters:
+*  uint32_t rtc_epoch : RTC time in seconds since the epoch
+*
+* Return:
+*  uint32_t : Served time in whole seconds since the epoch
+*
+*******************************************************************************/
+uint32_t discipline_on_tick(uint32_t rtc_epoch)
+{
+    int64_t phase = discipline_stats.phase_remaining_ns;
+    int32_t freq;
+    int32_t slew;
+    int32_t adjust;
+    int64_t applied;
+    int64_t since;
+    int64_t edge;
+    int64_t edge_phase;
+    int64_t edge_adjust;
+    int64_t seconds;
+    cycle_stats_t isr;
+    uint32_t elapsed;
+    uint32_t interruptState;
+    uint32_t sec;
+    uint32_t ns;
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    elapsed = rtc_tick_count() - tick_count;
+    if (0u == elapsed)
+    {
+        /* The tick was already processed by the previous call */
+        Cy_SysLib_ExitCriticalSection(interruptState);
+        return tick_served_epoch;
+    }
+
+    /* Up to now at the previous rate; the slices of its first second were
+     * taken when it was set */
+    since = elapsed_since_tick();
+    edge_phase = phase;
+    edge_adjust = adjtime_remaining_ns;
+    edge = correction_ns + slewed((int64_t)elapsed * NS_PER_SECOND, &edge_phase, &edge_adjust);
+    applied = slewed(since, &phase, &adjtime_remaining_ns);
+    since -= (int64_t)elapsed * NS_PER_SECOND;
+
+    /* Rate of the next second: the frequency first, then the phase, then
+     * the operator adjustment within what is left of the maximum rate */
+    freq = clamp(discipline_stats.freq_ppb, DISCIPLINE_MAX_RATE_PPB);
+    slew = (int32_t)(phase / DISCIPLINE_TIME_CONSTANT_S);
+    if (0 == slew)
+    {
+        /* Finish the last nanoseconds instead of approaching them forever */
+        slew = (int32_t)phase;
+    }
+    slew = clamp(slew, DISCIPLINE_MAX_SLEW_PPB);
+    slew = clamp(freq + slew, DISCIPLINE_MAX_RATE_PPB) - freq;
+    adjust = (int32_t)clamp64(adjtime_remaining_ns, DISCIPLINE_ADJTIME_RATE_PPB);
+    adjust = clamp(freq + slew + adjust, DISCIPLINE_MAX_RATE_PPB) - (freq + slew);
+
+    /* The slices of the new rate are taken for a whole second from the RTC
+     * interrupt, less the time since it, which was counted above */
+    correction_ns += applied - rate_part(since, freq) - rate_part(since, slew) -
+                     rate_part(since, adjust);
+    discipline_stats.phase_remaining_ns = (int32_t)(phase - slew + rate_part(since, slew));
+    adjtime_remaining_ns -= adjust - rate_part(since, adjust);
+    rate_slew_ppb = slew;
+    rate_adjust_ppb = adjust;
+    discipline_stats.rate_ppb = freq + slew + adjust;
+
+    /* The second started at the interrupt, not when this work item runs,
+     * which can be most of a second later after merged ticks */
+    rtc_tick_get_isr_cycles(&isr);
+    tick_rtc_epoch = rtc_epoch;
+    tick_cycles = isr.last_start;
+    tick_offset_ns = 0u;
+    tick_count += elapsed;
+    have_tick = true;
+    split_served(edge, &sec, &ns);
+    tick_served_epoch = sec;
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    /* A refused write is tried again on the next tick */
+    seconds = (correction_ns + ((correction_ns < 0) ? -NS_PER_HALF_SECOND : NS_PER_HALF_SECOND)) /
+              NS_PER_SECOND;
+    if ((0 != seconds) && (CY_RTC_SUCCESS == timekeeping_step((int32_t)seconds)))
+    {
+        correction_ns -= seconds * NS_PER_SECOND;
+        tick_rtc_epoch += (uint32_t)(int32_t)seconds;
+    }
+
+    return sec;
+}
+
+/*******************************************************************************
+* Function Name: discipline_now
+********************************************************************************
+* Summary:
+*  Returns the served time with the time since the last RTC second
+*  interpolated from the cycle counter at the rate of the current second,
+*  so the slew is spread over the second instead of applied at the tick.
+*  The interpolation is limited to one second past the last RTC tick.
+*
+* Parameters:
+*  uint32_t *sec : Seconds since the epoch
+*  uint32_t *ns  : Nanoseconds within the second
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_now(uint32_t *sec, uint32_t *ns)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    int64_t elapsed = elapsed_since_tick();
+    int64_t phase = discipline_stats.phase_remaining_ns;
+    int64_t adjust = adjtime_remaining_ns;
+
+    /* The same amount as the next discipline_on_tick() will add */
+    split_served(correction_ns + elapsed + slewed(elapsed, &phase, &adjust), sec, ns);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: discipline_update
+********************************************************************************
+* Summary:
+*  Processes an offset measured against the reference. The offset replaces
+*  the phase still to be slewed, and the frequency correction is updated by
+*  the phase-locked term and, for long intervals, the frequency-locked term.
+*  Offsets at or above DISCIPLINE_STEP_THRESHOLD_MS must be passed to
+*  discipline_step() instead.
+*
+* Parameters:
+*  int32_t offset_ns : Reference minus served time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_update(int32_t offset_ns)
+{
+    uint32_t interval = tick_rtc_epoch - last_update_epoch;
+    int32_t change = offset_ns - discipline_stats.last_offset_ns;
+    int32_t magnitude = (offset_ns < 0) ? -offset_ns : offset_ns;
+    int32_t freq = discipline_stats.freq_ppb;
+
+    discipline_stats.updates++;
+    discipline_stats.phase_remaining_ns = offset_ns;
+
+    if (have_update && (0u != interval))
+    {
+        if (change < 0)
+        {
+            change = -change;
+        }
+        discipline_stats.jitter_ns += (uint32_t)((change - (int32_t)discipline_stats.jitter_ns) /
+                                                 JITTER_FILTER);
+
+        freq += (int32_t)(((int64_t)offset_ns * interval) /
+                          (4 * DISCIPLINE_TIME_CONSTANT_S * DISCIPLINE_TIME_CONSTANT_S));
+        if (interval >= DISCIPLINE_FLL_MIN_INTERVAL_S)
+        {
+            freq += offset_ns / ((int32_t)interval * DISCIPLINE_FLL_GAIN);
+        }
+        discipline_stats.freq_ppb = clamp(freq, DISCIPLINE_MAX_FREQ_PPB);
+    }
+    else
+    {
+        first_update_epoch = tick_rtc_epoch;
+        have_update = true;
+    }
+
+    last_update_epoch = tick_rtc_epoch;
+    discipline_stats.last_offset_ns = offset_ns;
+
+    if (magnitude < DISCIPLINE_LOCK_NS)
+    {
+        lock_count++;
+        if ((lock_count >= DISCIPLINE_LOCK_COUNT) && !discipline_stats.locked)
+        {
+            discipline_stats.locked = true;
+            discipline_stats.ever_locked = true;
+            discipline_stats.lock_time_s = tick_rtc_epoch - first_update_epoch;
+        }
+    }
+    else
+    {
+        lock_count = 0u;
+        discipline_stats.locked = false;
+    }
+
+    /* A positive correction means that the RTC runs slow */
+    timekeeping_set_drift(-discipline_stats.freq_ppb / PPB_PER_DPPM);
+}
+
+/*******************************************************************************
+* Function Name: discipline_step
+********************************************************************************
+* Summary:
+*  Corrects a large offset: the nearest whole seconds are added to the
+*  correction, so the served time steps at once, and the rest, at most half
+*  a second, is left to the slew. The seconds are written to the RTC on the
+*  next tick; a fix can arrive late in the RTC second, when the write could
+*  be crossed by the end of the second. The loop restarts its measurements
+*  but keeps the frequency correction.
+*
+* Parameters:
+*  int64_t offset_ns : Reference minus served time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_step(int64_t offset_ns)
+{
+    int64_t rounded = offset_ns + ((offset_ns < 0) ? -NS_PER_HALF_SECOND : NS_PER_HALF_SECOND);
+    int32_t seconds = (int32_t)(rounded / NS_PER_SECOND);
+
+    correction_ns += (int64_t)seconds * NS_PER_SECOND;
+    tick_served_epoch += (uint32_t)seconds;
+    discipline_stats.phase_remaining_ns = (int32_t)(offset_ns - ((int64_t)seconds * NS_PER_SECOND));
+    discipline_stats.steps++;
+    event_log_add(EVENT_LOG_TIME_STEP, seconds);
+    discipline_stats.locked = false;
+    have_update = false;
+    lock_count = 0u;
+}
+
+/*******************************************************************************
+* Function Name: discipline_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the loop statistics.
+*
+* Parameters:
+*  discipline_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_get_stats(discipline_stats_t *stats)
+{
+    *stats = discipline_stats;
+}
+
+/*******************************************************************************
+* Function Name: discipline_adjtime
+********************************************************************************
+* Summary:
+*  Requests a gradual change of the served time, in the manner of adjtime():
+*  the adjustment replaces any adjustment still pending and is slewed at
+*  DISCIPLINE_ADJTIME_RATE_PPB on top of the loop, without a step. The RTC
+*  follows through the second folding, and the monotonic clock is not
+*  affected. While fixes are received, the loop measures the adjustment as
+*  an offset from the reference and slews it back.
+*
+* Parameters:
+*  int64_t delta_ns          : Change of the served time, positive to advance
+*  int64_t *old_remaining_ns : Receives the part of the previous adjustment
+*                              that was not applied, can be NULL
+*
+* Return:
+*  bool : false if the adjustment exceeds DISCIPLINE_ADJTIME_MAX_MS
+*
+*******************************************************************************/
+bool discipline_adjtime(int64_t delta_ns, int64_t *old_remaining_ns)
+{
+    const int64_t max_ns = (int64_t)DISCIPLINE_ADJTIME_MAX_MS * NS_PER_MS;
+    uint32_t interruptState;
+
+    if ((delta_ns > max_ns) || (delta_ns < -max_ns))
+    {
+        return false;
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    if (NULL != old_remaining_ns)
+    {
+        *old_remaining_ns = adjtime_remaining_ns;
+    }
+    adjtime_remaining_ns = delta_ns;
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: discipline_adjtime_remaining
+********************************************************************************
+* Summary:
+*  Returns the part of the operator adjustment that has not been slewed yet.
+*  The slice of the current second is counted as applied.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Remaining adjustment, in ns
+*
+*******************************************************************************/
+int64_t discipline_adjtime_remaining(void)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    int64_t remaining = adjtime_remaining_ns;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+    return remaining;
+}
+
+/*******************************************************************************
+* Function Name: discipline_adjtime_cancel
+********************************************************************************
+* Summary:
+*  Stops the operator adjustment. The slice of the current second is
+*  completed, the rest is dropped and the served time keeps the part
+*  already applied.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Part of the adjustment that was not applied, in ns
+*
+*******************************************************************************/
+int64_t discipline_adjtime_cancel(void)
+{
+    int64_t remaining = 0;
+
+    (void)discipline_adjtime(0, &remaining);
+    return remaining;
+}
+
+/*******************************************************************************
+* Function Name: discipline_monotonic
+********************************************************************************
+* Summary:
+*  Returns the time since boot counted in RTC ticks, with the time since the
+*  last tick interpolated from the cycle counter. It is not affected by
+*  steps, by the slew of the loop or by operator adjustments.
+*
+* Parameters:
+*  uint32_t *sec : Seconds since boot
+*  uint32_t *ns  : Nanoseconds within the second
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_monotonic(uint32_t *sec, uint32_t *ns)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    int64_t elapsed = elapsed_since_tick();
+
+    *sec = tick_count + (uint32_t)(elapsed / NS_PER_SECOND);
+    *ns = (uint32_t)(elapsed % NS_PER_SECOND);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: discipline_ready
+********************************************************************************
+* Summary:
+*  Tells whether the served time is interpolated from an RTC second. Before
+*  the first RTC second after boot, the time within the second is unknown
+*  and a measured offset would be wrong by up to one second.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true once an RTC second has been processed
+*
+*******************************************************************************/
+bool discipline_ready(void)
+{
+    return have_tick;
+}
+
+/*******************************************************************************
+* Function Name: discipline_capture
+********************************************************************************
+* Summary:
+*  Returns the state to keep across a warm reset: the correction of the RTC,
+*  the operator adjustment still to be slewed, the frequency learned and the
+*  lock state.
+*
+* Parameters:
+*  discipline_retained_t *state : Destination of the state
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_capture(discipline_retained_t *state)
+{
+    state->correction_ns = correction_ns;
+    state->adjtime_remaining_ns = adjtime_remaining_ns;
+    state->freq_ppb = discipline_stats.freq_ppb;
+    state->locked = discipline_stats.locked;
+    state->ever_locked = discipline_stats.ever_locked;
+}
+
+/*******************************************************************************
+* Function Name: discipline_restore
+********************************************************************************
+* Summary:
+*  Restores the state captured before a warm reset, after discipline_init().
+*  The served time continues from the running RTC with the same correction,
+*  and the loop keeps its frequency and its lock, so a holdover continues
+*  with the learned drift and the same error bound. The measurements of the
+*  loop restart with the next fix.
+*
+* Parameters:
+*  const discipline_retained_t *state : State to restore
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void discipline_restore(const discipline_retained_t *state)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    uint32_t ns;
+
+    correction_ns = state->correction_ns;
+    adjtime_remaining_ns = state->adjtime_remaining_ns;
+    discipline_stats.freq_ppb = clamp(state->freq_ppb, DISCIPLINE_MAX_FREQ_PPB);
+    discipline_stats.rate_ppb = discipline_stats.freq_ppb;
+    discipline_stats.locked = state->locked;
+    discipline_stats.ever_locked = state->ever_locked;
+    lock_count = state->locked ? DISCIPLINE_LOCK_COUNT : 0u;
+    split_served(correction_ns, &tick_served_epoch, &ns);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    timekeeping_set_drift(-discipline_stats.freq_ppb / PPB_PER_DPPM);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,145 @@
+/******************************************************************************
+* File Name:   discipline.h
+*
+* Description: This file contains the declarations of the clock discipline loop that
+*              steers the served time towards a reference by slewing.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DISCIPLINE_H
+#define DISCIPLINE_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Offsets at or above this are stepped instead of slewed. The offsets are
+ * measured at the start of the GPS sentence, so its transmission and its
+ * wait in the RX queue do not bias them; the delay of the receiver before
+ * the sentence, tens to hundreds of ms, remains in them unless
+ * GPS_TIME_SENTENCE_DELAY_US is set */
+#define DISCIPLINE_STEP_THRESHOLD_MS     (1000u)
+
+/* Highest rate at which the phase is slewed, in ns per second (ppb) */
+#define DISCIPLINE_MAX_SLEW_PPB          (500000)
+
+/* Highest frequency correction, in ppb */
+#define DISCIPLINE_MAX_FREQ_PPB          (500000)
+
+/* Highest rate of the served time against the RTC, in ppb: the frequency
+ * correction, the phase slew and the operator adjustment together */
+#define DISCIPLINE_MAX_RATE_PPB          (500000)
+
+/* Time constant of the loop, in seconds: the phase is slewed by 1/TC of the
+ * remaining offset every second and the frequency gain is 1/(4*TC^2) */
+#define DISCIPLINE_TIME_CONSTANT_S       (16)
+
+/* Update interval from which the frequency-locked term is added, and its
+ * gain divider */
+#define DISCIPLINE_FLL_MIN_INTERVAL_S    (64u)
+#define DISCIPLINE_FLL_GAIN              (4)
+
+/* The loop is locked after this many updates in a row within the offset */
+#define DISCIPLINE_LOCK_NS               (1000000)
+#define DISCIPLINE_LOCK_COUNT            (8u)
+
+/* Rate at which an adjustment requested with discipline_adjtime() is
+ * slewed, in ns per second (ppb), and the largest adjustment accepted */
+#define DISCIPLINE_ADJTIME_RATE_PPB      (500000)
+#define DISCIPLINE_ADJTIME_MAX_MS        (60000)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t updates;            /* Offsets processed by the loop */
+    uint32_t steps;              /* Offsets corrected by a step */
+    int32_t last_offset_ns;      /* Reference minus served time at the last update */
+    uint32_t jitter_ns;          /* Average change of the offset between updates */
+    int32_t freq_ppb;            /* Frequency correction applied to the RTC */
+    int32_t phase_remaining_ns;  /* Phase still to be slewed */
+    uint32_t lock_time_s;        /* Time from the first update to the lock */
+    int32_t rate_ppb;            /* Rate of the served time against the RTC */
+    bool locked;
+    bool ever_locked;
+} discipline_stats_t;
+
+/* State kept across a warm reset; the RTC keeps running, so the correction
+ * still applies to it after the reset */
+typedef struct
+{
+    int64_t correction_ns;       /* Served time minus RTC time */
+    int64_t adjtime_remaining_ns;
+    int32_t freq_ppb;
+    bool locked;
+    bool ever_locked;
+} discipline_retained_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void discipline_init(uint32_t rtc_epoch);
+uint32_t discipline_on_tick(uint32_t rtc_epoch);
+void discipline_clock_changed(uint32_t old_hz);
+void discipline_now(uint32_t *sec, uint32_t *ns);
+void discipline_update(int32_t offset_ns);
+void discipline_step(int64_t offset_ns);
+void discipline_get_stats(discipline_stats_t *stats);
+bool discipline_adjtime(int64_t delta_ns, int64_t *old_remaining_ns);
+int64_t discipline_adjtime_remaining(void);
+int64_t discipline_adjtime_cancel(void);
+void discipline_monotonic(uint32_t *sec, uint32_t *ns);
+bool discipline_ready(void);
+void discipline_capture(discipline_retained_t *state);
+void discipline_restore(const discipline_retained_t *state);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DISCIPLINE_H */
+
+/* [] END OF FILE */
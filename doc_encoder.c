@@ -0,0 +1,570 @@
+/******************************************************************************
+* File Name:   doc_encoder.c
+*
+* Description: This file contains the streaming document encoder. The values are
+*              encoded as JSON or CBOR and written to the sink as they are added, so
+*              the document is never built in RAM. The CBOR maps have an indefinite
+*              length, so the number of members does not need to be known in advance.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "doc_encoder.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* CBOR major types, shifted into the initial byte */
+#define CBOR_UNSIGNED            (0x00u)
+#define CBOR_NEGATIVE            (0x20u)
+#define CBOR_TEXT                (0x60u)
+#define CBOR_TAG                 (0xC0u)
+
+/* CBOR additional information */
+#define CBOR_DIRECT_MAX          (23u)
+#define CBOR_UINT8               (24u)
+#define CBOR_UINT16              (25u)
+#define CBOR_UINT32              (26u)
+
+#define CBOR_MAP_INDEFINITE      (0xBFu)
+#define CBOR_FALSE               (0xF4u)
+#define CBOR_TRUE                (0xF5u)
+#define CBOR_BREAK               (0xFFu)
+
+/* Self-describe tag: marks the start of a CBOR document in a byte stream */
+#define CBOR_SELF_DESCRIBE_TAG   (55799u)
+
+/* Digits of the largest 32-bit number, and a sign */
+#define DECIMAL_MAX_LENGTH       (11u)
+
+/*******************************************************************************
+* Function Name: emit
+********************************************************************************
+* Summary:
+*  Sends bytes to the sink and counts them.
+*
+* Parameters:
+*  doc_encoder_t *enc   : Encoder
+*  const uint8_t *data  : Bytes
+*  uint32_t size        : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void emit(doc_encoder_t *enc, const uint8_t *data, uint32_t size)
+{
+    enc->sink(data, size);
+    enc->size += size;
+}
+
+/*******************************************************************************
+* Function Name: emit_byte
+********************************************************************************
+* Summary:
+*  Sends one byte to the sink.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  uint8_t value      : Byte
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void emit_byte(doc_encoder_t *enc, uint8_t value)
+{
+    emit(enc, &value, 1u);
+}
+
+/*******************************************************************************
+* Function Name: cbor_head
+********************************************************************************
+* Summary:
+*  Sends the initial byte of a CBOR data item and its argument in the
+*  shortest form.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  uint8_t major      : Major type, shifted
+*  uint32_t value     : Argument
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void cbor_head(doc_encoder_t *enc, uint8_t major, uint32_t value)
+{
+    uint8_t head[5];
+    uint32_t size;
+
+    if (value <= CBOR_DIRECT_MAX)
+    {
+        head[0] = (uint8_t)(major | value);
+        size = 1u;
+    }
+    else if (value <= UINT8_MAX)
+    {
+        head[0] = (uint8_t)(major | CBOR_UINT8);
+        head[1] = (uint8_t)value;
+        size = 2u;
+    }
+    else if (value <= UINT16_MAX)
+    {
+        head[0] = (uint8_t)(major | CBOR_UINT16);
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        size = 3u;
+    }
+    else
+    {
+        head[0] = (uint8_t)(major | CBOR_UINT32);
+        head[1] = (uint8_t)(value >> 24);
+        head[2] = (uint8_t)(value >> 16);
+        head[3] = (uint8_t)(value >> 8);
+        head[4] = (uint8_t)value;
+        size = 5u;
+    }
+
+    emit(enc, head, size);
+}
+
+/*******************************************************************************
+* Function Name: json_decimal
+********************************************************************************
+* Summary:
+*  Sends a number in decimal.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  uint32_t value     : Magnitude
+*  bool negative      : Prefix a minus sign
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void json_decimal(doc_encoder_t *enc, uint32_t value, bool negative)
+{
+    uint8_t digits[DECIMAL_MAX_LENGTH];
+    uint32_t start = DECIMAL_MAX_LENGTH;
+
+    do
+    {
+        digits[--start] = (uint8_t)('0' + (value % 10u));
+        value /= 10u;
+    } while (0u != value);
+
+    if (negative)
+    {
+        digits[--start] = (uint8_t)'-';
+    }
+
+    emit(enc, &digits[start], DECIMAL_MAX_LENGTH - start);
+}
+
+/*******************************************************************************
+* Function Name: json_string
+********************************************************************************
+* Summary:
+*  Sends a quoted string. Quotes and backslashes are escaped, and control
+*  characters are replaced by a space.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *str    : String
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void json_string(doc_encoder_t *enc, const char *str)
+{
+    const char *run = str;
+
+    emit_byte(enc, (uint8_t)'"');
+    for (; '\0' != *str; str++)
+    {
+        if (('"' == *str) || ('\\' == *str) || ((uint8_t)*str < (uint8_t)' '))
+        {
+            emit(enc, (const uint8_t *)run, (uint32_t)(str - run));
+            if ((uint8_t)*str < (uint8_t)' ')
+            {
+                emit_byte(enc, (uint8_t)' ');
+            }
+            else
+            {
+                emit_byte(enc, (uint8_t)'\\');
+                emit_byte(enc, (uint8_t)*str);
+            }
+            run = str + 1;
+        }
+    }
+    emit(enc, (const uint8_t *)run, (uint32_t)(str - run));
+    emit_byte(enc, (uint8_t)'"');
+}
+
+/*******************************************************************************
+* Function Name: cbor_string
+********************************************************************************
+* Summary:
+*  Sends a CBOR text string.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *str    : String
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void cbor_string(doc_encoder_t *enc, const char *str)
+{
+    uint32_t length = (uint32_t)strlen(str);
+
+    cbor_head(enc, CBOR_TEXT, length);
+    emit(enc, (const uint8_t *)str, length);
+}
+
+/*******************************************************************************
+* Function Name: member
+********************************************************************************
+* Summary:
+*  Sends the separator and the key of a member of the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void member(doc_encoder_t *enc, const char *key)
+{
+    uint8_t bit = (uint8_t)(1u << (enc->depth - 1u));
+
+    if (DOC_FORMAT_CBOR == enc->format)
+    {
+        cbor_string(enc, key);
+    }
+    else
+    {
+        if (0u != (enc->has_members & bit))
+        {
+            emit_byte(enc, (uint8_t)',');
+        }
+        json_string(enc, key);
+        emit_byte(enc, (uint8_t)':');
+    }
+
+    enc->has_members |= bit;
+}
+
+/*******************************************************************************
+* Function Name: open_map
+********************************************************************************
+* Summary:
+*  Starts a map one level deeper.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void open_map(doc_encoder_t *enc)
+{
+    emit_byte(enc, (DOC_FORMAT_CBOR == enc->format) ? CBOR_MAP_INDEFINITE : (uint8_t)'{');
+    enc->depth++;
+    enc->has_members &= (uint8_t)~(1u << (enc->depth - 1u));
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_begin
+********************************************************************************
+* Summary:
+*  Starts a document, which is a map. A CBOR document starts with the
+*  self-describe tag, so that a reader can find it in a byte stream.
+*
+* Parameters:
+*  doc_encoder_t *enc  : Encoder
+*  doc_format_t format : JSON or CBOR
+*  doc_sink_t sink     : Receives the encoded bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_begin(doc_encoder_t *enc, doc_format_t format, doc_sink_t sink)
+{
+    enc->sink = sink;
+    enc->format = format;
+    enc->depth = 0u;
+    enc->has_members = 0u;
+    enc->size = 0u;
+
+    if (DOC_FORMAT_CBOR == format)
+    {
+        cbor_head(enc, CBOR_TAG, CBOR_SELF_DESCRIBE_TAG);
+    }
+    open_map(enc);
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_end
+********************************************************************************
+* Summary:
+*  Closes the maps still open and the document.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*
+* Return:
+*  uint32_t : Size of the document in bytes
+*
+*******************************************************************************/
+uint32_t doc_encoder_end(doc_encoder_t *enc)
+{
+    while (0u != enc->depth)
+    {
+        doc_encoder_map_end(enc);
+    }
+
+    return enc->size;
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_map_begin
+********************************************************************************
+* Summary:
+*  Starts a map member of the current map. The following values are its
+*  members until doc_encoder_map_end().
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key of the map
+*
+* Return:
+*  bool : false, and nothing is sent, if DOC_ENCODER_MAX_DEPTH is reached
+*
+*******************************************************************************/
+bool doc_encoder_map_begin(doc_encoder_t *enc, const char *key)
+{
+    if ((0u == enc->depth) || (enc->depth >= DOC_ENCODER_MAX_DEPTH))
+    {
+        return false;
+    }
+
+    member(enc, key);
+    open_map(enc);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_map_end
+********************************************************************************
+* Summary:
+*  Closes the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_map_end(doc_encoder_t *enc)
+{
+    if (0u != enc->depth)
+    {
+        emit_byte(enc, (DOC_FORMAT_CBOR == enc->format) ? CBOR_BREAK : (uint8_t)'}');
+        enc->depth--;
+    }
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_uint
+********************************************************************************
+* Summary:
+*  Adds an unsigned number to the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key
+*  uint32_t value     : Value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_uint(doc_encoder_t *enc, const char *key, uint32_t value)
+{
+    if (0u == enc->depth)
+    {
+        return;
+    }
+
+    member(enc, key);
+    if (DOC_FORMAT_CBOR == enc->format)
+    {
+        cbor_head(enc, CBOR_UNSIGNED, value);
+    }
+    else
+    {
+        json_decimal(enc, value, false);
+    }
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_int
+********************************************************************************
+* Summary:
+*  Adds a signed number to the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key
+*  int32_t value      : Value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_int(doc_encoder_t *enc, const char *key, int32_t value)
+{
+    /* Magnitude without overflow for INT32_MIN */
+    uint32_t magnitude = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+
+    if (0u == enc->depth)
+    {
+        return;
+    }
+
+    member(enc, key);
+    if (DOC_FORMAT_CBOR == enc->format)
+    {
+        /* A negative integer n is encoded as -1 - n */
+        cbor_head(enc, (value < 0) ? CBOR_NEGATIVE : CBOR_UNSIGNED,
+                  (value < 0) ? (magnitude - 1u) : magnitude);
+    }
+    else
+    {
+        json_decimal(enc, magnitude, (value < 0));
+    }
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_bool
+********************************************************************************
+* Summary:
+*  Adds a boolean to the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key
+*  bool value         : Value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_bool(doc_encoder_t *enc, const char *key, bool value)
+{
+    static const uint8_t json_true[] = "true";
+    static const uint8_t json_false[] = "false";
+
+    if (0u == enc->depth)
+    {
+        return;
+    }
+
+    member(enc, key);
+    if (DOC_FORMAT_CBOR == enc->format)
+    {
+        emit_byte(enc, value ? CBOR_TRUE : CBOR_FALSE);
+    }
+    else if (value)
+    {
+        emit(enc, json_true, sizeof(json_true) - 1u);
+    }
+    else
+    {
+        emit(enc, json_false, sizeof(json_false) - 1u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: doc_encoder_string
+********************************************************************************
+* Summary:
+*  Adds a string to the current map.
+*
+* Parameters:
+*  doc_encoder_t *enc : Encoder
+*  const char *key    : Key
+*  const char *value  : Value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void doc_encoder_string(doc_encoder_t *enc, const char *key, const char *value)
+{
+    if (0u == enc->depth)
+    {
+        return;
+    }
+
+    member(enc, key);
+    if (DOC_FORMAT_CBOR == enc->format)
+    {
+        cbor_string(enc, value);
+    }
+    else
+    {
+        json_string(enc, value);
+    }
+}
+
+/* [] END OF FILE */
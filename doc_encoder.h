@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   doc_encoder.h
+*
+* Description: This file contains the declarations of the streaming document encoder,
+*              which writes JSON or CBOR to a byte sink as the values are added.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef DOC_ENCODER_H
+#define DOC_ENCODER_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Deepest nesting of maps, the document itself included */
+#define DOC_ENCODER_MAX_DEPTH        (8u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    DOC_FORMAT_JSON = 0,         /* One line of compact JSON */
+    DOC_FORMAT_CBOR              /* CBOR with the self-describe tag, RFC 8949 */
+} doc_format_t;
+
+/* Receives the encoded bytes, for example user_uart_write() */
+typedef void (*doc_sink_t)(const uint8_t *data, uint32_t size);
+
+/* Encoder state; all fields are private */
+typedef struct
+{
+    doc_sink_t sink;
+    doc_format_t format;
+    uint8_t depth;
+    uint8_t has_members;         /* Bit n: the map at depth n has a member */
+    uint32_t size;
+} doc_encoder_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void doc_encoder_begin(doc_encoder_t *enc, doc_format_t format, doc_sink_t sink);
+uint32_t doc_encoder_end(doc_encoder_t *enc);
+bool doc_encoder_map_begin(doc_encoder_t *enc, const char *key);
+void doc_encoder_map_end(doc_encoder_t *enc);
+void doc_encoder_uint(doc_encoder_t *enc, const char *key, uint32_t value);
+void doc_encoder_int(doc_encoder_t *enc, const char *key, int32_t value);
+void doc_encoder_bool(doc_encoder_t *enc, const char *key, bool value);
+void doc_encoder_string(doc_encoder_t *enc, const char *key, const char *value);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DOC_ENCODER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,432 @@
+/******************************************************************************
+* File Name:   event_log.c
+*
+* Description: This file contains the event log. Records are appended in time order to
+*              a ring kept in RAM that is not initialized at boot, so the log survives
+*              a fault recovery. A sparse index holds the time of the first record of
+*              each block; a time-range query finds its first block with a binary
+*              search on the index and streams only the matching records.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "event_log.h"
+#include "timekeeping.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define LOG_MAGIC                (0x474F4C45u)   /* "ELOG" */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t total;                  /* Records appended since the log was cleared */
+    uint32_t last_epoch;             /* Time of the newest record */
+    uint32_t clamped;                /* Records whose time was raised */
+    uint32_t index[EVENT_LOG_BLOCKS];    /* Time of the first record of each block */
+    event_log_record_t records[EVENT_LOG_CAPACITY];
+} event_log_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Not initialized by the startup code, so it survives a software reset */
+static event_log_t event_log CY_NOINIT;
+
+/*******************************************************************************
+* Function Name: oldest_record
+********************************************************************************
+* Summary:
+*  Returns the sequence number of the oldest record still in the ring.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Sequence number of the oldest record
+*
+*******************************************************************************/
+static uint32_t oldest_record(void)
+{
+    return (event_log.total > EVENT_LOG_CAPACITY) ?
+           (event_log.total - EVENT_LOG_CAPACITY) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: get_record
+********************************************************************************
+* Summary:
+*  Returns the record with the given sequence number.
+*
+* Parameters:
+*  uint32_t seq : Sequence number, between the oldest and the newest record
+*
+* Return:
+*  const event_log_record_t* : Record in the ring
+*
+*******************************************************************************/
+static const event_log_record_t *get_record(uint32_t seq)
+{
+    return &event_log.records[seq % EVENT_LOG_CAPACITY];
+}
+
+/*******************************************************************************
+* Function Name: find_first
+********************************************************************************
+* Summary:
+*  Returns the sequence number from which a scan for the records at or after
+*  a time must start. The oldest block can be partly overwritten and its
+*  index entry reused, so only the complete blocks are searched: the result
+*  is the start of the last block that begins before the time, or the
+*  oldest record.
+*
+* Parameters:
+*  uint32_t start_epoch : Start of the range
+*  uint32_t *probes     : Incremented for each index entry compared
+*
+* Return:
+*  uint32_t : Sequence number where the scan starts
+*
+*******************************************************************************/
+static uint32_t find_first(uint32_t start_epoch, uint32_t *probes)
+{
+    uint32_t oldest = oldest_record();
+    uint32_t low = (oldest + EVENT_LOG_BLOCK_SIZE - 1u) / EVENT_LOG_BLOCK_SIZE;
+    uint32_t high = (event_log.total + EVENT_LOG_BLOCK_SIZE - 1u) / EVENT_LOG_BLOCK_SIZE;
+    uint32_t mid;
+
+    /* Find the first complete block that starts at or after the time */
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2u);
+        (*probes)++;
+        if (event_log.index[mid % EVENT_LOG_BLOCKS] < start_epoch)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    /* The block before it can still hold records in range; before the
+     * first complete block, start from the oldest record */
+    if ((0u == low) || (((low - 1u) * EVENT_LOG_BLOCK_SIZE) < oldest))
+    {
+        return oldest;
+    }
+
+    return (low - 1u) * EVENT_LOG_BLOCK_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: event_log_init
+********************************************************************************
+* Summary:
+*  Keeps the log after a fault recovery when its header is valid, clears it
+*  otherwise, then records the boot. Call once at boot, after the shadow
+*  time has been initialized.
+*
+* Parameters:
+*  bool warm_boot : true if this boot is a fault recovery
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_log_init(bool warm_boot)
+{
+    if (!warm_boot || (LOG_MAGIC != event_log.magic))
+    {
+        event_log_clear();
+    }
+
+    event_log_add(EVENT_LOG_BOOT, warm_boot ? 1 : 0);
+}
+
+/*******************************************************************************
+* Function Name: event_log_clear
+********************************************************************************
+* Summary:
+*  Removes all records.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_log_clear(void)
+{
+    event_log.magic = LOG_MAGIC;
+    event_log.total = 0u;
+    event_log.last_epoch = 0u;
+    event_log.clamped = 0u;
+}
+
+/*******************************************************************************
+* Function Name: event_log_add
+********************************************************************************
+* Summary:
+*  Appends a record with the shadow time. Must be called from the work
+*  context, not from an interrupt.
+*
+* Parameters:
+*  event_log_type_t type : Type of the event
+*  int32_t value         : Value of the event, depends on the type
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_log_add(event_log_type_t type, int32_t value)
+{
+    time_reading_t reading;
+
+    timekeeping_get(&reading);
+    event_log_add_at(reading.epoch, type, value);
+}
+
+/*******************************************************************************
+* Function Name: event_log_add_at
+********************************************************************************
+* Summary:
+*  Appends a record with the given time. The records must be in time order
+*  for the index, so a time before the newest record is raised to it and
+*  the record is flagged.
+*
+* Parameters:
+*  uint32_t epoch        : Time of the event, seconds since the epoch
+*  event_log_type_t type : Type of the event
+*  int32_t value         : Value of the event, depends on the type
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_log_add_at(uint32_t epoch, event_log_type_t type, int32_t value)
+{
+    uint32_t seq = event_log.total;
+    event_log_record_t *record = &event_log.records[seq % EVENT_LOG_CAPACITY];
+
+    record->flags = 0u;
+    if ((0u != seq) && (epoch < event_log.last_epoch))
+    {
+        epoch = event_log.last_epoch;
+        record->flags = EVENT_LOG_FLAG_CLAMPED;
+        event_log.clamped++;
+    }
+
+    record->epoch = epoch;
+    record->value = value;
+    record->type = (uint8_t)type;
+
+    if (0u == (seq % EVENT_LOG_BLOCK_SIZE))
+    {
+        event_log.index[(seq / EVENT_LOG_BLOCK_SIZE) % EVENT_LOG_BLOCKS] = epoch;
+    }
+
+    event_log.last_epoch = epoch;
+    event_log.total = seq + 1u;
+}
+
+/*******************************************************************************
+* Function Name: event_log_count
+********************************************************************************
+* Summary:
+*  Returns the number of records in the log.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of records
+*
+*******************************************************************************/
+uint32_t event_log_count(void)
+{
+    return event_log.total - oldest_record();
+}
+
+/*******************************************************************************
+* Function Name: event_log_clamped
+********************************************************************************
+* Summary:
+*  Returns the number of records whose time was raised to keep the log in
+*  time order.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of clamped records
+*
+*******************************************************************************/
+uint32_t event_log_clamped(void)
+{
+    return event_log.clamped;
+}
+
+/*******************************************************************************
+* Function Name: event_log_query
+********************************************************************************
+* Summary:
+*  Passes the records between two times, both included, to the visitor in
+*  time order. The first record is found with a binary search on the index
+*  and at most one block is scanned before it. Must be called from the work
+*  context; the visitor must not add records.
+*
+* Parameters:
+*  uint32_t start_epoch            : Start of the range
+*  uint32_t end_epoch              : End of the range
+*  event_log_visitor_t visitor     : Called for each record in the range
+*  void *context                   : Passed to the visitor
+*  event_log_query_stats_t *stats  : Receives the cost of the query, can be NULL
+*
+* Return:
+*  uint32_t : Number of records in the range
+*
+*******************************************************************************/
+uint32_t event_log_query(uint32_t start_epoch, uint32_t end_epoch,
+                         event_log_visitor_t visitor, void *context,
+                         event_log_query_stats_t *stats)
+{
+    event_log_query_stats_t query;
+    const event_log_record_t *record;
+    uint32_t start = cycle_count_get();
+    uint32_t seq;
+
+    memset(&query, 0, sizeof(query));
+
+    seq = find_first(start_epoch, &query.probes);
+    query.lookup_cycles = cycle_count_get() - start;
+
+    start = cycle_count_get();
+    for (; seq < event_log.total; seq++)
+    {
+        record = get_record(seq);
+        query.scanned++;
+
+        if (record->epoch > end_epoch)
+        {
+            break;
+        }
+        if (record->epoch >= start_epoch)
+        {
+            query.matches++;
+            visitor(record, context);
+        }
+    }
+    query.stream_cycles = cycle_count_get() - start;
+
+    if (NULL != stats)
+    {
+        *stats = query;
+    }
+
+    return query.matches;
+}
+
+/*******************************************************************************
+* Function Name: event_log_linear_lookup_cycles
+********************************************************************************
+* Summary:
+*  Measures the cost of finding the first record at or after a time by
+*  reading the log from the oldest record, as a reference for the index.
+*
+* Parameters:
+*  uint32_t start_epoch : Start of the range
+*  uint32_t *scanned    : Receives the number of records read
+*
+* Return:
+*  uint32_t : CPU cycles of the lookup
+*
+*******************************************************************************/
+uint32_t event_log_linear_lookup_cycles(uint32_t start_epoch, uint32_t *scanned)
+{
+    uint32_t start = cycle_count_get();
+    uint32_t seq = oldest_record();
+
+    while ((seq < event_log.total) && (get_record(seq)->epoch < start_epoch))
+    {
+        seq++;
+    }
+    start = cycle_count_get() - start;
+
+    *scanned = seq - oldest_record();
+    return start;
+}
+
+/*******************************************************************************
+* Function Name: event_log_type_name
+********************************************************************************
+* Summary:
+*  Returns a printable name for an event type.
+*
+* Parameters:
+*  event_log_type_t type : Type of the event
+*
+* Return:
+*  const char* : Name of the type
+*
+*******************************************************************************/
+const char *event_log_type_name(event_log_type_t type)
+{
+    static const char *const names[EVENT_LOG_TYPE_COUNT] =
+    {
+        "boot",
+        "command",
+        "time state",
+        "time step",
+        "adjtime",
+        "test"
+    };
+
+    return ((uint32_t)type < (uint32_t)EVENT_LOG_TYPE_COUNT) ? names[type] : "unknown";
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name:   event_log.h
+*
+* Description: This file contains the declarations of the event log and of its
+*              sparse time index used for time-range queries.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of records kept; the oldest records are overwritten */
+#define EVENT_LOG_CAPACITY       (1024u)
+
+/* Records per block of the time index, one index entry per block */
+#define EVENT_LOG_BLOCK_SIZE     (32u)
+#define EVENT_LOG_BLOCKS         (EVENT_LOG_CAPACITY / EVENT_LOG_BLOCK_SIZE)
+
+/* Record flag: the time was raised to the time of the previous record
+ * because the clock was set back */
+#define EVENT_LOG_FLAG_CLAMPED   (0x01u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    EVENT_LOG_BOOT = 0,          /* Value: 1 after a fault recovery, else 0 */
+    EVENT_LOG_COMMAND,           /* Value: console command character */
+    EVENT_LOG_TIME_STATE,        /* Value: new time_quality_state_t */
+    EVENT_LOG_TIME_STEP,         /* Value: step of the RTC in seconds */
+    EVENT_LOG_ADJTIME,           /* Value: requested adjustment in ms */
+    EVENT_LOG_TEST,              /* Value: sequence number of the test record */
+    EVENT_LOG_TYPE_COUNT
+} event_log_type_t;
+
+typedef struct
+{
+    uint32_t epoch;              /* Seconds since 01/01/2000 00:00:00 */
+    int32_t value;
+    uint8_t type;                /* event_log_type_t */
+    uint8_t flags;
+} event_log_record_t;
+
+typedef struct
+{
+    uint32_t lookup_cycles;      /* Index search for the first record */
+    uint32_t stream_cycles;      /* Scan and visitor calls */
+    uint32_t probes;             /* Index entries compared */
+    uint32_t scanned;            /* Records read */
+    uint32_t matches;            /* Records passed to the visitor */
+} event_log_query_stats_t;
+
+/* Called for each record of a query, in time order */
+typedef void (*event_log_visitor_t)(const event_log_record_t *record, void *context);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void event_log_init(bool warm_boot);
+void event_log_clear(void);
+void event_log_add(event_log_type_t type, int32_t value);
+void event_log_add_at(uint32_t epoch, event_log_type_t type, int32_t value);
+uint32_t event_log_count(void);
+uint32_t event_log_clamped(void);
+uint32_t event_log_query(uint32_t start_epoch, uint32_t end_epoch,
+                         event_log_visitor_t visitor, void *context,
+                         event_log_query_stats_t *stats);
+uint32_t event_log_linear_lookup_cycles(uint32_t start_epoch, uint32_t *scanned);
+const char *event_log_type_name(event_log_type_t type);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* EVENT_LOG_H */
+
+/* [] END OF FILE */
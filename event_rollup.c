@@ -0,0 +1,240 @@
+/******************************************************************************
+* File Name:   event_rollup.c
+*
+* Description: This file contains the calendar-bucketed event counters. Events
+*              are accumulated into the current minute, hour and day buckets
+*              without reading the RTC; the buckets are rotated lazily by
+*              event_rollup_advance() when the RTC tick crosses a boundary.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "event_rollup.h"
+#include "time_utils.h"
+#include "string.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Length of one bucket in seconds, for each granularity */
+static const uint32_t bucket_seconds[EVENT_ROLLUP_GRANULARITY_COUNT] =
+{
+    TIME_UTILS_SEC_PER_MIN,
+    TIME_UTILS_SEC_PER_HOUR,
+    TIME_UTILS_SEC_PER_DAY
+};
+
+static const uint32_t bucket_count[EVENT_ROLLUP_GRANULARITY_COUNT] =
+{
+    EVENT_ROLLUP_MINUTES,
+    EVENT_ROLLUP_HOURS,
+    EVENT_ROLLUP_DAYS
+};
+
+/*******************************************************************************
+* Function Name: get_buckets
+********************************************************************************
+* Summary:
+*  Returns the bucket array of the requested granularity.
+*
+* Parameters:
+*  const event_rollup_t *rollup           : Rollup instance
+*  event_rollup_granularity_t granularity : Requested granularity
+*
+* Return:
+*  uint32_t* : Pointer to the first bucket
+*
+*******************************************************************************/
+static uint32_t *get_buckets(const event_rollup_t *rollup,
+                             event_rollup_granularity_t granularity)
+{
+    const uint32_t *buckets;
+
+    switch (granularity)
+    {
+        case EVENT_ROLLUP_MINUTE:
+            buckets = rollup->minute;
+            break;
+        case EVENT_ROLLUP_HOUR:
+            buckets = rollup->hour;
+            break;
+        default:
+            buckets = rollup->day;
+            break;
+    }
+
+    return (uint32_t *)buckets;
+}
+
+/*******************************************************************************
+* Function Name: event_rollup_init
+********************************************************************************
+* Summary:
+*  Clears all buckets. The rollup is anchored to the calendar on the first
+*  call to event_rollup_advance().
+*
+* Parameters:
+*  event_rollup_t *rollup : Rollup instance
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_rollup_init(event_rollup_t *rollup)
+{
+    memset(rollup, 0, sizeof(*rollup));
+}
+
+/*******************************************************************************
+* Function Name: event_rollup_add
+********************************************************************************
+* Summary:
+*  Adds events to the current minute, hour and day buckets. The cost is
+*  constant and no time lookup is performed.
+*
+* Parameters:
+*  event_rollup_t *rollup : Rollup instance
+*  uint32_t count         : Number of events to add
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_rollup_add(event_rollup_t *rollup, uint32_t count)
+{
+    rollup->minute[rollup->head[EVENT_ROLLUP_MINUTE]] += count;
+    rollup->hour[rollup->head[EVENT_ROLLUP_HOUR]] += count;
+    rollup->day[rollup->head[EVENT_ROLLUP_DAY]] += count;
+}
+
+/*******************************************************************************
+* Function Name: event_rollup_advance
+********************************************************************************
+* Summary:
+*  Rotates the buckets of every granularity whose calendar boundary has been
+*  crossed since the last call. Skipped periods are cleared. If the clock
+*  moved backwards, the rollup is re-anchored without losing the counts.
+*  Call this function on every RTC second tick.
+*
+* Parameters:
+*  event_rollup_t *rollup : Rollup instance
+*  uint32_t epoch         : Current RTC time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void event_rollup_advance(event_rollup_t *rollup, uint32_t epoch)
+{
+    uint32_t gran;
+    uint32_t period;
+    uint32_t steps;
+    uint32_t *buckets;
+
+    for (gran = 0u; gran < (uint32_t)EVENT_ROLLUP_GRANULARITY_COUNT; gran++)
+    {
+        period = epoch / bucket_seconds[gran];
+
+        if (rollup->synced && (period > rollup->period[gran]))
+        {
+            buckets = get_buckets(rollup, (event_rollup_granularity_t)gran);
+            steps = period - rollup->period[gran];
+
+            if (steps >= bucket_count[gran])
+            {
+                memset(buckets, 0, bucket_count[gran] * sizeof(uint32_t));
+                rollup->head[gran] = 0u;
+            }
+            else
+            {
+                while (steps-- != 0u)
+                {
+                    rollup->head[gran] = (rollup->head[gran] + 1u) % bucket_count[gran];
+                    buckets[rollup->head[gran]] = 0u;
+                }
+            }
+        }
+
+        rollup->period[gran] = period;
+    }
+
+    rollup->synced = true;
+}
+
+/*******************************************************************************
+* Function Name: event_rollup_get_last
+********************************************************************************
+* Summary:
+*  Copies the totals of the last 'count' buckets of a granularity, starting
+*  with the current (partial) bucket.
+*
+* Parameters:
+*  const event_rollup_t *rollup           : Rollup instance
+*  event_rollup_granularity_t granularity : Requested granularity
+*  uint32_t count                         : Number of buckets requested
+*  uint32_t *totals                       : Output, newest bucket first
+*
+* Return:
+*  uint32_t : Number of buckets copied
+*
+*******************************************************************************/
+uint32_t event_rollup_get_last(const event_rollup_t *rollup,
+                               event_rollup_granularity_t granularity,
+                               uint32_t count, uint32_t *totals)
+{
+    const uint32_t *buckets = get_buckets(rollup, granularity);
+    uint32_t size = bucket_count[granularity];
+    uint32_t index = rollup->head[granularity];
+    uint32_t i;
+
+    if (count > size)
+    {
+        count = size;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        totals[i] = buckets[index];
+        index = (0u == index) ? (size - 1u) : (index - 1u);
+    }
+
+    return count;
+}
+
+/* [] END OF FILE */
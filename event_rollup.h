@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   event_rollup.h
+*
+* Description: This file contains the declarations of the calendar-bucketed
+*              event counters (per minute, per hour and per day rollups).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef EVENT_ROLLUP_H
+#define EVENT_ROLLUP_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of buckets kept for each granularity */
+#define EVENT_ROLLUP_MINUTES     (60u)
+#define EVENT_ROLLUP_HOURS       (24u)
+#define EVENT_ROLLUP_DAYS        (31u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    EVENT_ROLLUP_MINUTE = 0,
+    EVENT_ROLLUP_HOUR,
+    EVENT_ROLLUP_DAY,
+    EVENT_ROLLUP_GRANULARITY_COUNT
+} event_rollup_granularity_t;
+
+/* Fixed-size circular arrays, one per granularity. The bucket under
+ * head[] always belongs to the calendar period stored in period[]. */
+typedef struct
+{
+    uint32_t minute[EVENT_ROLLUP_MINUTES];
+    uint32_t hour[EVENT_ROLLUP_HOURS];
+    uint32_t day[EVENT_ROLLUP_DAYS];
+    uint32_t head[EVENT_ROLLUP_GRANULARITY_COUNT];
+    uint32_t period[EVENT_ROLLUP_GRANULARITY_COUNT];
+    bool synced;
+} event_rollup_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void event_rollup_init(event_rollup_t *rollup);
+void event_rollup_add(event_rollup_t *rollup, uint32_t count);
+void event_rollup_advance(event_rollup_t *rollup, uint32_t epoch);
+uint32_t event_rollup_get_last(const event_rollup_t *rollup,
+                               event_rollup_granularity_t granularity,
+                               uint32_t count, uint32_t *totals);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* EVENT_ROLLUP_H */
+
+/* [] END OF FILE */
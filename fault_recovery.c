@@ -0,0 +1,310 @@
+/******************************************************************************
+* File Name:   fault_recovery.c
+*
+* Description: This file contains the fast-recovery fault handling. Instead of
+*              halting, a fault is recorded in the reset history and a software
+*              reset is issued. The configuration is kept in a no-init RAM block
+*              protected by a checksum, and the RTC, which lives in the backup
+*              domain, keeps running; the next boot skips the RTC initialization
+*              and restores the configuration.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "fault_recovery.h"
+#include "timekeeping.h"
+#include "user_uart.h"
+#include "string.h"
+#include "stddef.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define RETAINED_MAGIC          (0x52435652u)   /* "RCVR" */
+
+#define FNV_OFFSET_BASIS        (2166136261u)
+#define FNV_PRIME               (16777619u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t recovery_pending;       /* Set just before the warm reset */
+    uint32_t recoveries;             /* Warm resets since the last cold boot */
+    uint32_t consecutive;            /* Warm resets without a stable run */
+    uint32_t ready_us;               /* Console ready time of the last recovery */
+    fault_recovery_config_t config;
+    uint32_t checksum;
+} retained_state_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Not initialized by the startup code, so it survives a software reset */
+static retained_state_t retained CY_NOINIT;
+
+/*******************************************************************************
+* Function Name: compute_checksum
+********************************************************************************
+* Summary:
+*  Computes the FNV-1a hash of the retained block, checksum excluded.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Checksum
+*
+*******************************************************************************/
+static uint32_t compute_checksum(void)
+{
+    const uint8_t *data = (const uint8_t *)&retained;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint32_t i;
+
+    for (i = 0u; i < offsetof(retained_state_t, checksum); i++)
+    {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_init
+********************************************************************************
+* Summary:
+*  Checks whether this boot follows a warm reset issued by
+*  fault_recovery_reset(). On a cold boot, the retained block is initialized
+*  with the default configuration. Call first thing at boot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if this boot is a fault recovery
+*
+*******************************************************************************/
+bool fault_recovery_init(void)
+{
+    bool warm = (RETAINED_MAGIC == retained.magic) &&
+                (compute_checksum() == retained.checksum) &&
+                (0u != retained.recovery_pending);
+
+    if (warm)
+    {
+        retained.recovery_pending = 0u;
+    }
+    else
+    {
+        memset(&retained, 0, sizeof(retained));
+        retained.magic = RETAINED_MAGIC;
+    }
+
+    fault_recovery_save();
+
+    return warm;
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_config
+********************************************************************************
+* Summary:
+*  Returns the configuration that is restored after a warm reset. Call
+*  fault_recovery_save() after changing it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  fault_recovery_config_t* : Retained configuration
+*
+*******************************************************************************/
+fault_recovery_config_t *fault_recovery_config(void)
+{
+    return &retained.config;
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_save
+********************************************************************************
+* Summary:
+*  Updates the checksum of the retained block.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void fault_recovery_save(void)
+{
+    retained.checksum = compute_checksum();
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_reset
+********************************************************************************
+* Summary:
+*  Records the fault in the reset history, captures the runtime state and
+*  issues a warm reset. The pending console messages are sent after the
+*  state has been saved, for at most USER_UART_FLUSH_TIMEOUT_US. Returns
+*  only if FAULT_RECOVERY_MAX_CONSECUTIVE faults happened without a stable
+*  run in between, so that the caller can halt. Call with interrupts
+*  disabled.
+*
+* Parameters:
+*  reset_cause_t cause : Cause to record
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void fault_recovery_reset(reset_cause_t cause)
+{
+    time_reading_t reading;
+    user_uart_tx_stats_t stats;
+
+    reset_log_record_fault(cause);
+
+    if ((0u != FAULT_RECOVERY_ENABLED) &&
+        (retained.consecutive < FAULT_RECOVERY_MAX_CONSECUTIVE))
+    {
+        timekeeping_get(&reading);
+        user_uart_get_tx_stats(&stats);
+
+        retained.config.quality_state = (uint32_t)TIME_QUALITY_STATE(reading.quality);
+        retained.config.last_sync_epoch = timekeeping_last_sync();
+        discipline_capture(&retained.config.discipline);
+        retained.config.rts_level = stats.rts_level;
+        retained.config.cts_enabled = stats.cts_enabled;
+        retained.consecutive++;
+        retained.recoveries++;
+        retained.recovery_pending = 1u;
+        fault_recovery_save();
+
+        (void)user_uart_flush();
+
+        __DSB();
+        NVIC_SystemReset();
+    }
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_on_tick
+********************************************************************************
+* Summary:
+*  Clears the consecutive fault count once the run has been stable for
+*  FAULT_RECOVERY_STABLE_SECONDS. Call on every RTC second.
+*
+* Parameters:
+*  uint32_t uptime : Seconds since boot
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void fault_recovery_on_tick(uint32_t uptime)
+{
+    if ((uptime >= FAULT_RECOVERY_STABLE_SECONDS) && (0u != retained.consecutive))
+    {
+        retained.consecutive = 0u;
+        fault_recovery_save();
+    }
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_set_ready_time
+********************************************************************************
+* Summary:
+*  Stores the time it took to get the console back after a warm reset.
+*
+* Parameters:
+*  uint32_t ready_us : Recovery time in microseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void fault_recovery_set_ready_time(uint32_t ready_us)
+{
+    retained.ready_us = ready_us;
+    fault_recovery_save();
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_count
+********************************************************************************
+* Summary:
+*  Returns the number of warm resets since the last cold boot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of recoveries
+*
+*******************************************************************************/
+uint32_t fault_recovery_count(void)
+{
+    return retained.recoveries;
+}
+
+/*******************************************************************************
+* Function Name: fault_recovery_ready_time
+********************************************************************************
+* Summary:
+*  Returns the console ready time of the last recovery.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Recovery time in microseconds, 0 if there was no recovery
+*
+*******************************************************************************/
+uint32_t fault_recovery_ready_time(void)
+{
+    return retained.ready_us;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name:   fault_recovery.h
+*
+* Description: This file contains the declarations of the fast-recovery fault
+*              handling (warm reset preserving the RTC and the configuration).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FAULT_RECOVERY_H
+#define FAULT_RECOVERY_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "reset_log.h"
+#include "discipline.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Set to 0 to halt in handle_error() instead of performing a warm reset */
+#define FAULT_RECOVERY_ENABLED            (1u)
+
+/* Faults allowed in a row before the recovery gives up and halts */
+#define FAULT_RECOVERY_MAX_CONSECUTIVE    (3u)
+
+/* Uptime after which a run is considered stable again, in seconds */
+#define FAULT_RECOVERY_STABLE_SECONDS     (10u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Configuration restored after a warm reset */
+typedef struct
+{
+    uint32_t dst_flag;               /* Value of dst_data_flag */
+    cy_stc_rtc_dst_t dst_time;       /* DST rules, valid if DST is enabled */
+    uint32_t quality_state;          /* time_quality_state_t at the fault */
+    uint32_t last_sync_epoch;        /* Time of the last set or sync */
+    discipline_retained_t discipline;
+    uint32_t rts_level;              /* UART flow control at the fault */
+    bool cts_enabled;
+} fault_recovery_config_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool fault_recovery_init(void);
+fault_recovery_config_t *fault_recovery_config(void);
+void fault_recovery_save(void);
+void fault_recovery_reset(reset_cause_t cause);
+void fault_recovery_on_tick(uint32_t uptime);
+void fault_recovery_set_ready_time(uint32_t ready_us);
+uint32_t fault_recovery_count(void);
+uint32_t fault_recovery_ready_time(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* FAULT_RECOVERY_H */
+
+/* [] END OF FILE */
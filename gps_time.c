@@ -0,0 +1,333 @@
+/******************************************************************************
+* File Name:   gps_time.c
+*
+* Description: This file contains the GPS time source. The received NMEA characters
+*              are passed to the incremental parser; the offset of the served time from
+*              each fix is slewed out by the discipline loop, or stepped when it is
+*              large and has been confirmed. The parse cost of every sentence is
+*              measured with the cycle counter.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "gps_time.h"
+#include "nmea.h"
+#include "timekeeping.h"
+#include "holdover.h"
+#include "discipline.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            (1000000000)
+#define NS_PER_HALF_SECOND       (NS_PER_SECOND / 2)
+#define NS_PER_MS                (1000000)
+#define NS_PER_US                (1000)
+
+/* Time of a character on the UART: a start bit, 8 data bits, a stop bit */
+#define CHAR_NS                  ((10LL * NS_PER_SECOND) / GPS_TIME_BAUD_RATE)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static nmea_parser_t parser;
+static gps_time_stats_t gps_stats;
+
+/* Cycles spent in the parser since the start of the current sentence */
+static uint32_t sentence_cycles = 0u;
+
+/* Cycle count of the interrupt that received the '$' of the current
+ * sentence, and whether the CPU clock changed since */
+static uint32_t sentence_rx_cycles = 0u;
+static bool sentence_clock_changed = false;
+
+/* Cycle count of the last change of the CPU clock not yet compared with a
+ * '$', which can be received before the change and fed after it */
+static uint32_t clock_change_cycles = 0u;
+static bool clock_change_pending = false;
+
+/* Offset in seconds waiting for confirmation and the number of fixes that
+ * reported it */
+static int32_t pending_offset = 0;
+static uint32_t pending_count = 0u;
+
+/*******************************************************************************
+* Function Name: apply_fix
+********************************************************************************
+* Summary:
+*  Measures the offset of the served time from a fix, at the start of its
+*  sentence: the served time is taken back by the time since the interrupt
+*  that received the '$', measured with the cycle counter, and by the time
+*  of the '$' itself, so neither the transmission of the sentence nor its
+*  wait in the RX queue and behind other work items biases the offset. The
+*  reference is moved on by GPS_TIME_SENTENCE_DELAY_US. Offsets below
+*  DISCIPLINE_STEP_THRESHOLD_MS are passed to the discipline loop, which
+*  slews them out. Larger offsets step the clock once GPS_TIME_CONFIRM_FIXES
+*  fixes in a row agree on the same number of seconds. The time quality
+*  becomes synced and the fix is reported to the holdover. A fix received
+*  across a change of the CPU clock is dropped, since its age cannot be
+*  converted from cycles.
+*
+* Parameters:
+*  const nmea_fix_t *fix : Fix decoded from a sentence
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void apply_fix(const nmea_fix_t *fix)
+{
+    uint32_t reference = fix->epoch + (uint32_t)GPS_TIME_ZONE_OFFSET_S;
+    uint32_t served_sec;
+    uint32_t served_ns;
+    uint32_t now;
+    int64_t age_ns;
+    int64_t offset_ns;
+    int32_t offset_ms;
+    int32_t offset_s;
+    uint32_t magnitude;
+
+    if ((!discipline_ready()) || sentence_clock_changed)
+    {
+        /* After a reset, the fixes are used from the first RTC second; a
+         * sentence received across a change of the CPU clock is not timed */
+        return;
+    }
+
+    discipline_now(&served_sec, &served_ns);
+    now = cycle_count_get();
+    age_ns = (int64_t)(((uint64_t)(now - sentence_rx_cycles) * NS_PER_SECOND) / SystemCoreClock) +
+             CHAR_NS;
+    offset_ns = ((int64_t)(int32_t)(reference - served_sec) * NS_PER_SECOND) +
+                ((int64_t)fix->millis * NS_PER_MS) - (int64_t)served_ns + age_ns +
+                ((int64_t)GPS_TIME_SENTENCE_DELAY_US * NS_PER_US);
+    offset_ms = (int32_t)(offset_ns / NS_PER_MS);
+    magnitude = (offset_ms < 0) ? (uint32_t)(-offset_ms) : (uint32_t)offset_ms;
+
+    gps_stats.fixes++;
+    gps_stats.last_offset_ms = offset_ms;
+    gps_stats.last_millis = fix->millis;
+    if (magnitude > gps_stats.max_offset_ms)
+    {
+        gps_stats.max_offset_ms = magnitude;
+    }
+
+    if (magnitude < DISCIPLINE_STEP_THRESHOLD_MS)
+    {
+        pending_count = 0u;
+        gps_stats.slewed_fixes++;
+        discipline_update((int32_t)offset_ns);
+        timekeeping_set(served_sec, TIME_QUALITY_SYNCED);
+        holdover_on_sync(reference);
+        return;
+    }
+
+    offset_s = (int32_t)((offset_ns + ((offset_ns < 0) ? -NS_PER_HALF_SECOND : NS_PER_HALF_SECOND)) /
+                         NS_PER_SECOND);
+    if ((0u != pending_count) && (offset_s == pending_offset))
+    {
+        pending_count++;
+    }
+    else
+    {
+        pending_offset = offset_s;
+        pending_count = 1u;
+    }
+
+    if (pending_count >= GPS_TIME_CONFIRM_FIXES)
+    {
+        pending_count = 0u;
+
+        discipline_step(offset_ns);
+        gps_stats.steps++;
+        timekeeping_set(reference, TIME_QUALITY_SYNCED);
+        holdover_on_sync(reference);
+    }
+}
+
+/*******************************************************************************
+* Function Name: gps_time_init
+********************************************************************************
+* Summary:
+*  Initializes the parser and clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void gps_time_init(void)
+{
+    nmea_parser_init(&parser);
+    memset(&gps_stats, 0, sizeof(gps_stats));
+    sentence_cycles = 0u;
+    sentence_clock_changed = false;
+    clock_change_pending = false;
+    pending_count = 0u;
+}
+
+/*******************************************************************************
+* Function Name: gps_time_feed
+********************************************************************************
+* Summary:
+*  Processes one character received from the GPS receiver just now.
+*
+* Parameters:
+*  char ch : Received character
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void gps_time_feed(char ch)
+{
+    gps_time_feed_at(ch, cycle_count_get());
+}
+
+/*******************************************************************************
+* Function Name: gps_time_feed_at
+********************************************************************************
+* Summary:
+*  Processes one character received from the GPS receiver, with the cycle
+*  count of the interrupt that received it. The parse cost is accumulated
+*  per sentence; applying the fix is not included.
+*
+* Parameters:
+*  char ch            : Received character
+*  uint32_t rx_cycles : Cycle count when the character was received
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void gps_time_feed_at(char ch, uint32_t rx_cycles)
+{
+    nmea_fix_t fix;
+    nmea_result_t result;
+    uint32_t start;
+
+    if ('$' == ch)
+    {
+        sentence_cycles = 0u;
+        sentence_rx_cycles = rx_cycles;
+        sentence_clock_changed = clock_change_pending &&
+                                 ((clock_change_cycles - rx_cycles) <= (cycle_count_get() - rx_cycles));
+        clock_change_pending = false;
+    }
+
+    start = cycle_count_get();
+    result = nmea_parser_feed(&parser, ch, &fix);
+    sentence_cycles += cycle_count_get() - start;
+
+    if (NMEA_RESULT_PENDING == result)
+    {
+        return;
+    }
+
+    gps_stats.sentences++;
+    gps_stats.parse_cycles_last = sentence_cycles;
+    gps_stats.parse_cycles_total += sentence_cycles;
+    if (sentence_cycles > gps_stats.parse_cycles_max)
+    {
+        gps_stats.parse_cycles_max = sentence_cycles;
+    }
+
+    switch (result)
+    {
+        case NMEA_RESULT_FIX:
+            apply_fix(&fix);
+            break;
+        case NMEA_RESULT_CHECKSUM_ERROR:
+            gps_stats.checksum_errors++;
+            break;
+        case NMEA_RESULT_FORMAT_ERROR:
+            gps_stats.format_errors++;
+            break;
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: gps_time_clock_changed
+********************************************************************************
+* Summary:
+*  Notes a change of the CPU clock, which also changes the rate of the cycle
+*  counter: the sentence in progress, and the next one if its '$' was
+*  received before the change, cannot be timed. Must be called with
+*  interrupts disabled, after SystemCoreClock has been updated.
+*
+* Parameters:
+*  uint32_t old_hz : CPU clock before the change
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void gps_time_clock_changed(uint32_t old_hz)
+{
+    (void)old_hz;
+
+    clock_change_cycles = cycle_count_get();
+    clock_change_pending = true;
+    sentence_clock_changed = true;
+}
+
+/*******************************************************************************
+* Function Name: gps_time_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the statistics.
+*
+* Parameters:
+*  gps_time_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void gps_time_get_stats(gps_time_stats_t *stats)
+{
+    *stats = gps_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name:   gps_time.h
+*
+* Description: This file contains the declarations of the GPS time source, which
+*              disciplines the served time from NMEA sentences.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef GPS_TIME_H
+#define GPS_TIME_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Offset of the RTC time from UTC, in seconds */
+#define GPS_TIME_ZONE_OFFSET_S       (0)
+
+/* Number of consecutive fixes that must report the same offset before a
+ * large offset is stepped, so that a corrupted sentence does not move the
+ * clock */
+#define GPS_TIME_CONFIRM_FIXES       (2u)
+
+/* Baud rate of the sentences, for the time of a character of 10 bits */
+#define GPS_TIME_BAUD_RATE           (115200u)
+
+/* Delay of the receiver from the time stated in a sentence to the start of
+ * the sentence, in us. It depends on the receiver and its settings, from
+ * tens to hundreds of ms, and is measured against its PPS output; it is
+ * left in the offset of the served time when 0 */
+#define GPS_TIME_SENTENCE_DELAY_US   (0u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t sentences;          /* Complete sentences received */
+    uint32_t fixes;              /* Sentences with a valid time */
+    uint32_t checksum_errors;
+    uint32_t format_errors;
+    uint32_t steps;              /* Offsets corrected by a step */
+    int32_t last_offset_ms;      /* Reference minus served time at the last fix */
+    uint32_t max_offset_ms;      /* Largest absolute offset seen */
+    uint32_t slewed_fixes;       /* Fixes passed to the discipline loop */
+    uint32_t last_millis;        /* Fraction of the second of the last fix */
+    uint32_t parse_cycles_last;  /* Parse cost of the last sentence */
+    uint32_t parse_cycles_max;
+    uint32_t parse_cycles_total;
+} gps_time_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void gps_time_init(void);
+void gps_time_feed(char ch);
+void gps_time_feed_at(char ch, uint32_t rx_cycles);
+void gps_time_clock_changed(uint32_t old_hz);
+void gps_time_get_stats(gps_time_stats_t *stats);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* GPS_TIME_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,291 @@
+/******************************************************************************
+* File Name:   holdover.c
+*
+* Description: This file contains the holdover of the served time. While the clock is
+*              synced, the discipline loop learns the frequency error of the RTC. When
+*              no fix arrives for HOLDOVER_TIMEOUT_S seconds, the quality state becomes
+*              holdover and the loop keeps applying the learned frequency correction.
+*              The error bound of the time grows with the age of the last sync and is
+*              derived from the time-quality word.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "holdover.h"
+#include "timekeeping.h"
+#include "discipline.h"
+#include "time_utils.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* The drift is reported in units of 0.1 ppm */
+#define PPB_PER_DPPM             (100)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static holdover_stats_t holdover_stats;
+
+/* Time of the last fix */
+static uint32_t last_sync_epoch = 0u;
+
+/* The loop was locked at its last fix */
+static bool loop_locked = false;
+
+/* Holdover in progress and its start time */
+static bool in_holdover = false;
+static uint32_t holdover_epoch = 0u;
+
+/*******************************************************************************
+* Function Name: update_drift
+********************************************************************************
+* Summary:
+*  Copies the frequency correction learned by the discipline loop into the
+*  statistics, with the lock state of the loop. A positive drift means that
+*  the RTC runs fast.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void update_drift(void)
+{
+    discipline_stats_t loop;
+
+    discipline_get_stats(&loop);
+    holdover_stats.drift_dppm = -loop.freq_ppb / PPB_PER_DPPM;
+    holdover_stats.drift_learned = loop.ever_locked;
+    loop_locked = loop.locked;
+}
+
+/*******************************************************************************
+* Function Name: holdover_init
+********************************************************************************
+* Summary:
+*  Clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void holdover_init(void)
+{
+    memset(&holdover_stats, 0, sizeof(holdover_stats));
+    last_sync_epoch = 0u;
+    loop_locked = false;
+    in_holdover = false;
+}
+
+/*******************************************************************************
+* Function Name: holdover_on_sync
+********************************************************************************
+* Summary:
+*  Called by the time source for every fix used by the discipline loop.
+*  Ends a holdover in progress.
+*
+* Parameters:
+*  uint32_t epoch : Reference time of the fix
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void holdover_on_sync(uint32_t epoch)
+{
+    if (in_holdover)
+    {
+        in_holdover = false;
+        holdover_stats.last_duration = epoch - holdover_epoch;
+    }
+
+    last_sync_epoch = epoch;
+}
+
+/*******************************************************************************
+* Function Name: holdover_on_tick
+********************************************************************************
+* Summary:
+*  Called once per second. Enters holdover when the fixes stop while the
+*  time is synced, including a synced state restored after a reset. The
+*  discipline loop receives no more offsets and keeps running on the last
+*  frequency correction.
+*
+* Parameters:
+*  uint32_t epoch : Served time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void holdover_on_tick(uint32_t epoch)
+{
+    time_reading_t reading;
+
+    timekeeping_get(&reading);
+
+    if (!in_holdover)
+    {
+        if ((TIME_QUALITY_SYNCED == TIME_QUALITY_STATE(reading.quality)) &&
+            ((epoch - last_sync_epoch) > HOLDOVER_TIMEOUT_S))
+        {
+            in_holdover = true;
+            holdover_epoch = epoch;
+            holdover_stats.entries++;
+            timekeeping_set_state(TIME_QUALITY_HOLDOVER);
+        }
+    }
+    else if (TIME_QUALITY_HOLDOVER != TIME_QUALITY_STATE(reading.quality))
+    {
+        /* The time has been set by an operator */
+        in_holdover = false;
+        holdover_stats.last_duration = epoch - holdover_epoch;
+    }
+    else
+    {
+        /* Holdover continues */
+    }
+}
+
+/*******************************************************************************
+* Function Name: holdover_error_bound_ms
+********************************************************************************
+* Summary:
+*  Returns the bound of the time error for a time-quality word. A synced
+*  time is within HOLDOVER_LOCKED_ERROR_MS while the loop is locked, and
+*  within HOLDOVER_UNLOCKED_ERROR_MS otherwise; in holdover, the loop keeps
+*  the state of its last fix, and the drift uncertainty adds to the bound for
+*  every second since the last sync, up to the end of the minute of the age,
+*  rounded up to the next ms. The bound of an unset or manual time is
+*  unknown.
+*
+* Parameters:
+*  uint32_t quality : Time-quality word of a reading
+*
+* Return:
+*  uint32_t : Error bound in milliseconds, HOLDOVER_ERROR_BOUND_UNKNOWN if
+*             unknown
+*
+*******************************************************************************/
+uint32_t holdover_error_bound_ms(uint32_t quality)
+{
+    /* The age is counted in whole minutes */
+    uint32_t age_s = (TIME_QUALITY_AGE_MIN(quality) + 1u) * TIME_UTILS_SEC_PER_MIN;
+    uint32_t initial;
+    uint32_t uncertainty;
+    uint32_t bound = HOLDOVER_ERROR_BOUND_UNKNOWN;
+
+    update_drift();
+    initial = loop_locked ? HOLDOVER_LOCKED_ERROR_MS : HOLDOVER_UNLOCKED_ERROR_MS;
+    uncertainty = holdover_stats.drift_learned ? HOLDOVER_LEARNED_UNCERTAINTY_DPPM :
+                                                 HOLDOVER_UNLEARNED_UNCERTAINTY_DPPM;
+
+    switch (TIME_QUALITY_STATE(quality))
+    {
+        case TIME_QUALITY_SYNCED:
+            bound = initial;
+            break;
+        case TIME_QUALITY_HOLDOVER:
+            /* 0.1 ppm for one second is 0.0001 ms */
+            bound = initial +
+                    (uint32_t)((((uint64_t)uncertainty * age_s) + 9999u) / 10000u);
+            break;
+        default:
+            break;
+    }
+
+    return bound;
+}
+
+/*******************************************************************************
+* Function Name: holdover_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the holdover statistics.
+*
+* Parameters:
+*  holdover_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void holdover_get_stats(holdover_stats_t *stats)
+{
+    update_drift();
+    *stats = holdover_stats;
+}
+
+/*******************************************************************************
+* Function Name: holdover_restore
+********************************************************************************
+* Summary:
+*  Restores the time of the last fix after a warm reset, once the time
+*  quality has been restored. A holdover in progress continues; its start is
+*  taken as the end of the timeout after the last fix.
+*
+* Parameters:
+*  uint32_t sync_epoch : Time of the last fix
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void holdover_restore(uint32_t sync_epoch)
+{
+    time_reading_t reading;
+
+    timekeeping_get(&reading);
+
+    last_sync_epoch = sync_epoch;
+    in_holdover = (TIME_QUALITY_HOLDOVER == TIME_QUALITY_STATE(reading.quality));
+    if (in_holdover)
+    {
+        holdover_epoch = sync_epoch + HOLDOVER_TIMEOUT_S + 1u;
+    }
+}
+
+/* [] END OF FILE */
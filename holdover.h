@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   holdover.h
+*
+* Description: This file contains the declarations of the holdover of the
+*              served time when the external time reference is lost.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOLDOVER_H
+#define HOLDOVER_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "discipline.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Seconds without a fix after which a synced clock enters holdover */
+#define HOLDOVER_TIMEOUT_S           (10u)
+
+/* Error of a synced time. While the discipline loop is locked, its offsets
+ * stay within DISCIPLINE_LOCK_NS; they are measured through the latency
+ * jitter of the sentences, so as much again is allowed for it. Otherwise, a
+ * fix is only stepped beyond DISCIPLINE_STEP_THRESHOLD_MS */
+#define HOLDOVER_LOCKED_ERROR_MS     ((uint32_t)(((2 * DISCIPLINE_LOCK_NS) + 999999) / 1000000))
+#define HOLDOVER_UNLOCKED_ERROR_MS   (DISCIPLINE_STEP_THRESHOLD_MS)
+
+/* Uncertainty of the drift, in units of 0.1 ppm: of the learned estimate,
+ * and of the crystal tolerance when nothing has been learned yet */
+#define HOLDOVER_LEARNED_UNCERTAINTY_DPPM    (20u)
+#define HOLDOVER_UNLEARNED_UNCERTAINTY_DPPM  (200u)
+
+/* Returned by holdover_error_bound_ms() for an unset or manual time */
+#define HOLDOVER_ERROR_BOUND_UNKNOWN (0xFFFFFFFFu)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t entries;            /* Times the reference has been lost */
+    uint32_t last_duration;      /* Length of the last holdover, seconds */
+    int32_t drift_dppm;          /* Learned drift, 0.1 ppm, positive if fast */
+    bool drift_learned;
+} holdover_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void holdover_init(void);
+void holdover_on_sync(uint32_t epoch);
+void holdover_on_tick(uint32_t epoch);
+uint32_t holdover_error_bound_ms(uint32_t quality);
+void holdover_get_stats(holdover_stats_t *stats);
+void holdover_restore(uint32_t sync_epoch);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* HOLDOVER_H */
+
+/* [] END OF FILE */
@@ -44,16 +44,43 @@
  ******************************************************************************/
 #include "cy_pdl.h"
 #include "cybsp.h"
+#include "app_config.h"
 #include "string.h"
+#if APP_CONFIG_STDIO
 #include "stdio.h"
+#endif
+#include "time_utils.h"
+#include "event_rollup.h"
+#include "user_uart.h"
+#include "app_arena.h"
+#include "rtc_snapshot.h"
+#include "cycle_count.h"
+#include "timekeeping.h"
+#include "reset_log.h"
+#include "fault_recovery.h"
+#include "work_queue.h"
+#include "rtc_tick.h"
+#include "reactor.h"
+#include "gps_time.h"
+#include "nmea.h"
+#include "nmea_sim.h"
+#include "holdover.h"
+#include "discipline.h"
+#include "event_log.h"
+#include "sampler.h"
+#include "adc_sim.h"
+#include "ts_store.h"
+#include "perf_state.h"
+#include "power_bench.h"
+#include "doc_encoder.h"
+#include "trace.h"
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
 
-#define UART_TIMEOUT_MS (10u)      /* in milliseconds */
 #define INPUT_TIMEOUT_MS (120000u) /* in milliseconds */
-#define UART_GET_CHAR_DELAY  (1u)   /* in milliseconds */
+#define MS_PER_SECOND    (1000u)
 
 #define MAX_ATTEMPTS             (500u)  /* Maximum number of attempts for RTC operation */
 #define INIT_DELAY_MS             (5u)    /* delay 5 milliseconds before trying again */
@@ -63,11 +90,32 @@
 /* Available commands */
 #define RTC_CMD_SET_DATE_TIME ('1')
 #define RTC_CMD_CONFIG_DST ('2')
+#define RTC_CMD_SHOW_EVENTS ('3')
+#define RTC_CMD_FLOW_CONTROL ('4')
+#define RTC_CMD_BENCH_RTC_READ ('5')
+#define RTC_CMD_RESET_HISTORY ('6')
+#define RTC_CMD_GPS_TIME ('7')
+#define RTC_CMD_ADJUST_TIME ('8')
+#define RTC_CMD_EVENT_LOG ('9')
+#define RTC_CMD_SAMPLER ('a')
+#define RTC_CMD_BENCH_PLACEMENT ('b')
+#define RTC_CMD_PERF_STATE ('c')
+#define RTC_CMD_BENCH_POWER ('d')
+#define RTC_CMD_SELF_BENCH ('e')
+#define RTC_CMD_STATS_JSON ('f')
+#define RTC_CMD_STATS_CBOR ('g')
+#define RTC_CMD_DUMP_TRACE ('h')
 
 #define RTC_CMD_ENABLE_DST ('1')
 #define RTC_CMD_DISABLE_DST ('2')
 #define RTC_CMD_QUIT_CONFIG_DST ('3')
 
+#define RTC_CMD_START_NMEA_SIM ('1')
+#define RTC_CMD_STOP_NMEA_SIM ('2')
+
+#define RTC_CMD_QUERY_EVENT_LOG ('1')
+#define RTC_CMD_FILL_EVENT_LOG ('2')
+
 #define FIXED_DST_FORMAT ('1')
 #define RELATIVE_DST_FORMAT ('2')
 
@@ -85,257 +133,2436 @@
 #define LEAP_YEAR_MONTH1     (1u)
 #define LEAP_YEAR_MONTH2     (2u)
 
-#define IS_LEAP_YEAR(year) \
-(((0U == (year % 4UL)) && (0U != (year % 100UL))) || (0U == (year % 400UL)))
+#define IS_LEAP_YEAR(year) \
+(((0U == (year % 4UL)) && (0U != (year % 100UL))) || (0U == (year % 400UL)))
+
+/* Highest RTS trigger level accepted by the flow control command */
+#define MAX_RTS_LEVEL        (63u)
+
+/* Number of reads averaged by the RTC read benchmark */
+#define RTC_BENCH_ITERATIONS (100u)
+
+/* Number of buckets shown per granularity by the event counter command */
+#define EVENT_SHOW_MINUTES   (10u)
+#define EVENT_SHOW_HOURS     (6u)
+#define EVENT_SHOW_DAYS      (7u)
+
+/* Interval between the test records written to the event log */
+#define EVENT_LOG_TEST_INTERVAL_S (3u)
+
+/* Minute summaries shown by the sampler command */
+#define SAMPLER_SHOW_MINUTES (5u)
+
+/* Calls of the formatter per placement in the code placement benchmark */
+#define PLACEMENT_BENCH_ITERATIONS (100u)
+
+/* Iterations per row of the power mode benchmark; an RTC iteration lasts
+ * up to two seconds */
+#define POWER_BENCH_RTC_ITERATIONS  (10u)
+#define POWER_BENCH_UART_ITERATIONS (50u)
+
+/* Calls per case of the self-benchmark */
+#define SELF_BENCH_ITERATIONS (100u)
+
+/* Width of the table rule, also the payload of the UART throughput case */
+#define SELF_BENCH_RULE_LENGTH (44u)
+
+#define NS_PER_SECOND        (1000000000u)
+#define US_PER_SECOND        (1000000u)
+
+/* Commands shorter than this are timed with the cycle counter, which wraps
+ * after 23 s at 180 MHz; longer ones with the RTC ticks */
+#define COMMAND_CYCLES_MAX_S (10u)
+
+/* Memory the hot paths run from */
+#if APP_CONFIG_RAM_CODE
+#define HOT_PATH_MEMORY      "SRAM"
+#else
+#define HOT_PATH_MEMORY      "flash"
+#endif
+
+/***********************************
+ * ********************************************
+* Global Variables
+*******************************************************************************/
+uint32_t dst_data_flag = 0;
+
+/* Console commands received, bucketed per minute, hour and day */
+static event_rollup_t command_rollup;
+
+/* History of the sensor sampled every second */
+static ts_store_t sensor_store;
+
+/* Schedules of the sampled channels: every second on the second, every
+ * second half a second later, and every minute on the minute */
+static const sampler_channel_config_t sampler_channels[] =
+{
+    { .period_s = 1u,  .phase_ms = 0u,   .read = adc_sim_read, .store = &sensor_store },
+    { .period_s = 1u,  .phase_ms = 500u, .read = adc_sim_read, .store = NULL },
+    { .period_s = 60u, .phase_ms = 0u,   .read = adc_sim_read, .store = NULL }
+};
+
+#if APP_CONFIG_MENUS
+/* Input of the self-benchmark cases, and sink of their results so that the
+ * calls are not optimized out */
+static cy_stc_rtc_config_t self_bench_time;
+static volatile uint32_t self_bench_sink;
+
+/* Time sentence parsed by the NMEA case */
+static const char self_bench_sentence[] = "$GPZDA,123456.00,18,10,2026,00,00*6F\r\n";
+#endif
+
+/* Duration of the console commands, the input of the interactive commands
+ * included */
+static uint32_t command_count = 0u;
+static uint32_t command_max_us = 0u;
+static uint64_t command_total_us = 0u;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static cy_en_rtc_status_t rtc_init(bool warm_boot);
+static void restore_config(void);
+static void on_rtc_tick(uint32_t tick);
+static void on_uart_rx(uint32_t arg);
+static void record_command_time(uint32_t start_cycles, uint32_t start_tick);
+static void send_stats(doc_format_t format);
+
+#if APP_CONFIG_TEXT_FORMAT
+static void convert_date_to_string(cy_stc_rtc_config_t *dateTime,
+                                   time_quality_state_t quality,
+                                   char *line, size_t size);
+#endif
+
+#if (APP_CONFIG_TEXT_FORMAT) && (APP_CONFIG_MENUS)
+static void convert_date_to_string_flash(cy_stc_rtc_config_t *dateTime,
+                                         time_quality_state_t quality,
+                                         char *line, size_t size);
+#endif
+
+#if APP_CONFIG_MENUS
+static void set_new_time(uint32_t timeout_ms);
+static cy_rslt_t fetch_time_data(char *buffer,
+                             uint32_t timeout_ms, uint32_t *space_count);
+static void show_event_counters(void);
+static void configure_flow_control(uint32_t timeout_ms);
+static void benchmark_rtc_read(void);
+static void show_reset_history(void);
+static void configure_gps_time(uint32_t timeout_ms);
+static void adjust_time(uint32_t timeout_ms);
+static void query_event_log(uint32_t timeout_ms);
+static void show_sampler(void);
+static void benchmark_code_placement(void);
+static void print_isr_cycles(const char *label, const cycle_stats_t *stats, char *line);
+static void show_perf_state(void);
+static void benchmark_power_modes(void);
+static void print_power_dist(const char *label, const power_bench_dist_t *dist, char *line);
+static void run_self_benchmark(void);
+#if APP_CONFIG_TRACE
+static void dump_trace(void);
+#endif
+#if APP_CONFIG_TEXT_FORMAT
+static uint32_t self_bench_formatter(void);
+#endif
+static uint32_t self_bench_validate(void);
+static uint32_t self_bench_nmea(void);
+static uint32_t self_bench_to_epoch(void);
+static uint32_t self_bench_from_epoch(void);
+static uint32_t self_bench_snapshot(void);
+static uint32_t self_bench_dst(void);
+static void print_summary(const ts_store_summary_t *summary, void *context);
+static void print_event_record(const event_log_record_t *record, void *context);
+static void show_event_buckets(const char *label,
+                               event_rollup_granularity_t granularity,
+                               uint32_t count);
+static cy_rslt_t user_uart_getc(uint8_t *value, uint32_t timeout);
+static cy_rslt_t user_uart_getc_until(uint8_t *value, uint32_t deadline);
+static uint32_t input_deadline(uint32_t timeout_ms);
+
+static bool validate_date_time(int sec, int min, int hour, int mday,
+                                    int month, int year);
+#endif
+
+#if APP_CONFIG_DST_UI
+static void save_dst_config(const cy_stc_rtc_dst_t *dst_time);
+static void set_dst_feature(uint32_t timeout_ms);
+#endif
+
+
+/*******************************************************************************
+* Function Name: handle_error
+********************************************************************************
+* Summary:
+* User defined error handling function. The fault is recorded and a warm
+* reset brings the console back with the RTC and the configuration
+* preserved. If the faults repeat without a stable run, the function halts.
+* The pending messages are only sent after the fault has been recorded, and
+* for a bounded time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void handle_error(void)
+{
+    /* Disable all interrupts. */
+    __disable_irq();
+
+    /* Record the failure and perform a warm reset; returns only if the
+     * recovery gave up */
+    fault_recovery_reset(RESET_CAUSE_APP_ERROR);
+
+    /* Send out the pending messages before halting */
+    (void)user_uart_flush();
+
+    CY_ASSERT(0);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   This function:
+*  - Initializes the device and board peripherals
+*  - Initializes RTC, or keeps it running after a fault recovery
+*  - Runs the event loop, which processes the user commands when they are
+*    received and sleeps in between
+*
+* Parameters :
+*  void
+*
+* Return:
+*  int
+*
+*******************************************************************************/
+int main(void)
+{
+    cy_rslt_t result;
+    cy_en_rtc_status_t rtcSta;
+    cy_stc_rtc_config_t dateTime;
+    uint32_t channel;
+
+    cy_en_scb_uart_status_t uartSta;
+
+#if APP_CONFIG_TEXT_FORMAT
+    app_arena_mark_t mark;
+    char *line;
+#endif
+    bool warm_boot;
+    uint32_t boot_cycles;
+
+    /* Check whether this boot follows a warm reset from handle_error() */
+    warm_boot = fault_recovery_init();
+
+    /* Initialize the device and board peripherals */
+    result = cybsp_init();
+    if (result != CY_RSLT_SUCCESS)
+        {
+            handle_error();
+        }
+
+    /* Time the recovery from the end of the clock setup */
+    cycle_count_init();
+    boot_cycles = cycle_count_get();
+
+    /* Initialize the USER_UART */
+    uartSta = user_uart_init();
+    if (uartSta!=CY_SCB_UART_SUCCESS)
+       {
+            handle_error();
+       }
+
+    if (!warm_boot)
+    {
+        /* Transmit header to the terminal */
+        /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+        user_uart_puts("\x1b[2J\x1b[;H");
+
+        user_uart_puts("************************************************************\r\n");
+        user_uart_puts("PDL: RTC Basics\r\n");
+        user_uart_puts("************************************************************\r\n\n");
+    }
+
+    /* Initialize the USER_RTC */
+    rtcSta = rtc_init(warm_boot);
+    if (rtcSta != CY_RTC_SUCCESS)
+    {
+        handle_error();
+    }
+
+    /* Start the shadow time from the design default */
+    Cy_RTC_GetDateAndTime(&dateTime);
+    timekeeping_init(time_utils_to_epoch(&dateTime));
+    discipline_init(time_utils_to_epoch(&dateTime));
+    gps_time_init();
+    holdover_init();
+
+    /* Record why the previous run ended */
+    reset_log_init();
+    event_log_init(warm_boot);
+
+    /* Post the per-second processing from the RTC interrupt */
+    rtcSta = rtc_tick_init(on_rtc_tick);
+    if (rtcSta != CY_RTC_SUCCESS)
+    {
+        handle_error();
+    }
+
+    /* Sample the sensors on RTC second and minute boundaries */
+    ts_store_init(&sensor_store);
+    sampler_init();
+    for (channel = 0u; channel < (sizeof(sampler_channels) / sizeof(sampler_channels[0])); channel++)
+    {
+        (void)sampler_configure(channel, &sampler_channels[channel]);
+    }
+
+    /* Lower the CPU clock while the console is quiet; the loop, the sampler
+     * and the GPS time source time their events with the cycle counter */
+    perf_state_init();
+    (void)perf_state_add_listener(discipline_clock_changed);
+    (void)perf_state_add_listener(sampler_clock_changed);
+    (void)perf_state_add_listener(gps_time_clock_changed);
+#if APP_CONFIG_TRACE
+    (void)perf_state_add_listener(trace_clock_changed);
+#endif
+
+    /* Run the console from the UART RX interrupt */
+    user_uart_set_rx_handler(on_uart_rx);
+
+    if (warm_boot)
+    {
+        restore_config();
+    }
+
+    /* Enable global interrupts */
+        __enable_irq();
+
+#if APP_CONFIG_MENUS
+    /*Show the RTC commands*/
+    user_uart_puts("Available commands\r\n");
+    user_uart_puts("1 : Set new time and date\r\n");
+#if APP_CONFIG_DST_UI
+    user_uart_puts("2 : Configure DST feature\r\n");
+#endif
+    user_uart_puts("3 : Show event counters\r\n");
+    user_uart_puts("4 : Configure flow control\r\n");
+    user_uart_puts("5 : Benchmark RTC read\r\n");
+    user_uart_puts("6 : Show reset history\r\n");
+    user_uart_puts("7 : GPS time source\r\n");
+    user_uart_puts("8 : Adjust time gradually\r\n");
+    user_uart_puts("9 : Query event log\r\n");
+    user_uart_puts("a : Show sampling statistics\r\n");
+    user_uart_puts("b : Benchmark code placement\r\n");
+    user_uart_puts("c : Show performance states\r\n");
+    user_uart_puts("d : Benchmark power modes\r\n");
+    user_uart_puts("e : Run self-benchmark\r\n");
+    user_uart_puts("f : Send statistics as JSON\r\n");
+    user_uart_puts("g : Send statistics as CBOR\r\n");
+#if APP_CONFIG_TRACE
+    user_uart_puts("h : Dump execution trace\r\n");
+#endif
+    user_uart_puts("\n");
+#endif
+
+    if (warm_boot)
+    {
+        fault_recovery_set_ready_time((cycle_count_get() - boot_cycles) /
+                                      (SystemCoreClock / 1000000u));
+#if APP_CONFIG_TEXT_FORMAT
+        mark = app_arena_mark();
+        line = app_arena_alloc(STRING_BUFFER_SIZE);
+        if (NULL != line)
+        {
+            snprintf(line, STRING_BUFFER_SIZE, "Recovered from a fault, console ready in %lu us\r\n\n",
+                     (unsigned long)fault_recovery_ready_time());
+            user_uart_puts(line);
+        }
+        app_arena_release(mark);
+#else
+        user_uart_puts("Recovered from a fault\r\n\n");
+#endif
+    }
+
+    event_rollup_init(&command_rollup);
+
+    /* Run the work posted by the RTC and UART interrupts; sleeps when there
+     * is nothing to do and does not return */
+    reactor_run();
+}
+
+/*******************************************************************************
+* Function Name: on_uart_rx
+********************************************************************************
+* Summary:
+*  Work item posted by the USER_UART interrupt when bytes have been received.
+*  Processes the commands received from the terminal and passes the NMEA
+*  sentences to the GPS time source.
+*
+* Parameter:
+*  uint32_t arg : Unused
+*
+* Return:
+*  void
+*******************************************************************************/
+static void on_uart_rx(uint32_t arg)
+{
+    static bool nmea_line = false;
+    uint8_t cmd = 0;
+    bool console;
+    uint32_t start_cycles = 0u;
+    uint32_t start_tick = 0u;
+
+    (void)arg;
+
+    while (user_uart_read_byte(&cmd))
+    {
+       /* Run the commands at full speed. Line ends are not commands; they
+        * also end the NMEA sentences. */
+       console = (!nmea_line) && ('$' != cmd) && ('\r' != cmd) && ('\n' != cmd);
+       if (console)
+       {
+          perf_state_activity();
+          start_cycles = cycle_count_get();
+          start_tick = rtc_tick_count();
+          trace_record(TRACE_EVENT_COMMAND_BEGIN, cmd);
+       }
+
+       /* A GPS receiver connected to the USER_UART sends NMEA sentences */
+       if (nmea_line || ('$' == cmd))
+       {
+          nmea_line = (('\r' != cmd) && ('\n' != cmd));
+          gps_time_feed_at((char)cmd, user_uart_rx_cycles());
+       }
+       /* The statistics are also sent without the menus, for the
+        * monitoring scripts */
+       else if ((RTC_CMD_STATS_JSON == cmd) || (RTC_CMD_STATS_CBOR == cmd))
+       {
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, cmd);
+          user_uart_puts("\r[Command] : Send statistics              \r\n");
+          send_stats((RTC_CMD_STATS_CBOR == cmd) ? DOC_FORMAT_CBOR : DOC_FORMAT_JSON);
+          cmd = 0;
+       }
+#if APP_CONFIG_MENUS
+       else if(RTC_CMD_SET_DATE_TIME == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_SET_DATE_TIME);
+          user_uart_puts("\r[Command] : Set new time              \r\n");
+          set_new_time(INPUT_TIMEOUT_MS);
+
+       }
+#if APP_CONFIG_DST_UI
+       else if (RTC_CMD_CONFIG_DST == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_CONFIG_DST);
+          user_uart_puts("\r[Command] : Configure DST feature              \r\n");
+          set_dst_feature(INPUT_TIMEOUT_MS);
+
+       }
+#endif
+       else if (RTC_CMD_SHOW_EVENTS == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_SHOW_EVENTS);
+          user_uart_puts("\r[Command] : Show event counters              \r\n");
+          show_event_counters();
+       }
+       else if (RTC_CMD_FLOW_CONTROL == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_FLOW_CONTROL);
+          user_uart_puts("\r[Command] : Configure flow control              \r\n");
+          configure_flow_control(INPUT_TIMEOUT_MS);
+       }
+       else if (RTC_CMD_BENCH_RTC_READ == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_BENCH_RTC_READ);
+          user_uart_puts("\r[Command] : Benchmark RTC read              \r\n");
+          benchmark_rtc_read();
+       }
+       else if (RTC_CMD_RESET_HISTORY == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_RESET_HISTORY);
+          user_uart_puts("\r[Command] : Show reset history              \r\n");
+          show_reset_history();
+       }
+       else if (RTC_CMD_GPS_TIME == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_GPS_TIME);
+          user_uart_puts("\r[Command] : GPS time source              \r\n");
+          configure_gps_time(INPUT_TIMEOUT_MS);
+       }
+       else if (RTC_CMD_ADJUST_TIME == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_ADJUST_TIME);
+          user_uart_puts("\r[Command] : Adjust time gradually              \r\n");
+          adjust_time(INPUT_TIMEOUT_MS);
+       }
+       else if (RTC_CMD_EVENT_LOG == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_EVENT_LOG);
+          user_uart_puts("\r[Command] : Query event log              \r\n");
+          query_event_log(INPUT_TIMEOUT_MS);
+       }
+       else if (RTC_CMD_SAMPLER == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_SAMPLER);
+          user_uart_puts("\r[Command] : Show sampling statistics              \r\n");
+          show_sampler();
+       }
+       else if (RTC_CMD_BENCH_PLACEMENT == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_BENCH_PLACEMENT);
+          user_uart_puts("\r[Command] : Benchmark code placement              \r\n");
+          benchmark_code_placement();
+       }
+       else if (RTC_CMD_PERF_STATE == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_PERF_STATE);
+          user_uart_puts("\r[Command] : Show performance states              \r\n");
+          show_perf_state();
+       }
+       else if (RTC_CMD_BENCH_POWER == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_BENCH_POWER);
+          user_uart_puts("\r[Command] : Benchmark power modes              \r\n");
+          benchmark_power_modes();
+       }
+       else if (RTC_CMD_SELF_BENCH == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_SELF_BENCH);
+          user_uart_puts("\r[Command] : Run self-benchmark              \r\n");
+          run_self_benchmark();
+       }
+#if APP_CONFIG_TRACE
+       else if (RTC_CMD_DUMP_TRACE == cmd)
+       {
+          cmd = 0;
+          event_rollup_add(&command_rollup, 1u);
+          event_log_add(EVENT_LOG_COMMAND, RTC_CMD_DUMP_TRACE);
+          user_uart_puts("\r[Command] : Dump execution trace              \r\n");
+          dump_trace();
+       }
+#endif
+#endif
+
+       /* The idle delay starts when the command is done */
+       if (console)
+       {
+          trace_record(TRACE_EVENT_COMMAND_END, 0u);
+          if (0u == cmd)
+          {
+             record_command_time(start_cycles, start_tick);
+          }
+          perf_state_activity();
+       }
+    }
+}
+
+/*******************************************************************************
+* Function Name: on_rtc_tick
+********************************************************************************
+* Summary:
+*  Work item posted by the RTC interrupt once per second. Advances the served
+*  time of the discipline loop and updates the shadow time, the holdover,
+*  the reset log and the event buckets, then shows the time on the terminal
+*  and runs the NMEA generator. Ticks that queue up while a command
+*  runs are merged into one.
+*
+* Parameter:
+*  uint32_t tick : Tick count at the time of the post
+*
+* Return:
+*  void
+*******************************************************************************/
+static void on_rtc_tick(uint32_t tick)
+{
+    cy_stc_rtc_config_t dateTime;
+    time_reading_t reading;
+#if APP_CONFIG_TEXT_FORMAT
+    app_arena_mark_t mark;
+    char *line;
+#endif
+    uint32_t epoch;
+
+    /* The served time follows the RTC with the slewed correction */
+    Cy_RTC_GetDateAndTime(&dateTime);
+    epoch = discipline_on_tick(time_utils_to_epoch(&dateTime));
+    timekeeping_on_tick(epoch);
+    holdover_on_tick(epoch);
+    timekeeping_get(&reading);
+    reset_log_on_tick(reading.epoch);
+    fault_recovery_on_tick(reset_log_uptime());
+    event_rollup_advance(&command_rollup, reading.epoch);
+
+#if APP_CONFIG_TEXT_FORMAT
+    /* The status line shows the served time, which can be a second away
+     * from the RTC until the correction is folded into it */
+    time_utils_from_epoch(epoch, &dateTime);
+    mark = app_arena_mark();
+    line = app_arena_alloc(STRING_BUFFER_SIZE);
+    if (NULL != line)
+    {
+        convert_date_to_string(&dateTime, TIME_QUALITY_STATE(reading.quality),
+                               line, STRING_BUFFER_SIZE);
+        /* The status line is skipped if the terminal does not keep up */
+        (void)user_uart_try_puts(line);
+    }
+    app_arena_release(mark);
+#endif
+
+#if APP_CONFIG_MENUS
+    /* The NMEA generator is started from the menu */
+    nmea_sim_on_tick();
+#endif
+
+    /* Lower the clock once the console is quiet */
+    perf_state_on_tick(tick);
+}
+
+/*******************************************************************************
+* Function Name: rtc_init
+********************************************************************************
+* Summary:
+*  This functions implement the USER_RTC initialize. After a warm reset the
+*  RTC is still running with the correct time and is left untouched.
+*
+* Parameter:
+*  bool warm_boot : true if this boot is a fault recovery
+*
+*
+* Return:
+*  void
+*******************************************************************************/
+static cy_en_rtc_status_t rtc_init(bool warm_boot)
+{
+    uint32_t attempts = MAX_ATTEMPTS;
+    cy_en_rtc_status_t rtc_result;
+
+    if (warm_boot)
+    {
+        return CY_RTC_SUCCESS;
+    }
+
+    /* Setting the time and date can fail. For example the RTC might be busy.
+       Check the result and try again, if necessary.  */
+    do
+    {
+        rtc_result = Cy_RTC_Init(&USER_RTC_config);
+        attempts--;
+
+        Cy_SysLib_Delay(INIT_DELAY_MS);
+    } while(( rtc_result != CY_RTC_SUCCESS) && (attempts != 0u));
+
+    rtc_tick_add_retries(MAX_ATTEMPTS - attempts - 1u);
+
+    return (rtc_result);
+
+}
+
+/*******************************************************************************
+* Function Name: restore_config
+********************************************************************************
+* Summary:
+*  Restores the configuration kept across a warm reset: DST rules, time
+*  quality state with the time of the last sync, the discipline loop and
+*  UART flow control.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void restore_config(void)
+{
+    fault_recovery_config_t *config = fault_recovery_config();
+    cy_stc_rtc_config_t dateTime;
+
+    if (DST_ENABLED_FLAG == config->dst_flag)
+    {
+        Cy_RTC_GetDateAndTime(&dateTime);
+        if (CY_RTC_SUCCESS == Cy_RTC_EnableDstTime(&config->dst_time, &dateTime))
+        {
+            dst_data_flag = DST_ENABLED_FLAG;
+            rtc_tick_set_dst(&config->dst_time, true);
+        }
+    }
+
+    timekeeping_restore((time_quality_state_t)config->quality_state, config->last_sync_epoch);
+    discipline_restore(&config->discipline);
+    holdover_restore(config->last_sync_epoch);
+    user_uart_set_flow_control(config->cts_enabled, config->rts_level);
+}
+
+#if APP_CONFIG_DST_UI
+/*******************************************************************************
+* Function Name: save_dst_config
+********************************************************************************
+* Summary:
+*  Keeps the DST state and rules so that they can be restored after a warm
+*  reset, and hands the kept copy to the RTC interrupt for the DST switch.
+*
+* Parameter:
+*  const cy_stc_rtc_dst_t *dst_time : DST rules written to the RTC
+*
+* Return:
+*  void
+*******************************************************************************/
+static void save_dst_config(const cy_stc_rtc_dst_t *dst_time)
+{
+    fault_recovery_config_t *config = fault_recovery_config();
+
+    config->dst_flag = dst_data_flag;
+    config->dst_time = *dst_time;
+    fault_recovery_save();
+
+    rtc_tick_set_dst(&config->dst_time, (DST_ENABLED_FLAG == dst_data_flag));
+}
+
+#endif
+
+#if APP_CONFIG_MENUS
+/*******************************************************************************
+* Function Name: user_uart_getc
+********************************************************************************
+* Summary:
+*  This functions get the USER_UART input value from terminal. The bytes are
+*  taken from the RX queue filled by the USER_UART interrupt.
+*
+* Parameter:
+*  uint8_t *value : the USER_UART input value from terminal
+*  uint32_t timeout: UART timeout in milliseconds, rounded up to RTC seconds
+*  function
+*
+* Return:
+*  Returns the status of the getc request
+*******************************************************************************/
+cy_rslt_t user_uart_getc(uint8_t *value, uint32_t timeout)
+{
+    return user_uart_getc_until(value, input_deadline(timeout));
+}
+
+/*******************************************************************************
+* Function Name: user_uart_getc_until
+********************************************************************************
+* Summary:
+*  Waits for a byte from the terminal until the RTC tick count reaches the
+*  deadline. The CPU sleeps while waiting and is woken up by the USER_UART
+*  interrupt or by the RTC tick.
+*
+* Parameter:
+*  uint8_t *value    : the USER_UART input value from terminal
+*  uint32_t deadline : RTC tick count at which the wait ends
+*
+* Return:
+*  Returns the status of the getc request
+*******************************************************************************/
+static cy_rslt_t user_uart_getc_until(uint8_t *value, uint32_t deadline)
+{
+    uint32_t interruptState;
+
+    while (!user_uart_read_byte(value))
+    {
+        if ((int32_t)(rtc_tick_count() - deadline) >= 0)
+        {
+            return CY_SCB_UART_RX_NO_DATA;
+        }
+
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        if (!user_uart_rx_pending())
+        {
+            reactor_sleep();
+        }
+        Cy_SysLib_ExitCriticalSection(interruptState);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: input_deadline
+********************************************************************************
+* Summary:
+*  Converts a timeout into an RTC tick deadline. One tick is added because
+*  the current second may be almost over.
+*
+* Parameter:
+*  uint32_t timeout_ms : Timeout in milliseconds
+*
+* Return:
+*  uint32_t : RTC tick count at which the timeout expires
+*******************************************************************************/
+static uint32_t input_deadline(uint32_t timeout_ms)
+{
+    return rtc_tick_count() + ((timeout_ms + MS_PER_SECOND - 1u) / MS_PER_SECOND) + 1u;
+}
+
+
+#endif
+
+#if APP_CONFIG_TEXT_FORMAT
+/*******************************************************************************
+* Function Name: put_text
+********************************************************************************
+* Summary:
+*  Appends a string to a line, as far as it fits with its terminating NUL.
+*  Inlined in format_date().
+*
+* Parameter:
+*  char *line       : Destination of the string
+*  size_t size      : Size of the destination in bytes, not 0
+*  size_t pos       : Length of the line so far
+*  const char *text : String to append
+*
+* Return:
+*  size_t : Length of the line
+*******************************************************************************/
+__STATIC_FORCEINLINE size_t put_text(char *line, size_t size, size_t pos, const char *text)
+{
+    while (('\0' != *text) && ((pos + 1u) < size))
+    {
+        line[pos] = *text;
+        pos++;
+        text++;
+    }
+
+    return pos;
+}
+
+/*******************************************************************************
+* Function Name: put_number
+********************************************************************************
+* Summary:
+*  Appends the decimal digits of a number to a line, as far as they fit with
+*  the terminating NUL. Inlined in format_date().
+*
+* Parameter:
+*  char *line     : Destination of the string
+*  size_t size    : Size of the destination in bytes, not 0
+*  size_t pos     : Length of the line so far
+*  uint32_t value : Number to append
+*
+* Return:
+*  size_t : Length of the line
+*******************************************************************************/
+__STATIC_FORCEINLINE size_t put_number(char *line, size_t size, size_t pos, uint32_t value)
+{
+    char digits[10];
+    uint32_t count = 0u;
+
+    do
+    {
+        digits[count] = (char)('0' + (value % 10u));
+        value /= 10u;
+        count++;
+    } while (0u != value);
+
+    while ((0u != count) && ((pos + 1u) < size))
+    {
+        count--;
+        line[pos] = digits[count];
+        pos++;
+    }
+
+    return pos;
+}
+
+/*******************************************************************************
+* Function Name: format_date
+********************************************************************************
+* Summary:
+*  This functions get the RTC time values from 'dateTime', convert the uint32_t
+*  values to chars, then combine all chars to one string and save in 'line'.
+*  The quality state of the time is appended. The digits are converted here,
+*  without the C library, and the function is inlined in the callers, so the
+*  whole formatter runs from the memory they are placed in.
+*
+* Parameter:
+*  cy_stc_rtc_config_t *dateTime : the RTC configure struct pointer
+*  time_quality_state_t quality  : Quality state of the time
+*  char *line                    : Destination of the string
+*  size_t size                   : Size of the destination in bytes
+*  function
+*
+* Return:
+*  void
+*******************************************************************************/
+__STATIC_FORCEINLINE void format_date(cy_stc_rtc_config_t *dateTime,
+                                      time_quality_state_t quality,
+                                      char *line, size_t size)
+{
+    size_t pos = 0u;
+
+    if (0u == size)
+    {
+        return;
+    }
+
+    /* Same text as "Mon %d Date %d    %d : %d : %d    %d Year [%s] \r" */
+    pos = put_text(line, size, pos, "Mon ");
+    pos = put_number(line, size, pos, dateTime->month);
+    pos = put_text(line, size, pos, " Date ");
+    pos = put_number(line, size, pos, dateTime->date);
+    pos = put_text(line, size, pos, "    ");
+    pos = put_number(line, size, pos, dateTime->hour);
+    pos = put_text(line, size, pos, " : ");
+    pos = put_number(line, size, pos, dateTime->min);
+    pos = put_text(line, size, pos, " : ");
+    pos = put_number(line, size, pos, dateTime->sec);
+    pos = put_text(line, size, pos, "    ");
+    pos = put_number(line, size, pos, dateTime->year);
+    pos = put_text(line, size, pos, " Year [");
+    pos = put_text(line, size, pos, timekeeping_state_name(quality));
+    pos = put_text(line, size, pos, "] \r");
+    line[pos] = '\0';
+}
+
+/*******************************************************************************
+* Function Name: convert_date_to_string
+********************************************************************************
+* Summary:
+*  Formats the status line printed every second, see format_date(). Runs
+*  from SRAM when APP_CONFIG_RAM_CODE is enabled.
+*
+* Parameter:
+*  cy_stc_rtc_config_t *dateTime : the RTC configure struct pointer
+*  time_quality_state_t quality  : Quality state of the time
+*  char *line                    : Destination of the string
+*  size_t size                   : Size of the destination in bytes
+*
+* Return:
+*  void
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+CY_NOINLINE static void convert_date_to_string(cy_stc_rtc_config_t *dateTime,
+                                               time_quality_state_t quality,
+                                               char *line, size_t size)
+{
+    format_date(dateTime, quality, line, size);
+}
+APP_RAMFUNC_END
+
+#if APP_CONFIG_MENUS
+/*******************************************************************************
+* Function Name: convert_date_to_string_flash
+********************************************************************************
+* Summary:
+*  Copy of convert_date_to_string() that always runs from flash, the
+*  reference of the code placement benchmark.
+*
+* Parameter:
+*  cy_stc_rtc_config_t *dateTime : the RTC configure struct pointer
+*  time_quality_state_t quality  : Quality state of the time
+*  char *line                    : Destination of the string
+*  size_t size                   : Size of the destination in bytes
+*
+* Return:
+*  void
+*******************************************************************************/
+CY_NOINLINE static void convert_date_to_string_flash(cy_stc_rtc_config_t *dateTime,
+                                                     time_quality_state_t quality,
+                                                     char *line, size_t size)
+{
+    format_date(dateTime, quality, line, size);
+}
+#endif
+
+#endif
+
+/*******************************************************************************
+* Function Name: record_command_time
+********************************************************************************
+* Summary:
+*  Adds the duration of a console command to the command statistics.
+*
+* Parameter:
+*  uint32_t start_cycles : Cycle count when the command byte was read
+*  uint32_t start_tick   : RTC tick count when the command byte was read
+*
+* Return:
+*  void
+*******************************************************************************/
+static void record_command_time(uint32_t start_cycles, uint32_t start_tick)
+{
+    uint32_t ticks = rtc_tick_count() - start_tick;
+    uint32_t duration_us;
+
+    if (ticks < COMMAND_CYCLES_MAX_S)
+    {
+        duration_us = (cycle_count_get() - start_cycles) / (SystemCoreClock / US_PER_SECOND);
+    }
+    else
+    {
+        duration_us = ((uint64_t)ticks * US_PER_SECOND > UINT32_MAX) ?
+                      UINT32_MAX : (ticks * US_PER_SECOND);
+    }
+
+    command_count++;
+    command_total_us += duration_us;
+    if (duration_us > command_max_us)
+    {
+        command_max_us = duration_us;
+    }
+}
+
+/*******************************************************************************
+* Function Name: send_stats
+********************************************************************************
+* Summary:
+*  Sends the statistics as one machine-readable document, encoded while it is
+*  written to the UART TX queue. A JSON document is one line. A CBOR document
+*  starts with the self-describe tag D9 D9 F7 and ends with its last map;
+*  the line end that follows is not part of it.
+*
+* Parameter:
+*  doc_format_t format : JSON or CBOR
+*
+* Return:
+*  void
+*******************************************************************************/
+static void send_stats(doc_format_t format)
+{
+    fault_recovery_config_t *config = fault_recovery_config();
+    doc_encoder_t enc;
+    user_uart_tx_stats_t tx;
+    user_uart_rx_stats_t rx;
+    work_queue_stats_t work;
+    reactor_stats_t load;
+    holdover_stats_t holdover;
+    discipline_stats_t loop;
+    time_reading_t reading;
+    cy_stc_rtc_config_t dateTime;
+    bool dst_enabled = (DST_ENABLED_FLAG == dst_data_flag);
+
+    user_uart_get_tx_stats(&tx);
+    user_uart_get_rx_stats(&rx);
+    work_queue_get_stats(&work);
+    reactor_get_stats(&load);
+    holdover_get_stats(&holdover);
+    discipline_get_stats(&loop);
+    timekeeping_get(&reading);
+    Cy_RTC_GetDateAndTime(&dateTime);
+
+    doc_encoder_begin(&enc, format, user_uart_write);
+    doc_encoder_uint(&enc, "uptime_s", rtc_tick_count());
+
+    (void)doc_encoder_map_begin(&enc, "uart");
+    doc_encoder_uint(&enc, "tx_bytes", tx.bytes);
+    doc_encoder_uint(&enc, "tx_stalls", tx.stall_count);
+    doc_encoder_uint(&enc, "tx_dropped", tx.dropped_writes);
+    doc_encoder_uint(&enc, "tx_flush_timeouts", tx.flush_timeouts);
+    doc_encoder_uint(&enc, "rx_bytes", rx.bytes);
+    doc_encoder_uint(&enc, "rx_errors", rx.errors);
+    doc_encoder_uint(&enc, "rx_dropped", rx.dropped);
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_map_begin(&enc, "commands");
+    doc_encoder_uint(&enc, "count", command_count);
+    doc_encoder_uint(&enc, "avg_us", (0u != command_count) ?
+                     (uint32_t)(command_total_us / command_count) : 0u);
+    doc_encoder_uint(&enc, "max_us", command_max_us);
+    doc_encoder_uint(&enc, "queue_avg_cycles", (work.executed > work.long_waits) ?
+                     (uint32_t)(work.total_latency / (work.executed - work.long_waits)) : 0u);
+    doc_encoder_uint(&enc, "queue_max_cycles", work.max_latency);
+    doc_encoder_uint(&enc, "queue_long_waits", work.long_waits);
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_map_begin(&enc, "loop");
+    doc_encoder_uint(&enc, "busy_permille", load.load);
+    doc_encoder_uint(&enc, "idle_permille", 1000u - load.load);
+    doc_encoder_uint(&enc, "peak_busy_permille", load.peak_load);
+    doc_encoder_uint(&enc, "wakeups_per_s", load.wakeups);
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_map_begin(&enc, "rtc");
+    doc_encoder_uint(&enc, "retries", rtc_tick_retries());
+    doc_encoder_string(&enc, "quality",
+                       timekeeping_state_name(TIME_QUALITY_STATE(reading.quality)));
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_map_begin(&enc, "drift");
+    doc_encoder_bool(&enc, "learned", holdover.drift_learned);
+    doc_encoder_int(&enc, "estimate_dppm", holdover.drift_dppm);
+    doc_encoder_bool(&enc, "locked", loop.locked);
+    doc_encoder_int(&enc, "correction_ppb", loop.freq_ppb);
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_map_begin(&enc, "dst");
+    doc_encoder_bool(&enc, "enabled", dst_enabled);
+    doc_encoder_bool(&enc, "active", dst_enabled &&
+                     Cy_RTC_GetDstStatus(&config->dst_time, &dateTime));
+    doc_encoder_map_end(&enc);
+
+    (void)doc_encoder_end(&enc);
+    user_uart_puts("\r\n\n");
+}
+
+#if APP_CONFIG_MENUS
+/*******************************************************************************
+* Function Name: show_event_buckets
+********************************************************************************
+* Summary:
+*  Prints the newest 'count' buckets of one granularity of the command
+*  counters on a single line, newest first. Nothing is printed if the
+*  buckets do not fit into the scratch arena.
+*
+* Parameter:
+*  const char *label                      : Line prefix
+*  event_rollup_granularity_t granularity : Granularity to print
+*  uint32_t count                         : Number of buckets to print
+*
+* Return:
+*  void
+*******************************************************************************/
+static void show_event_buckets(const char *label,
+                               event_rollup_granularity_t granularity,
+                               uint32_t count)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    uint32_t *totals = app_arena_alloc(count * sizeof(uint32_t));
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    uint32_t i;
+    int len;
+
+    if ((NULL != totals) && (NULL != line))
+    {
+        count = event_rollup_get_last(&command_rollup, granularity, count, totals);
+
+        len = snprintf(line, STRING_BUFFER_SIZE, "%s", label);
+        for (i = 0u; (i < count) && (len < (int)STRING_BUFFER_SIZE); i++)
+        {
+            len += snprintf(&line[len], STRING_BUFFER_SIZE - (size_t)len, " %lu",
+                            (unsigned long)totals[i]);
+        }
+
+        user_uart_puts(line);
+        user_uart_puts("\r\n");
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: show_event_counters
+********************************************************************************
+* Summary:
+*  Prints the number of console commands received per minute, per hour and
+*  per day. The values are served from the RAM buckets, newest first.
+*  Also prints the high-water mark of the scratch arena.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void show_event_counters(void)
+{
+    app_arena_mark_t mark;
+    char *line;
+    work_queue_stats_t work_stats;
+    reactor_stats_t load_stats;
+
+    user_uart_puts("Commands received (newest first)\r\n");
+    show_event_buckets("Minutes :", EVENT_ROLLUP_MINUTE, EVENT_SHOW_MINUTES);
+    show_event_buckets("Hours   :", EVENT_ROLLUP_HOUR, EVENT_SHOW_HOURS);
+    show_event_buckets("Days    :", EVENT_ROLLUP_DAY, EVENT_SHOW_DAYS);
+
+    mark = app_arena_mark();
+    line = app_arena_alloc(STRING_BUFFER_SIZE);
+    if (NULL != line)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Scratch arena high-water : %lu of %lu bytes\r\n",
+                 (unsigned long)app_arena_high_water(), (unsigned long)APP_ARENA_SIZE);
+        user_uart_puts(line);
+
+        work_queue_get_stats(&work_stats);
+        snprintf(line, STRING_BUFFER_SIZE, "Work items : %lu posted, %lu merged, %lu dropped\r\n",
+                 (unsigned long)work_stats.posted, (unsigned long)work_stats.coalesced,
+                 (unsigned long)work_stats.dropped);
+        user_uart_puts(line);
+
+        snprintf(line, STRING_BUFFER_SIZE, "Work latency : avg %lu, max %lu cycles, max depth %lu\r\n",
+                 (unsigned long)((work_stats.executed > work_stats.long_waits) ?
+                                 (work_stats.total_latency /
+                                  (work_stats.executed - work_stats.long_waits)) : 0u),
+                 (unsigned long)work_stats.max_latency, (unsigned long)work_stats.max_depth);
+        user_uart_puts(line);
+
+        snprintf(line, STRING_BUFFER_SIZE, "Work waits over one RTC tick : %lu\r\n",
+                 (unsigned long)work_stats.long_waits);
+        user_uart_puts(line);
+
+        reactor_get_stats(&load_stats);
+        snprintf(line, STRING_BUFFER_SIZE, "CPU load : %lu.%lu %% (peak %lu.%lu %%), %lu wakeups/s\r\n\n",
+                 (unsigned long)(load_stats.load / 10u), (unsigned long)(load_stats.load % 10u),
+                 (unsigned long)(load_stats.peak_load / 10u),
+                 (unsigned long)(load_stats.peak_load % 10u),
+                 (unsigned long)load_stats.wakeups);
+        user_uart_puts(line);
+    }
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: configure_flow_control
+********************************************************************************
+* Summary:
+*  Shows the TX flow control statistics and sets a new RTS trigger level.
+*  A level of 0 disables RTS/CTS flow control, any other level enables both
+*  RTS and CTS.
+*
+* Parameter:
+*  uint32_t timeout_ms : Maximum allowed time (in milliseconds) for the
+*  function
+*
+* Return:
+*  void
+*******************************************************************************/
+static void configure_flow_control(uint32_t timeout_ms)
+{
+    cy_rslt_t rslt;
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    char *level_buffer = app_arena_alloc(STRING_BUFFER_SIZE);
+    uint32_t space_count;
+    user_uart_tx_stats_t stats;
+    int level = -1;
+
+    if ((NULL == line) || (NULL == level_buffer))
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    user_uart_get_tx_stats(&stats);
+    snprintf(line, STRING_BUFFER_SIZE, "CTS : %s, RTS level : %lu\r\n",
+             stats.cts_enabled ? "on" : "off", (unsigned long)stats.rts_level);
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "TX stalls : %lu (%lu cycles), skipped lines : %lu\r\n",
+             (unsigned long)stats.stall_count, (unsigned long)stats.stall_cycles,
+             (unsigned long)stats.dropped_writes);
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "TX flush timeouts : %lu\r\n\n",
+             (unsigned long)stats.flush_timeouts);
+    user_uart_puts(line);
+
+    user_uart_puts("Enter RTS trigger level (0 : flow control off, 1-63 : on)\r\n");
+    rslt = fetch_time_data(level_buffer, timeout_ms, &space_count);
+    if (rslt != CY_SCB_UART_RX_NO_DATA)
+    {
+        if ((1 == sscanf(level_buffer, "%d", &level)) &&
+            (level >= 0) && ((uint32_t)level <= MAX_RTS_LEVEL))
+        {
+            user_uart_set_flow_control(0 != level, (uint32_t)level);
+            user_uart_puts("\rFlow control updated\r\n\n");
+        }
+        else
+        {
+            user_uart_puts("\rInvalid value!\r\n\n");
+        }
+    }
+    else
+    {
+        user_uart_puts("\rTimeout \r\n");
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: benchmark_rtc_read
+********************************************************************************
+* Summary:
+*  Measures the average cost in CPU cycles of Cy_RTC_GetDateAndTime(), of the
+*  raw snapshot read and of the snapshot decoding, and prints the results.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void benchmark_rtc_read(void)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    cy_stc_rtc_config_t dateTime;
+    rtc_snapshot_t snapshot;
+    uint32_t pdl_cycles;
+    uint32_t snapshot_cycles;
+    uint32_t decode_cycles;
+    uint32_t start;
+    uint32_t i;
+
+    start = cycle_count_get();
+    for (i = 0u; i < RTC_BENCH_ITERATIONS; i++)
+    {
+        Cy_RTC_GetDateAndTime(&dateTime);
+    }
+    pdl_cycles = (cycle_count_get() - start) / RTC_BENCH_ITERATIONS;
+
+    start = cycle_count_get();
+    for (i = 0u; i < RTC_BENCH_ITERATIONS; i++)
+    {
+        rtc_snapshot_read(&snapshot);
+    }
+    snapshot_cycles = (cycle_count_get() - start) / RTC_BENCH_ITERATIONS;
+
+    start = cycle_count_get();
+    for (i = 0u; i < RTC_BENCH_ITERATIONS; i++)
+    {
+        rtc_snapshot_decode(&snapshot, &dateTime);
+    }
+    decode_cycles = (cycle_count_get() - start) / RTC_BENCH_ITERATIONS;
+
+    if (NULL != line)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Cy_RTC_GetDateAndTime : %lu cycles\r\n",
+                 (unsigned long)pdl_cycles);
+        user_uart_puts(line);
+        snprintf(line, STRING_BUFFER_SIZE, "rtc_snapshot_read     : %lu cycles\r\n",
+                 (unsigned long)snapshot_cycles);
+        user_uart_puts(line);
+        snprintf(line, STRING_BUFFER_SIZE, "rtc_snapshot_decode   : %lu cycles\r\n\n",
+                 (unsigned long)decode_cycles);
+        user_uart_puts(line);
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: show_reset_history
+********************************************************************************
+* Summary:
+*  Prints the reset records kept in the backup registers, most recent first:
+*  cause, RTC time of the reset and uptime before the reset.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void show_reset_history(void)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    reset_record_t record;
+    cy_stc_rtc_config_t dateTime;
+    uint32_t i;
+
+    if (NULL != line)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Uptime : %lu s, %lu reset records\r\n",
+                 (unsigned long)reset_log_uptime(), (unsigned long)reset_log_count());
+        user_uart_puts(line);
+        snprintf(line, STRING_BUFFER_SIZE, "Warm recoveries : %lu, last console ready in %lu us\r\n",
+                 (unsigned long)fault_recovery_count(),
+                 (unsigned long)fault_recovery_ready_time());
+        user_uart_puts(line);
+
+        for (i = 0u; reset_log_get(i, &record); i++)
+        {
+            time_utils_from_epoch(record.epoch, &dateTime);
+            snprintf(line, STRING_BUFFER_SIZE,
+                     "%lu : %-9s at %02lu/%02lu/%02lu %02lu:%02lu:%02lu after %lu s\r\n",
+                     (unsigned long)i, reset_log_cause_name(record.cause),
+                     (unsigned long)dateTime.month, (unsigned long)dateTime.date,
+                     (unsigned long)dateTime.year, (unsigned long)dateTime.hour,
+                     (unsigned long)dateTime.min, (unsigned long)dateTime.sec,
+                     (unsigned long)record.uptime);
+            user_uart_puts(line);
+        }
+
+        user_uart_puts("\r\n");
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: configure_gps_time
+********************************************************************************
+* Summary:
+*  Shows the statistics of the GPS time source: sentences, offset of the RTC
+*  from the reference, and parse cost. Starts or stops the NMEA generator
+*  that stands in for a GPS receiver.
+*
+* Parameter:
+*  uint32_t timeout_ms : Maximum allowed time (in milliseconds) for the
+*  function
+*
+* Return:
+*  void
+*******************************************************************************/
+static void configure_gps_time(uint32_t timeout_ms)
+{
+    cy_rslt_t rslt;
+    uint8_t gps_cmd = 0;
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    gps_time_stats_t stats;
+    discipline_stats_t loop;
+    holdover_stats_t holdover;
+    time_reading_t reading;
+    uint32_t bound;
+    uint32_t drift;
+    cy_stc_rtc_config_t dateTime;
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    gps_time_get_stats(&stats);
+    snprintf(line, STRING_BUFFER_SIZE, "Sentences : %lu, fixes : %lu, errors : %lu checksum, %lu format\r\n",
+             (unsigned long)stats.sentences, (unsigned long)stats.fixes,
+             (unsigned long)stats.checksum_errors, (unsigned long)stats.format_errors);
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "Offset : last %ld ms (fix at .%03lu), max %lu ms\r\n",
+             (long)stats.last_offset_ms, (unsigned long)stats.last_millis,
+             (unsigned long)stats.max_offset_ms);
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "Slewed fixes : %lu, steps : %lu\r\n",
+             (unsigned long)stats.slewed_fixes, (unsigned long)stats.steps);
+    user_uart_puts(line);
+
+    discipline_get_stats(&loop);
+    snprintf(line, STRING_BUFFER_SIZE, "Loop : offset %ld us, jitter %lu us, freq %ld ppb, %s\r\n",
+             (long)(loop.last_offset_ns / 1000), (unsigned long)(loop.jitter_ns / 1000u),
+             (long)loop.freq_ppb, loop.locked ? "locked" : "unlocked");
+    user_uart_puts(line);
+    if (loop.ever_locked)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Lock time : %lu s\r\n", (unsigned long)loop.lock_time_s);
+        user_uart_puts(line);
+    }
+    snprintf(line, STRING_BUFFER_SIZE, "Parse cost : last %lu, avg %lu, max %lu cycles\r\n",
+             (unsigned long)stats.parse_cycles_last,
+             (unsigned long)((0u != stats.sentences) ?
+                             (stats.parse_cycles_total / stats.sentences) : 0u),
+             (unsigned long)stats.parse_cycles_max);
+    user_uart_puts(line);
+
+    holdover_get_stats(&holdover);
+    drift = (uint32_t)((holdover.drift_dppm < 0) ? -holdover.drift_dppm : holdover.drift_dppm);
+    snprintf(line, STRING_BUFFER_SIZE, "Drift : %s%lu.%lu ppm (%s), holdovers : %lu\r\n",
+             (holdover.drift_dppm < 0) ? "-" : "",
+             (unsigned long)(drift / 10u), (unsigned long)(drift % 10u),
+             holdover.drift_learned ? "learned" : "default",
+             (unsigned long)holdover.entries);
+    user_uart_puts(line);
+
+    timekeeping_get(&reading);
+    bound = holdover_error_bound_ms(reading.quality);
+    if (HOLDOVER_ERROR_BOUND_UNKNOWN != bound)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Time : %s, error bound %lu ms\r\n",
+                 timekeeping_state_name(TIME_QUALITY_STATE(reading.quality)),
+                 (unsigned long)bound);
+    }
+    else
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "Time : %s, error bound unknown\r\n",
+                 timekeeping_state_name(TIME_QUALITY_STATE(reading.quality)));
+    }
+    user_uart_puts(line);
+
+    user_uart_puts(nmea_sim_is_running() ? "NMEA generator : running\r\n\n" :
+                                           "NMEA generator : stopped\r\n\n");
+
+    user_uart_puts("1 : Start NMEA generator\r\n");
+    user_uart_puts("2 : Stop NMEA generator\r\n");
+    user_uart_puts("3 : Quit\r\n\n");
+
+    rslt = user_uart_getc(&gps_cmd, timeout_ms);
+    if (rslt != CY_SCB_UART_RX_NO_DATA)
+    {
+        if (RTC_CMD_START_NMEA_SIM == gps_cmd)
+        {
+            Cy_RTC_GetDateAndTime(&dateTime);
+            nmea_sim_start(time_utils_to_epoch(&dateTime) - (uint32_t)GPS_TIME_ZONE_OFFSET_S,
+                           NMEA_SIM_START_OFFSET_S);
+            user_uart_puts("\rNMEA generator started\r\n\n");
+        }
+        else if (RTC_CMD_STOP_NMEA_SIM == gps_cmd)
+        {
+            nmea_sim_stop();
+            user_uart_puts("\rNMEA generator stopped\r\n\n");
+        }
+    }
+    else
+    {
+        user_uart_puts("\rTimeout \r\n");
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: adjust_time
+********************************************************************************
+* Summary:
+*  Shows the adjustment still to be slewed and the monotonic time, then
+*  takes a new adjustment in milliseconds from the user. The adjustment is
+*  slewed by the discipline loop without a step; 0 cancels the adjustment
+*  in progress.
+*
+* Parameter:
+*  uint32_t timeout_ms : Maximum allowed time (in milliseconds) for the
+*  function
+*
+* Return:
+*  void
+*******************************************************************************/
+static void adjust_time(uint32_t timeout_ms)
+{
+    cy_rslt_t rslt;
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    char *offset_buffer = app_arena_alloc(STRING_BUFFER_SIZE);
+    uint32_t space_count;
+    uint32_t sec;
+    uint32_t ns;
+    int64_t remaining;
+    long offset_ms = 0;
+
+    if ((NULL == line) || (NULL == offset_buffer))
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    discipline_monotonic(&sec, &ns);
+    snprintf(line, STRING_BUFFER_SIZE, "Monotonic time : %lu.%03lu s\r\n",
+             (unsigned long)sec, (unsigned long)(ns / 1000000u));
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "Remaining adjustment : %ld ms\r\n\n",
+             (long)(discipline_adjtime_remaining() / 1000000));
+    user_uart_puts(line);
+
+    snprintf(line, STRING_BUFFER_SIZE, "Enter the adjustment in ms (-%lu to %lu, 0 : cancel)\r\n",
+             (unsigned long)DISCIPLINE_ADJTIME_MAX_MS, (unsigned long)DISCIPLINE_ADJTIME_MAX_MS);
+    user_uart_puts(line);
+    rslt = fetch_time_data(offset_buffer, timeout_ms, &space_count);
+    if (rslt != CY_SCB_UART_RX_NO_DATA)
+    {
+        if (1 != sscanf(offset_buffer, "%ld", &offset_ms))
+        {
+            user_uart_puts("\rInvalid value!\r\n\n");
+        }
+        else if (0 == offset_ms)
+        {
+            remaining = discipline_adjtime_cancel();
+            snprintf(line, STRING_BUFFER_SIZE, "\rAdjustment cancelled, %ld ms not applied\r\n\n",
+                     (long)(remaining / 1000000));
+            user_uart_puts(line);
+        }
+        else if (discipline_adjtime((int64_t)offset_ms * 1000000, &remaining))
+        {
+            event_log_add(EVENT_LOG_ADJTIME, (int32_t)offset_ms);
+            snprintf(line, STRING_BUFFER_SIZE, "\rAdjusting by %ld ms over %lu s\r\n\n",
+                     offset_ms,
+                     (unsigned long)((((offset_ms < 0) ? -offset_ms : offset_ms) * 1000L) /
+                                     (DISCIPLINE_ADJTIME_RATE_PPB / 1000)));
+            user_uart_puts(line);
+        }
+        else
+        {
+            user_uart_puts("\rInvalid value!\r\n\n");
+        }
+    }
+    else
+    {
+        user_uart_puts("\rTimeout \r\n");
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: print_event_record
+********************************************************************************
+* Summary:
+*  Event log visitor that prints a record on the terminal. Records whose time
+*  was raised to keep the log in order are marked with '*'.
+*
+* Parameter:
+*  const event_log_record_t *record : Record to print
+*  void *context                    : Line buffer of STRING_BUFFER_SIZE bytes
+*
+* Return:
+*  void
+*******************************************************************************/
+static void print_event_record(const event_log_record_t *record, void *context)
+{
+    char *line = (char *)context;
+    cy_stc_rtc_config_t recordTime;
+
+    time_utils_from_epoch(record->epoch, &recordTime);
+    snprintf(line, STRING_BUFFER_SIZE, "%02lu:%02lu:%02lu%c %-10s %ld\r\n",
+             (unsigned long)recordTime.hour, (unsigned long)recordTime.min,
+             (unsigned long)recordTime.sec,
+             (0u != (record->flags & EVENT_LOG_FLAG_CLAMPED)) ? '*' : ' ',
+             event_log_type_name((event_log_type_t)record->type), (long)record->value);
+    user_uart_puts(line);
+}
+
+/*******************************************************************************
+* Function Name: query_event_log
+********************************************************************************
+* Summary:
+*  Shows the size of the event log, then either prints the records of a time
+*  range entered by the user with the cost of the query, or replaces the log
+*  with test records ending at the current time.
+*
+* Parameter:
+*  uint32_t timeout_ms : Maximum allowed time (in milliseconds) for the
+*  function
+*
+* Return:
+*  void
+*******************************************************************************/
+static void query_event_log(uint32_t timeout_ms)
+{
+    cy_rslt_t rslt;
+    uint8_t log_cmd = 0;
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    char *range_buffer = app_arena_alloc(STRING_BUFFER_SIZE);
+    event_log_query_stats_t stats;
+    time_reading_t reading;
+    uint32_t space_count;
+    uint32_t linear_cycles;
+    uint32_t linear_scanned;
+    uint32_t now;
+    uint32_t start;
+    uint32_t end;
+    uint32_t i;
+    int start_hour;
+    int start_min;
+    int end_hour;
+    int end_min;
+
+    if ((NULL == line) || (NULL == range_buffer))
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    snprintf(line, STRING_BUFFER_SIZE, "Records : %lu of %lu, out of order : %lu\r\n\n",
+             (unsigned long)event_log_count(), (unsigned long)EVENT_LOG_CAPACITY,
+             (unsigned long)event_log_clamped());
+    user_uart_puts(line);
+
+    user_uart_puts("1 : Query a time range\r\n");
+    user_uart_puts("2 : Replace the log with test records\r\n");
+    user_uart_puts("3 : Quit\r\n\n");
+
+    rslt = user_uart_getc(&log_cmd, timeout_ms);
+    if (rslt == CY_SCB_UART_RX_NO_DATA)
+    {
+        user_uart_puts("\rTimeout \r\n");
+    }
+    else if (RTC_CMD_QUERY_EVENT_LOG == log_cmd)
+    {
+        user_uart_puts("\rEnter the range of today as \"HH MM HH MM\"\r\n");
+        rslt = fetch_time_data(range_buffer, timeout_ms, &space_count);
+        if (rslt == CY_SCB_UART_RX_NO_DATA)
+        {
+            user_uart_puts("\rTimeout \r\n");
+        }
+        else if ((4 == sscanf(range_buffer, "%d %d %d %d",
+                              &start_hour, &start_min, &end_hour, &end_min)) &&
+                 (start_hour >= 0) && (start_hour < 24) && (start_min >= 0) && (start_min < 60) &&
+                 (end_hour >= 0) && (end_hour < 24) && (end_min >= 0) && (end_min < 60))
+        {
+            /* The records have the served time, not the RTC time */
+            timekeeping_get(&reading);
+            now = reading.epoch;
+            start = (now - (now % TIME_UTILS_SEC_PER_DAY)) +
+                    ((uint32_t)start_hour * TIME_UTILS_SEC_PER_HOUR) +
+                    ((uint32_t)start_min * TIME_UTILS_SEC_PER_MIN);
+            end = (now - (now % TIME_UTILS_SEC_PER_DAY)) +
+                  ((uint32_t)end_hour * TIME_UTILS_SEC_PER_HOUR) +
+                  ((uint32_t)end_min * TIME_UTILS_SEC_PER_MIN) + (TIME_UTILS_SEC_PER_MIN - 1u);
+
+            /* A range that ends before it starts began yesterday */
+            if (end < start)
+            {
+                start -= TIME_UTILS_SEC_PER_DAY;
+            }
+
+            (void)event_log_query(start, end, print_event_record, line, &stats);
+            linear_cycles = event_log_linear_lookup_cycles(start, &linear_scanned);
+
+            snprintf(line, STRING_BUFFER_SIZE, "\r\n%lu records, %lu read, stream %lu cycles\r\n",
+                     (unsigned long)stats.matches, (unsigned long)stats.scanned,
+                     (unsigned long)stats.stream_cycles);
+            user_uart_puts(line);
+            snprintf(line, STRING_BUFFER_SIZE, "Index lookup : %lu cycles, %lu probes\r\n",
+                     (unsigned long)stats.lookup_cycles, (unsigned long)stats.probes);
+            user_uart_puts(line);
+            snprintf(line, STRING_BUFFER_SIZE, "Linear lookup : %lu cycles, %lu records\r\n\n",
+                     (unsigned long)linear_cycles, (unsigned long)linear_scanned);
+            user_uart_puts(line);
+        }
+        else
+        {
+            user_uart_puts("\rInvalid value!\r\n\n");
+        }
+    }
+    else if (RTC_CMD_FILL_EVENT_LOG == log_cmd)
+    {
+        timekeeping_get(&reading);
+        now = reading.epoch;
+        event_log_clear();
+        for (i = EVENT_LOG_CAPACITY; i > 0u; i--)
+        {
+            event_log_add_at(now - (i * EVENT_LOG_TEST_INTERVAL_S), EVENT_LOG_TEST,
+                             (int32_t)(EVENT_LOG_CAPACITY - i));
+        }
+        snprintf(line, STRING_BUFFER_SIZE, "\r%lu test records written\r\n\n",
+                 (unsigned long)event_log_count());
+        user_uart_puts(line);
+    }
+    else
+    {
+        /* Quit */
+    }
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: print_summary
+********************************************************************************
+* Summary:
+*  Time-series store visitor that prints a minute summary on the terminal.
+*
+* Parameter:
+*  const ts_store_summary_t *summary : Summary to print
+*  void *context                     : Line buffer of STRING_BUFFER_SIZE bytes
+*
+* Return:
+*  void
+*******************************************************************************/
+static void print_summary(const ts_store_summary_t *summary, void *context)
+{
+    char *line = (char *)context;
+    cy_stc_rtc_config_t summaryTime;
+
+    time_utils_from_epoch(summary->start, &summaryTime);
+    snprintf(line, STRING_BUFFER_SIZE, "%02lu:%02lu  min %ld, max %ld, avg %ld (%lu samples)\r\n",
+             (unsigned long)summaryTime.hour, (unsigned long)summaryTime.min,
+             (long)summary->min, (long)summary->max, (long)summary->avg,
+             (unsigned long)summary->count);
+    user_uart_puts(line);
+}
+
+/*******************************************************************************
+* Function Name: show_sampler
+********************************************************************************
+* Summary:
+*  Prints the schedule and the statistics of each sampled channel: samples,
+*  last value, trigger delay and period jitter. Then prints the size of the
+*  sensor history and its last minute summaries.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void show_sampler(void)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    sampler_stats_t stats;
+    ts_store_stats_t store_stats;
+    cy_stc_rtc_config_t dateTime;
+    uint32_t now;
+    uint32_t channel;
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    for (channel = 0u; channel < (sizeof(sampler_channels) / sizeof(sampler_channels[0])); channel++)
+    {
+        sampler_get_stats(channel, &stats);
+        snprintf(line, STRING_BUFFER_SIZE, "Channel %lu : every %lu s at +%lu ms, %lu samples, last %ld\r\n",
+                 (unsigned long)channel, (unsigned long)sampler_channels[channel].period_s,
+                 (unsigned long)sampler_channels[channel].phase_ms,
+                 (unsigned long)stats.samples, (long)stats.last_value);
+        user_uart_puts(line);
+        snprintf(line, STRING_BUFFER_SIZE, "  delay max %lu ns, jitter %ld to %ld ns, rms %lu ns\r\n",
+                 (unsigned long)stats.max_latency_ns, (long)stats.min_jitter_ns,
+                 (long)stats.max_jitter_ns, (unsigned long)stats.rms_jitter_ns);
+        user_uart_puts(line);
+        if ((0u != stats.missed) || (0u != stats.dropped))
+        {
+            snprintf(line, STRING_BUFFER_SIZE, "  missed %lu, dropped %lu\r\n",
+                     (unsigned long)stats.missed, (unsigned long)stats.dropped);
+            user_uart_puts(line);
+        }
+    }
+
+    ts_store_get_stats(&sensor_store, &store_stats);
+    snprintf(line, STRING_BUFFER_SIZE, "\r\nHistory : %lu samples, %lu raw in %lu bytes\r\n",
+             (unsigned long)store_stats.appended, (unsigned long)store_stats.raw_samples,
+             (unsigned long)store_stats.raw_bytes);
+    user_uart_puts(line);
+
+    Cy_RTC_GetDateAndTime(&dateTime);
+    now = time_utils_to_epoch(&dateTime);
+    (void)ts_store_query_tier(&sensor_store, TS_STORE_MINUTE,
+                              now - (SAMPLER_SHOW_MINUTES * TIME_UTILS_SEC_PER_MIN), now,
+                              print_summary, line);
+    user_uart_puts("\r\n");
+
+    app_arena_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: print_isr_cycles
+********************************************************************************
+* Summary:
+*  Prints the average and highest cost of an interrupt handler.
+*
+* Parameter:
+*  const char *label          : Name of the handler, padded to 22 characters
+*  const cycle_stats_t *stats : Cost of the handler
+*  char *line                 : Line buffer of STRING_BUFFER_SIZE bytes
+*
+* Return:
+*  void
+*******************************************************************************/
+static void print_isr_cycles(const char *label, const cycle_stats_t *stats, char *line)
+{
+    uint32_t average = 0u;
+
+    if (0u != stats->count)
+    {
+        average = (uint32_t)(stats->total / stats->count);
+    }
+
+    snprintf(line, STRING_BUFFER_SIZE, "%s: %lu cycles avg, %lu max, %lu runs\r\n",
+             label, (unsigned long)average, (unsigned long)stats->max,
+             (unsigned long)stats->count);
+    user_uart_puts(line);
+}
+
+/*******************************************************************************
+* Function Name: benchmark_code_placement
+********************************************************************************
+* Summary:
+*  Compares the cost in CPU cycles of the status line formatter run from
+*  flash and from its configured placement, and prints the cost of the RTC
+*  and UART interrupt handlers measured since boot. To compare the handlers
+*  in flash, build with APP_CONFIG_RAM_CODE=0.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
+*******************************************************************************/
+static void benchmark_code_placement(void)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    cycle_stats_t isr_stats;
+#if APP_CONFIG_TEXT_FORMAT
+    char *scratch = app_arena_alloc(STRING_BUFFER_SIZE);
+    cy_stc_rtc_config_t dateTime;
+    uint32_t flash_cycles;
+    uint32_t placed_cycles;
+    uint32_t start;
+    uint32_t i;
+#endif
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    user_uart_puts("Hot paths run from " HOT_PATH_MEMORY "\r\n");
+
+#if APP_CONFIG_TEXT_FORMAT
+    if (NULL != scratch)
+    {
+        Cy_RTC_GetDateAndTime(&dateTime);
+
+        /* One call each first, so that both start with a warm cache */
+        convert_date_to_string_flash(&dateTime, TIME_QUALITY_SYNCED, scratch, STRING_BUFFER_SIZE);
+        convert_date_to_string(&dateTime, TIME_QUALITY_SYNCED, scratch, STRING_BUFFER_SIZE);
+
+        start = cycle_count_get();
+        for (i = 0u; i < PLACEMENT_BENCH_ITERATIONS; i++)
+        {
+            convert_date_to_string_flash(&dateTime, TIME_QUALITY_SYNCED, scratch, STRING_BUFFER_SIZE);
+        }
+        flash_cycles = (cycle_count_get() - start) / PLACEMENT_BENCH_ITERATIONS;
+
+        start = cycle_count_get();
+        for (i = 0u; i < PLACEMENT_BENCH_ITERATIONS; i++)
+        {
+            convert_date_to_string(&dateTime, TIME_QUALITY_SYNCED, scratch, STRING_BUFFER_SIZE);
+        }
+        placed_cycles = (cycle_count_get() - start) / PLACEMENT_BENCH_ITERATIONS;
+
+        snprintf(line, STRING_BUFFER_SIZE, "Formatter, flash      : %lu cycles\r\n",
+                 (unsigned long)flash_cycles);
+        user_uart_puts(line);
+        snprintf(line, STRING_BUFFER_SIZE, "Formatter, %-11s: %lu cycles\r\n",
+                 HOT_PATH_MEMORY, (unsigned long)placed_cycles);
+        user_uart_puts(line);
+    }
+#endif
+
+    rtc_tick_get_isr_cycles(&isr_stats);
+    print_isr_cycles("RTC tick interrupt    ", &isr_stats, line);
+    user_uart_get_isr_cycles(&isr_stats);
+    print_isr_cycles("UART interrupt        ", &isr_stats, line);
+    user_uart_puts("\r\n");
 
-/***********************************
- * ********************************************
-* Global Variables
-*******************************************************************************/
-uint32_t dst_data_flag = 0;
-char buffer[STRING_BUFFER_SIZE];
+    app_arena_release(mark);
+}
 
 /*******************************************************************************
-* Function Prototypes
+* Function Name: show_perf_state
+********************************************************************************
+* Summary:
+*  Prints the performance state, the latency of the transitions into each
+*  state, the share of the time spent in each state and the CPU clock
+*  averaged over the time, used as a power proxy.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  void
 *******************************************************************************/
-static cy_en_rtc_status_t rtc_init(void);
-static void set_new_time(uint32_t timeout_ms);
-static void set_dst_feature(uint32_t timeout_ms);
-static cy_rslt_t fetch_time_data(char *buffer,
-                             uint32_t timeout_ms, uint32_t *space_count);
+static void show_perf_state(void)
+{
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    perf_state_stats_t stats;
+    uint64_t total_ms = 0u;
+    uint32_t permille;
+    uint32_t state;
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
 
-static void convert_date_to_string(cy_stc_rtc_config_t *dateTime);
-static cy_rslt_t user_uart_getc(uint8_t *value, uint32_t timeout);
+    /* The command itself runs in the active state */
+    perf_state_get_stats(&stats);
+    for (state = 0u; state < (uint32_t)PERF_STATE_COUNT; state++)
+    {
+        total_ms += stats.residency_ms[state];
+    }
 
-static bool validate_date_time(int sec, int min, int hour, int mday,
-                                    int month, int year);
+    snprintf(line, STRING_BUFFER_SIZE, "State  : %s, CPU clock %lu kHz\r\n",
+             perf_state_name(stats.state), (unsigned long)(stats.cpu_hz / 1000u));
+    user_uart_puts(line);
+
+    for (state = 0u; state < (uint32_t)PERF_STATE_COUNT; state++)
+    {
+        permille = (0u != total_ms) ?
+                   (uint32_t)((stats.residency_ms[state] * 1000u) / total_ms) : 0u;
+        snprintf(line, STRING_BUFFER_SIZE,
+                 "%-6s : %lu entries, last %lu us, max %lu us, %lu.%lu %% of time\r\n",
+                 perf_state_name((perf_state_t)state), (unsigned long)stats.entries[state],
+                 (unsigned long)stats.latency_us_last[state],
+                 (unsigned long)stats.latency_us_max[state],
+                 (unsigned long)(permille / 10u), (unsigned long)(permille % 10u));
+        user_uart_puts(line);
+    }
 
+    snprintf(line, STRING_BUFFER_SIZE, "Average CPU clock : %lu kHz, %lu errors\r\n\n",
+             (unsigned long)stats.average_khz, (unsigned long)stats.errors);
+    user_uart_puts(line);
+
+    app_arena_release(mark);
+}
 
 /*******************************************************************************
-* Function Name: handle_error
+* Function Name: print_power_dist
 ********************************************************************************
 * Summary:
-* User defined error handling function
+*  Prints one latency distribution of the power mode benchmark.
 *
-* Parameters:
-*  void
+* Parameter:
+*  const char *label              : Label of the line
+*  const power_bench_dist_t *dist : Distribution
+*  char *line                     : Line buffer of STRING_BUFFER_SIZE bytes
 *
 * Return:
 *  void
-*
 *******************************************************************************/
-void handle_error(void)
+static void print_power_dist(const char *label, const power_bench_dist_t *dist, char *line)
 {
-    /* Disable all interrupts. */
-    __disable_irq();
+    uint32_t average;
 
-    CY_ASSERT(0);
+    if (0u == dist->count)
+    {
+        return;
+    }
+
+    average = (uint32_t)(dist->total_us / dist->count);
+    snprintf(line, STRING_BUFFER_SIZE, "  %-12s: min %lu, avg %lu, p90 <= %lu, max %lu us\r\n",
+             label, (unsigned long)dist->min_us, (unsigned long)average,
+             (unsigned long)power_bench_percentile(dist, 90u),
+             (unsigned long)dist->max_us);
+    user_uart_puts(line);
 }
 
 /*******************************************************************************
-* Function Name: main
+* Function Name: benchmark_power_modes
 ********************************************************************************
 * Summary:
-*   This function:
-*  - Initializes the device and board peripherals
-*  - Initializes RTC
-*  - The loop checks for the user command and process the commands
+*  Measures the entry and wake latencies of Sleep woken by the RTC and by
+*  the UART, and of Deep Sleep woken by the RTC. Hibernate is not measured:
+*  its wake is a reset. The command takes about 40 seconds.
 *
-* Parameters :
+* Parameter:
 *  void
 *
 * Return:
-*  int
-*
+*  void
 *******************************************************************************/
-int main(void)
+static void benchmark_power_modes(void)
 {
-    cy_rslt_t result;
-    cy_en_rtc_status_t rtcSta;
-    cy_stc_rtc_config_t dateTime;
+    static const struct
+    {
+        power_bench_mode_t mode;
+        power_bench_wake_t wake;
+        uint32_t iterations;
+    } rows[] =
+    {
+        { POWER_BENCH_SLEEP,     POWER_BENCH_WAKE_RTC,  POWER_BENCH_RTC_ITERATIONS  },
+        { POWER_BENCH_SLEEP,     POWER_BENCH_WAKE_UART, POWER_BENCH_UART_ITERATIONS },
+        { POWER_BENCH_DEEPSLEEP, POWER_BENCH_WAKE_RTC,  POWER_BENCH_RTC_ITERATIONS  }
+    };
+    /* Larger than the arena */
+    static power_bench_result_t result;
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    uint32_t row;
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
 
-    cy_en_scb_uart_status_t uartSta;
-    cy_stc_scb_uart_context_t USER_UART_context;
+    if (!power_bench_init())
+    {
+        user_uart_puts("Low power callbacks not registered\r\n\n");
+        app_arena_release(mark);
+        return;
+    }
 
-    uint8_t cmd;
+    for (row = 0u; row < (sizeof(rows) / sizeof(rows[0])); row++)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "%s, woken by %s\r\n",
+                 power_bench_mode_name(rows[row].mode), power_bench_wake_name(rows[row].wake));
+        user_uart_puts(line);
 
-    /* Initialize the device and board peripherals */
-    result = cybsp_init();
-    if (result != CY_RSLT_SUCCESS)
+        if (!power_bench_run(rows[row].mode, rows[row].wake, rows[row].iterations, &result))
         {
-            handle_error();
+            user_uart_puts("  Not supported\r\n");
+            continue;
         }
 
-    /* Initialize the USER_UART */
-    uartSta = Cy_SCB_UART_Init(USER_UART_HW, &USER_UART_config, &USER_UART_context);
-    if (uartSta!=CY_SCB_UART_SUCCESS)
-       {
-            handle_error();
-       }
-    Cy_SCB_UART_Enable(USER_UART_HW);
+        print_power_dist("Entry", &result.entry, line);
+        print_power_dist("Wake to ISR", &result.wake_to_isr, line);
+        print_power_dist("Wake to byte", &result.wake_to_byte, line);
+        snprintf(line, STRING_BUFFER_SIZE, "  %lu other wakes, %lu timeouts%s\r\n",
+                 (unsigned long)result.other_wakes, (unsigned long)result.timeouts,
+                 result.counter_stopped ? ", counter stopped: wake is CPU side only" : "");
+        user_uart_puts(line);
+    }
+    user_uart_puts("\r\n");
 
-    /* Transmit header to the terminal */
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    Cy_SCB_UART_PutString(USER_UART_HW, "\x1b[2J\x1b[;H");
+    app_arena_release(mark);
+}
 
-    Cy_SCB_UART_PutString(USER_UART_HW, "************************************************************\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "PDL: RTC Basics\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "************************************************************\r\n\n");
+#if APP_CONFIG_TEXT_FORMAT
+/*******************************************************************************
+* Function Name: self_bench_formatter
+********************************************************************************
+* Summary:
+*  Self-benchmark case: formats the status line.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  uint32_t : CPU cycles per call
+*******************************************************************************/
+static uint32_t self_bench_formatter(void)
+{
+    char line[STRING_BUFFER_SIZE];
+    uint32_t start = cycle_count_get();
+    uint32_t i;
 
-    /* Initialize the USER_RTC */
-    rtcSta = rtc_init();
-    if (rtcSta != CY_RTC_SUCCESS)
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
     {
-        handle_error();
+        convert_date_to_string(&self_bench_time, TIME_QUALITY_SYNCED, line, sizeof(line));
     }
-    /* Enable global interrupts */
-        __enable_irq();
 
-    /*Show the RTC commands*/
-    Cy_SCB_UART_PutString(USER_UART_HW, "Available commands\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "1 : Set new time and date\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "2 : Configure DST feature\r\n\n");
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
+}
+#endif
 
-    for(;;)
+/*******************************************************************************
+* Function Name: self_bench_validate
+********************************************************************************
+* Summary:
+*  Self-benchmark case: validates the date and time entered by the user.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  uint32_t : CPU cycles per call
+*******************************************************************************/
+static uint32_t self_bench_validate(void)
+{
+    uint32_t start = cycle_count_get();
+    uint32_t i;
+
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
     {
-        /*Read out RTC value and show on the terminal*/
-        Cy_RTC_GetDateAndTime(&dateTime);
-        convert_date_to_string(&dateTime);
-        Cy_SCB_UART_PutString(USER_UART_HW, buffer);
-        memset(buffer, '\0', sizeof(buffer));
+        self_bench_sink = validate_date_time((int)self_bench_time.sec, (int)self_bench_time.min,
+                                             (int)self_bench_time.hour, (int)self_bench_time.date,
+                                             (int)self_bench_time.month, (int)self_bench_time.year);
+    }
 
-        /*Read out UART data  */
-        user_uart_getc(&cmd, UART_TIMEOUT_MS);
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
+}
 
-       if(RTC_CMD_SET_DATE_TIME == cmd)
-       {
-          cmd = 0;
-          Cy_SCB_UART_PutString(USER_UART_HW, "\r[Command] : Set new time              \r\n");
-          set_new_time(INPUT_TIMEOUT_MS);
+/*******************************************************************************
+* Function Name: self_bench_nmea
+********************************************************************************
+* Summary:
+*  Self-benchmark case: parses and validates a complete time sentence.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  uint32_t : CPU cycles per sentence
+*******************************************************************************/
+static uint32_t self_bench_nmea(void)
+{
+    nmea_parser_t parser;
+    nmea_fix_t fix;
+    uint32_t start;
+    uint32_t i;
+    uint32_t ch;
 
-       }
-       else if (RTC_CMD_CONFIG_DST == cmd)
-       {
-          cmd = 0;
-          Cy_SCB_UART_PutString(USER_UART_HW, "\r[Command] : Configure DST feature              \r\n");
-          set_dst_feature(INPUT_TIMEOUT_MS);
+    nmea_parser_init(&parser);
 
-       }
+    start = cycle_count_get();
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
+    {
+        for (ch = 0u; ch < (sizeof(self_bench_sentence) - 1u); ch++)
+        {
+            self_bench_sink = (uint32_t)nmea_parser_feed(&parser, self_bench_sentence[ch], &fix);
+        }
     }
+
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
 }
 
 /*******************************************************************************
-* Function Name: rtc_init
+* Function Name: self_bench_to_epoch
 ********************************************************************************
 * Summary:
-*  This functions implement the USER_RTC initialize
+*  Self-benchmark case: converts a calendar time to seconds since 2000.
 *
 * Parameter:
+*  void
 *
-*  function
+* Return:
+*  uint32_t : CPU cycles per call
+*******************************************************************************/
+static uint32_t self_bench_to_epoch(void)
+{
+    uint32_t start = cycle_count_get();
+    uint32_t i;
+
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
+    {
+        self_bench_sink = time_utils_to_epoch(&self_bench_time);
+    }
+
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
+}
+
+/*******************************************************************************
+* Function Name: self_bench_from_epoch
+********************************************************************************
+* Summary:
+*  Self-benchmark case: converts seconds since 2000 to a calendar time.
+*
+* Parameter:
+*  void
 *
 * Return:
+*  uint32_t : CPU cycles per call
+*******************************************************************************/
+static uint32_t self_bench_from_epoch(void)
+{
+    cy_stc_rtc_config_t dateTime;
+    uint32_t epoch = time_utils_to_epoch(&self_bench_time);
+    uint32_t start = cycle_count_get();
+    uint32_t i;
+
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
+    {
+        time_utils_from_epoch(epoch, &dateTime);
+        self_bench_sink = dateTime.sec;
+    }
+
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
+}
+
+/*******************************************************************************
+* Function Name: self_bench_snapshot
+********************************************************************************
+* Summary:
+*  Self-benchmark case: reads and decodes a coherent RTC snapshot.
+*
+* Parameter:
 *  void
+*
+* Return:
+*  uint32_t : CPU cycles per call
 *******************************************************************************/
-static cy_en_rtc_status_t rtc_init(void)
+static uint32_t self_bench_snapshot(void)
 {
-    uint32_t attempts = MAX_ATTEMPTS;
-    cy_en_rtc_status_t rtc_result;
+    rtc_snapshot_t snapshot;
+    cy_stc_rtc_config_t dateTime;
+    uint32_t start = cycle_count_get();
+    uint32_t i;
 
-    /* Setting the time and date can fail. For example the RTC might be busy.
-       Check the result and try again, if necessary.  */
-    do
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
     {
-        rtc_result = Cy_RTC_Init(&USER_RTC_config);
-        attempts--;
+        rtc_snapshot_read(&snapshot);
+        rtc_snapshot_decode(&snapshot, &dateTime);
+        self_bench_sink = dateTime.sec;
+    }
 
-        Cy_SysLib_Delay(INIT_DELAY_MS);
-    } while(( rtc_result != CY_RTC_SUCCESS) && (attempts != 0u));
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
+}
 
-    return (rtc_result);
+/*******************************************************************************
+* Function Name: self_bench_dst
+********************************************************************************
+* Summary:
+*  Self-benchmark case: checks whether a time is in the DST period of the
+*  rules configured in the Device Configurator.
+*
+* Parameter:
+*  void
+*
+* Return:
+*  uint32_t : CPU cycles per call
+*******************************************************************************/
+static uint32_t self_bench_dst(void)
+{
+    uint32_t start = cycle_count_get();
+    uint32_t i;
+
+    for (i = 0u; i < SELF_BENCH_ITERATIONS; i++)
+    {
+        self_bench_sink = Cy_RTC_GetDstStatus(&USER_RTC_configDst, &self_bench_time);
+    }
 
+    return (cycle_count_get() - start) / SELF_BENCH_ITERATIONS;
 }
 
 /*******************************************************************************
-* Function Name: user_uart_getc
+* Function Name: run_self_benchmark
 ********************************************************************************
 * Summary:
-*  This functions get the USER_UART input value from terminal and convert to
-*  uint8_t type.
+*  Runs the built-in micro-benchmarks on the current RTC time and prints
+*  their cost per call in CPU cycles and in nanoseconds, with the CPU clock
+*  and the silicon revision, so that the results of boards and clock
+*  settings can be compared. The table rule is then sent alone to measure
+*  the UART TX throughput, from the first byte queued to the last stop bit.
 *
 * Parameter:
-*  uint8_t *value : the USER_UART input value from terminal
-*  uint32_t timeout: UART timeout
-*  function
+*  void
 *
 * Return:
 *  void
 *******************************************************************************/
-cy_rslt_t user_uart_getc(uint8_t *value, uint32_t timeout)
+static void run_self_benchmark(void)
 {
-    uint32_t read_value = Cy_SCB_UART_Get(USER_UART_HW);
-    uint32_t timeoutTicks = timeout;
-        while (read_value == CY_SCB_UART_RX_NO_DATA)
-        {
-            if(timeout != 0UL)
-            {
-                if(timeoutTicks > 0UL)
-                {
-                    Cy_SysLib_Delay(UART_GET_CHAR_DELAY);       /*delay 1ms*/
-                    timeoutTicks--;
-                }
-                else
-                {
-                    return CY_SCB_UART_RX_NO_DATA;
-                }
-            }
-            read_value = Cy_SCB_UART_Get(USER_UART_HW);
-        }
-        *value = (uint8_t)read_value;
-        return CY_RSLT_SUCCESS;
-}
+    static const struct
+    {
+        const char *name;
+        uint32_t (*run)(void);
+    } cases[] =
+    {
+#if APP_CONFIG_TEXT_FORMAT
+        { "Status line formatter", self_bench_formatter  },
+#endif
+        { "Date and time validator", self_bench_validate },
+        { "NMEA sentence parser", self_bench_nmea         },
+        { "Calendar to epoch", self_bench_to_epoch       },
+        { "Epoch to calendar", self_bench_from_epoch     },
+        { "RTC snapshot read", self_bench_snapshot       },
+        { "DST status query", self_bench_dst             }
+    };
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    char *rule = app_arena_alloc(SELF_BENCH_RULE_LENGTH + 3u);
+    uint32_t cycles;
+    uint32_t start;
+    uint32_t index;
+
+    if ((NULL == line) || (NULL == rule))
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    memset(rule, '-', SELF_BENCH_RULE_LENGTH);
+    memcpy(&rule[SELF_BENCH_RULE_LENGTH], "\r\n", 3u);
+
+    Cy_RTC_GetDateAndTime(&self_bench_time);
+
+    snprintf(line, STRING_BUFFER_SIZE, "CPU clock %lu kHz, silicon revision 0x%02X, %u calls\r\n",
+             (unsigned long)(SystemCoreClock / 1000u), (unsigned int)Cy_SysLib_GetDeviceRevision(),
+             (unsigned int)SELF_BENCH_ITERATIONS);
+    user_uart_puts(line);
+    snprintf(line, STRING_BUFFER_SIZE, "%-24s %9s %9s\r\n", "Case", "cycles", "ns");
+    user_uart_puts(line);
+    user_uart_puts(rule);
+
+    for (index = 0u; index < (sizeof(cases) / sizeof(cases[0])); index++)
+    {
+        /* The table is sent before the next case, which then runs without
+         * the TX interrupt */
+        (void)user_uart_flush();
+        cycles = cases[index].run();
+        snprintf(line, STRING_BUFFER_SIZE, "%-24s %9lu %9lu\r\n", cases[index].name,
+                 (unsigned long)cycles,
+                 (unsigned long)(((uint64_t)cycles * NS_PER_SECOND) / SystemCoreClock));
+        user_uart_puts(line);
+    }
+
+    (void)user_uart_flush();
+    start = cycle_count_get();
+    user_uart_puts(rule);
+    (void)user_uart_flush();
+    cycles = cycle_count_get() - start;
+
+    snprintf(line, STRING_BUFFER_SIZE, "%-24s %9lu bytes/s\r\n\n", "UART TX throughput",
+             (unsigned long)(((uint64_t)(SELF_BENCH_RULE_LENGTH + 2u) * SystemCoreClock) / cycles));
+    user_uart_puts(line);
 
+    app_arena_release(mark);
+}
 
+#if APP_CONFIG_TRACE
 /*******************************************************************************
-* Function Name: convert_date_to_string
+* Function Name: dump_trace
 ********************************************************************************
 * Summary:
-*  This functions get the RTC time values from 'dateTime', convert the uint32_t
-*  values to chars, then combine all chars to one string and save in 'buffer'
+*  Sends the trace ring, oldest entry first, in the text format read by
+*  tools/trace2json.py, then clears it. The recording is paused during the
+*  dump. The header gives the current CPU clock in MHz, the number of
+*  entries and the number of entries overwritten; each entry line is the
+*  cycle count, the event and the argument in hexadecimal.
 *
 * Parameter:
-*  cy_stc_rtc_config_t *dateTime : the RTC configure struct pointer
-*  function
+*  void
 *
 * Return:
 *  void
 *******************************************************************************/
-static void convert_date_to_string(cy_stc_rtc_config_t *dateTime)
+static void dump_trace(void)
 {
-    /* Read out RTC time values */
-    uint32_t sec, min, hour, day, month, year;
-    sec = dateTime->sec;      /*value range is 0-59*/
-    min = dateTime->min;      /*value range is 0-59*/
-    hour = dateTime->hour;     /*0-23 or 1-12*/
-    day = dateTime->date;     /*date of month, 1-31*/
-    month = dateTime->month;      /*1-12*/
-    year = dateTime ->year;     /*base value is 2000. value range is 0-99*/
+    app_arena_mark_t mark = app_arena_mark();
+    char *line = app_arena_alloc(STRING_BUFFER_SIZE);
+    trace_entry_t entry;
+    uint32_t index;
+
+    if (NULL == line)
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    trace_pause(true);
 
-    /* Convert uint32_t values to chars */
-    char secbuf[2], minbuf[2], hourbuf[2], daybuf[2], monthbuf[2], yearbuf[2];
-    sprintf(secbuf, "%d", (int)sec);
-    sprintf(minbuf, "%d", (int)min);
-    sprintf(hourbuf, "%d", (int)hour);
-    sprintf(daybuf, "%d", (int)day);
-    sprintf(monthbuf, "%d", (int)month);
-    sprintf(yearbuf, "%d", (int)year);
+    snprintf(line, STRING_BUFFER_SIZE, "TRACE BEGIN clock_mhz=%lu entries=%lu lost=%lu\r\n",
+             (unsigned long)(SystemCoreClock / US_PER_SECOND), (unsigned long)trace_count(),
+             (unsigned long)trace_lost());
+    user_uart_puts(line);
+
+    for (index = 0u; trace_get(index, &entry); index++)
+    {
+        snprintf(line, STRING_BUFFER_SIZE, "%08lX %02X %04X\r\n", (unsigned long)entry.cycles,
+                 (unsigned int)entry.event, (unsigned int)entry.arg);
+        user_uart_puts(line);
+    }
+    user_uart_puts("TRACE END\r\n\n");
 
-    /* Merge all chars to one string */
-    snprintf(buffer, sizeof(buffer), "%s %s %s %s %s %s %s %s %s %s %s %s %s %s",
-            "Mon", monthbuf, "Date", daybuf, "  ", hourbuf, ":", minbuf, ":", secbuf, "  ", yearbuf, "Year", "\r");
+    trace_clear();
+    trace_pause(false);
 
+    app_arena_release(mark);
 }
+#endif
 
+#if APP_CONFIG_DST_UI
 /*******************************************************************************
 * Function Name: set_dst_feature
 ********************************************************************************
@@ -354,8 +2581,9 @@ static void set_dst_feature(uint32_t timeout_ms)
 {
     cy_rslt_t rslt;
     uint8_t dst_cmd = 0;
-    char dst_start_buffer[STRING_BUFFER_SIZE] = {0};
-    char dst_end_buffer[STRING_BUFFER_SIZE] = {0};
+    app_arena_mark_t mark = app_arena_mark();
+    char *dst_start_buffer = app_arena_alloc(STRING_BUFFER_SIZE);
+    char *dst_end_buffer = app_arena_alloc(STRING_BUFFER_SIZE);
     uint32_t space_count = 0;
 
     /* Variables used to store DST start and end time information */
@@ -365,27 +2593,34 @@ static void set_dst_feature(uint32_t timeout_ms)
     /* Variables used to store date and time information */
     int mday = 0, month = 0, year = 0, sec = 0, min = 0, hour = 0;
     uint8_t fmt = 0;
+
+    if ((NULL == dst_start_buffer) || (NULL == dst_end_buffer))
+    {
+        app_arena_release(mark);
+        return;
+    }
+
     if (DST_ENABLED_FLAG == dst_data_flag)
     {
         if (Cy_RTC_GetDstStatus(&USER_RTC_configDst, &USER_RTC_config))
         {
-            Cy_SCB_UART_PutString(USER_UART_HW, "\rCurrent DST Status :: Active\r\n\n");
+            user_uart_puts("\rCurrent DST Status :: Active\r\n\n");
         }
         else
         {
-            Cy_SCB_UART_PutString(USER_UART_HW, "\rCurrent DST Status :: Inactive\r\n\n");
+            user_uart_puts("\rCurrent DST Status :: Inactive\r\n\n");
         }
     }
     else
     {
-        Cy_SCB_UART_PutString(USER_UART_HW, "\rCurrent DST Status :: Disabled\r\n\n");
+        user_uart_puts("\rCurrent DST Status :: Disabled\r\n\n");
     }
 
     /* Display available commands */
-    Cy_SCB_UART_PutString(USER_UART_HW, "Available DST commands \r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "1 : Enable DST feature\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "2 : Disable DST feature\r\n");
-    Cy_SCB_UART_PutString(USER_UART_HW, "3 : Quit DST Configuration\r\n\n");
+    user_uart_puts("Available DST commands \r\n");
+    user_uart_puts("1 : Enable DST feature\r\n");
+    user_uart_puts("2 : Disable DST feature\r\n");
+    user_uart_puts("3 : Quit DST Configuration\r\n\n");
 
     rslt = user_uart_getc(&dst_cmd, timeout_ms);
 
@@ -394,21 +2629,21 @@ static void set_dst_feature(uint32_t timeout_ms)
         if (RTC_CMD_ENABLE_DST == dst_cmd)
         {
             /* Get DST start time information */
-            Cy_SCB_UART_PutString(USER_UART_HW, "Enter DST format \r\n");
-            Cy_SCB_UART_PutString(USER_UART_HW, "1 : Fixed DST format\r\n");
-            Cy_SCB_UART_PutString(USER_UART_HW, "2 : Relative DST format\r\n\n");
+            user_uart_puts("Enter DST format \r\n");
+            user_uart_puts("1 : Fixed DST format\r\n");
+            user_uart_puts("2 : Relative DST format\r\n\n");
 
             rslt = user_uart_getc(&fmt, timeout_ms);
             if (rslt != CY_SCB_UART_RX_NO_DATA)
             {
-                Cy_SCB_UART_PutString(USER_UART_HW,"Enter DST start time in \"mm dd HH MM SS yy\" format\r\n");
+                user_uart_puts("Enter DST start time in \"mm dd HH MM SS yy\" format\r\n");
                 rslt = fetch_time_data(dst_start_buffer, timeout_ms,
                                                         &space_count);
                 if (rslt != CY_SCB_UART_RX_NO_DATA)
                 {
                     if (space_count != MIN_SPACE_KEY_COUNT)
                     {
-                        Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please enter "
+                        user_uart_puts("\rInvalid values! Please enter "
                         "the values in specified format\r\n");
                     }
                     else
@@ -440,21 +2675,21 @@ static void set_dst_feature(uint32_t timeout_ms)
                     }
                     else
                     {
-                        Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please enter the values"
+                        user_uart_puts("\rInvalid values! Please enter the values"
                                    " in specified format\r\n");
                     }
                     }
                 }
                 else
                 {
-                    Cy_SCB_UART_PutString(USER_UART_HW, "\rTimeout \r\n");
+                    user_uart_puts("\rTimeout \r\n");
                 }
 
                 if (DST_VALID_START_TIME_FLAG == dst_data_flag)
                 {
                     /* Get DST end time information,
                     iff a valid DST start time information is received */
-                    Cy_SCB_UART_PutString(USER_UART_HW, "Enter DST end time "
+                    user_uart_puts("Enter DST end time "
                     " in \"mm dd HH MM SS yy\" format\r\n");
                     rslt = fetch_time_data(dst_end_buffer, timeout_ms,
                                             &space_count);
@@ -462,7 +2697,7 @@ static void set_dst_feature(uint32_t timeout_ms)
                     {
                         if (space_count != MIN_SPACE_KEY_COUNT)
                         {
-                            Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please"
+                            user_uart_puts("\rInvalid values! Please"
                             "enter the values in specified format\r\n");
                         }
                         else
@@ -494,14 +2729,14 @@ static void set_dst_feature(uint32_t timeout_ms)
                             }
                             else
                             {
-                                Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please enter the "
+                                user_uart_puts("\rInvalid values! Please enter the "
                                        " values in specified format\r\n");
                             }
                         }
                     }
                     else
                     {
-                        Cy_SCB_UART_PutString(USER_UART_HW, "\rTimeout \r\n");
+                        user_uart_puts("\rTimeout \r\n");
                     }
                 }
 
@@ -512,7 +2747,8 @@ static void set_dst_feature(uint32_t timeout_ms)
                     if (CY_RTC_SUCCESS == rslt)
                     {
                         dst_data_flag = DST_ENABLED_FLAG;
-                        Cy_SCB_UART_PutString(USER_UART_HW, "\rDST time updated\r\n\n");
+                        save_dst_config(&dst_time);
+                        user_uart_puts("\rDST time updated\r\n\n");
                     }
                     else
                     {
@@ -522,7 +2758,7 @@ static void set_dst_feature(uint32_t timeout_ms)
             }
             else
             {
-                Cy_SCB_UART_PutString(USER_UART_HW, "\rTimeout \r\n");
+                user_uart_puts("\rTimeout \r\n");
             }
         }
         else if (RTC_CMD_DISABLE_DST == dst_cmd)
@@ -539,7 +2775,8 @@ static void set_dst_feature(uint32_t timeout_ms)
             if (CY_RTC_SUCCESS == rslt)
             {
                 dst_data_flag = DST_DISABLED_FLAG;
-                Cy_SCB_UART_PutString(USER_UART_HW, "\rDST feature disabled\r\n\n");
+                save_dst_config(&dst_time);
+                user_uart_puts("\rDST feature disabled\r\n\n");
             }
             else
             {
@@ -548,15 +2785,19 @@ static void set_dst_feature(uint32_t timeout_ms)
         }
         else if (RTC_CMD_QUIT_CONFIG_DST == dst_cmd)
         {
-            Cy_SCB_UART_PutString(USER_UART_HW, "\rExit from DST Configuration \r\n\n");
+            user_uart_puts("\rExit from DST Configuration \r\n\n");
         }
     }
     else
     {
-        Cy_SCB_UART_PutString(USER_UART_HW, "\rTimeout \r\n");
+        user_uart_puts("\rTimeout \r\n");
     }
+
+    app_arena_release(mark);
 }
 
+#endif
+
 /*******************************************************************************
 * Function Name: set_new_time
 ********************************************************************************
@@ -573,20 +2814,28 @@ static void set_dst_feature(uint32_t timeout_ms)
 static void set_new_time(uint32_t timeout_ms)
 {
     cy_rslt_t rslt;
-    char buffer[STRING_BUFFER_SIZE] = {0};
+    app_arena_mark_t mark = app_arena_mark();
+    char *buffer = app_arena_alloc(STRING_BUFFER_SIZE);
     uint32_t space_count;
     uint32_t attempts = MAX_ATTEMPTS;
+    cy_stc_rtc_config_t newTime;
 
     /* Variables used to store date and time information */
     int mday, month, year, sec, min, hour;
 
-    Cy_SCB_UART_PutString(USER_UART_HW,"\rEnter time in \"mm dd HH MM SS yy\" format \r\n");
+    if (NULL == buffer)
+    {
+        app_arena_release(mark);
+        return;
+    }
+
+    user_uart_puts("\rEnter time in \"mm dd HH MM SS yy\" format \r\n");
     rslt = fetch_time_data(buffer, timeout_ms, &space_count);      /*Failed to read memory at 0x00000018*/
     if (rslt != CY_SCB_UART_RX_NO_DATA)
     {
         if (space_count != MIN_SPACE_KEY_COUNT)
         {
-            Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please enter the"
+            user_uart_puts("\rInvalid values! Please enter the"
                     "values in specified format\r\n");
         }
         else
@@ -605,20 +2854,34 @@ static void set_new_time(uint32_t timeout_ms)
 
            }while(( rslt != CY_RTC_SUCCESS) && (attempts != 0u));
 
-          Cy_SCB_UART_PutString(USER_UART_HW, "\rRTC time updated\r\n\n");
+          rtc_tick_add_retries(MAX_ATTEMPTS - attempts - 1u);
+
+          user_uart_puts("\rRTC time updated\r\n\n");
 
           if (CY_RTC_SUCCESS != rslt)
             {
-                Cy_SCB_UART_PutString(USER_UART_HW, "\rInvalid values! Please enter the values in specified"
+                user_uart_puts("\rInvalid values! Please enter the values in specified"
                                    " format\r\n");
                 handle_error();
             }
+
+          /* The time now comes from an operator */
+          newTime.sec = (uint32_t)sec;
+          newTime.min = (uint32_t)min;
+          newTime.hour = (uint32_t)hour;
+          newTime.hrFormat = CY_RTC_24_HOURS;
+          newTime.date = (uint32_t)mday;
+          newTime.month = (uint32_t)month;
+          newTime.year = (uint32_t)year;
+          timekeeping_set(time_utils_to_epoch(&newTime), TIME_QUALITY_MANUAL);
         }
     }
     else
     {
-        Cy_SCB_UART_PutString(USER_UART_HW, "\rTimeout \r\n");
+        user_uart_puts("\rTimeout \r\n");
     }
+
+    app_arena_release(mark);
 }
 
 /*******************************************************************************
@@ -642,20 +2905,17 @@ static void set_new_time(uint32_t timeout_ms)
 static cy_rslt_t fetch_time_data(char *buffer, uint32_t timeout_ms,
                                     uint32_t *space_count)
 {
-    cy_rslt_t rslt;
+    cy_rslt_t rslt = CY_SCB_UART_RX_NO_DATA;
     uint32_t index = 0;
     uint8_t ch = 0;
+    uint32_t deadline = input_deadline(timeout_ms);
     *space_count = 0;
-    while (index < STRING_BUFFER_SIZE)
-    {
-        if (timeout_ms <= UART_TIMEOUT_MS)
-        {
-            rslt = CY_SCB_UART_RX_NO_DATA;
-            break;
-        }
 
+    /* Keep the last byte for the null terminator */
+    while (index < (STRING_BUFFER_SIZE - 1))
+    {
         /* get char from USER_UART terminal */
-        rslt = user_uart_getc(&ch, UART_TIMEOUT_MS);
+        rslt = user_uart_getc_until(&ch, deadline);
 
         if (rslt != CY_SCB_UART_RX_NO_DATA)
         {
@@ -669,14 +2929,16 @@ static cy_rslt_t fetch_time_data(char *buffer, uint32_t timeout_ms,
             }
 
             buffer[index] = ch;
-            rslt = Cy_SCB_UART_Put(USER_UART_HW, ch);
+            user_uart_putc(ch);
             index++;
         }
-
-        timeout_ms -= UART_TIMEOUT_MS;
+        else
+        {
+            break;
+        }
     }
 
-    Cy_SCB_UART_PutString(USER_UART_HW, "\n\r");
+    user_uart_puts("\n\r");
     return rslt;
 }
 
@@ -738,5 +3000,6 @@ static bool validate_date_time(int sec, int min, int hour, int mday,
     }
     return rslt;
 }
+#endif
 
 /* [] END OF FILE */
@@ -0,0 +1,493 @@
+/******************************************************************************
+* File Name:   nmea.c
+*
+* Description: This file contains an incremental NMEA 0183 parser for the $--RMC
+*              and $--ZDA sentences. The parser is fed one character at a time as the
+*              bytes arrive and keeps no copy of the sentence: the fields are converted
+*              to numbers on the fly and the checksum is accumulated as it goes, so a
+*              sentence is complete, validated and decoded when its last checksum digit
+*              is received.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "nmea.h"
+#include "time_utils.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Parser states */
+#define STATE_IDLE               (0u)
+#define STATE_BODY               (1u)
+#define STATE_CHECKSUM_HIGH      (2u)
+#define STATE_CHECKSUM_LOW       (3u)
+
+/* Parser flags */
+#define FLAG_TIME                (0x01u)
+#define FLAG_DATE                (0x02u)
+#define FLAG_VALID               (0x04u)
+#define FLAG_FRACTION            (0x08u)
+#define FLAG_FIELD_ERROR         (0x10u)
+
+/* Formatter and type of the sentence: two talker characters and three type
+ * characters */
+#define ADDRESS_LENGTH           (5u)
+#define ADDRESS_TYPE_Msk         (0x00FFFFFFu)
+#define ADDRESS_TYPE(a, b, c)    (((uint32_t)(a) << 16u) | ((uint32_t)(b) << 8u) | (uint32_t)(c))
+
+/* Fields holding the time and the date */
+#define RMC_FIELD_TIME           (1u)
+#define RMC_FIELD_STATUS         (2u)
+#define RMC_FIELD_DATE           (9u)
+#define ZDA_FIELD_TIME           (1u)
+#define ZDA_FIELD_DAY            (2u)
+#define ZDA_FIELD_MONTH          (3u)
+#define ZDA_FIELD_YEAR           (4u)
+
+#define RMC_STATUS_VALID         ('A')
+
+/* Numeric fields longer than this do not fit into the accumulator */
+#define MAX_INTEGER_DIGITS       (9u)
+#define MILLIS_DIGITS            (3u)
+
+#define NMEA_MAX_YEAR            (TIME_UTILS_BASE_YEAR + 99u)
+
+/*******************************************************************************
+* Function Name: hex_value
+********************************************************************************
+* Summary:
+*  Converts an upper case hexadecimal digit.
+*
+* Parameters:
+*  char ch : Character to convert
+*
+* Return:
+*  uint32_t : Value of the digit, or 0xFF if the character is not a digit
+*
+*******************************************************************************/
+static uint32_t hex_value(char ch)
+{
+    uint32_t value = 0xFFu;
+
+    if ((ch >= '0') && (ch <= '9'))
+    {
+        value = (uint32_t)(ch - '0');
+    }
+    else if ((ch >= 'A') && (ch <= 'F'))
+    {
+        value = (uint32_t)(ch - 'A') + 10u;
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: start_field
+********************************************************************************
+* Summary:
+*  Clears the accumulators for the next field.
+*
+* Parameters:
+*  nmea_parser_t *parser : Parser
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void start_field(nmea_parser_t *parser)
+{
+    parser->value = 0u;
+    parser->frac = 0u;
+    parser->field_length = 0u;
+    parser->frac_digits = 0u;
+    parser->flags &= (uint8_t)~FLAG_FRACTION;
+}
+
+/*******************************************************************************
+* Function Name: end_field
+********************************************************************************
+* Summary:
+*  Stores the value of the completed field if the sentence type uses it.
+*
+* Parameters:
+*  nmea_parser_t *parser : Parser
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void end_field(nmea_parser_t *parser)
+{
+    uint32_t millis = parser->frac;
+    uint32_t digits = parser->frac_digits;
+
+    if (0u == parser->field)
+    {
+        if (ADDRESS_LENGTH == parser->field_length)
+        {
+            switch (parser->address & ADDRESS_TYPE_Msk)
+            {
+                case ADDRESS_TYPE('R', 'M', 'C'):
+                    parser->sentence = NMEA_SENTENCE_RMC;
+                    break;
+                case ADDRESS_TYPE('Z', 'D', 'A'):
+                    /* ZDA has no status field, the time is always valid */
+                    parser->sentence = NMEA_SENTENCE_ZDA;
+                    parser->flags |= FLAG_VALID;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    else if (0u != parser->field_length)
+    {
+        /* Scale the fraction to milliseconds */
+        while (digits < MILLIS_DIGITS)
+        {
+            millis *= 10u;
+            digits++;
+        }
+
+        if (NMEA_SENTENCE_RMC == parser->sentence)
+        {
+            switch (parser->field)
+            {
+                case RMC_FIELD_TIME:
+                    parser->time = parser->value;
+                    parser->millis = millis;
+                    parser->flags |= FLAG_TIME;
+                    break;
+                case RMC_FIELD_STATUS:
+                    if (RMC_STATUS_VALID == parser->value)
+                    {
+                        parser->flags |= FLAG_VALID;
+                    }
+                    break;
+                case RMC_FIELD_DATE:
+                    /* ddmmyy */
+                    parser->day = parser->value / 10000u;
+                    parser->month = (parser->value / 100u) % 100u;
+                    parser->year = TIME_UTILS_BASE_YEAR + (parser->value % 100u);
+                    parser->flags |= FLAG_DATE;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (NMEA_SENTENCE_ZDA == parser->sentence)
+        {
+            switch (parser->field)
+            {
+                case ZDA_FIELD_TIME:
+                    parser->time = parser->value;
+                    parser->millis = millis;
+                    parser->flags |= FLAG_TIME;
+                    break;
+                case ZDA_FIELD_DAY:
+                    parser->day = parser->value;
+                    break;
+                case ZDA_FIELD_MONTH:
+                    parser->month = parser->value;
+                    break;
+                case ZDA_FIELD_YEAR:
+                    parser->year = parser->value;
+                    parser->flags |= FLAG_DATE;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else
+        {
+            /* Fields of other sentences are only checksummed */
+        }
+    }
+    else
+    {
+        /* Empty field */
+    }
+
+    parser->field++;
+    start_field(parser);
+}
+
+/*******************************************************************************
+* Function Name: add_char
+********************************************************************************
+* Summary:
+*  Adds a character of the sentence body to the current field.
+*
+* Parameters:
+*  nmea_parser_t *parser : Parser
+*  char ch               : Character, neither ',' nor '*'
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void add_char(nmea_parser_t *parser, char ch)
+{
+    if (0u == parser->field)
+    {
+        parser->address = (parser->address << 8u) | (uint8_t)ch;
+    }
+    else if ((ch >= '0') && (ch <= '9'))
+    {
+        if (0u != (parser->flags & FLAG_FRACTION))
+        {
+            /* Digits beyond the millisecond are dropped */
+            if (parser->frac_digits < MILLIS_DIGITS)
+            {
+                parser->frac = (parser->frac * 10u) + (uint32_t)(ch - '0');
+                parser->frac_digits++;
+            }
+        }
+        else if (parser->field_length < MAX_INTEGER_DIGITS)
+        {
+            parser->value = (parser->value * 10u) + (uint32_t)(ch - '0');
+        }
+        else
+        {
+            parser->flags |= FLAG_FIELD_ERROR;
+        }
+    }
+    else if ('.' == ch)
+    {
+        parser->flags |= FLAG_FRACTION;
+    }
+    else
+    {
+        /* Text field, such as the RMC status: keep the character */
+        parser->value = (uint8_t)ch;
+    }
+
+    parser->field_length++;
+}
+
+/*******************************************************************************
+* Function Name: make_fix
+********************************************************************************
+* Summary:
+*  Checks the decoded fields of a sentence with a valid checksum and
+*  converts the time and date.
+*
+* Parameters:
+*  const nmea_parser_t *parser : Parser
+*  nmea_fix_t *fix             : Destination of the fix
+*
+* Return:
+*  nmea_result_t : NMEA_RESULT_FIX if the fix has been filled in
+*
+*******************************************************************************/
+static nmea_result_t make_fix(const nmea_parser_t *parser, nmea_fix_t *fix)
+{
+    const uint8_t needed = FLAG_TIME | FLAG_DATE | FLAG_VALID;
+    cy_stc_rtc_config_t dateTime;
+
+    if (0u != (parser->flags & FLAG_FIELD_ERROR))
+    {
+        return NMEA_RESULT_FORMAT_ERROR;
+    }
+
+    if ((NMEA_SENTENCE_OTHER == parser->sentence) || (needed != (parser->flags & needed)))
+    {
+        return NMEA_RESULT_IGNORED;
+    }
+
+    /* hhmmss */
+    dateTime.hour = parser->time / 10000u;
+    dateTime.min = (parser->time / 100u) % 100u;
+    dateTime.sec = parser->time % 100u;
+    dateTime.hrFormat = CY_RTC_24_HOURS;
+    dateTime.amPm = CY_RTC_AM;
+    dateTime.date = parser->day;
+    dateTime.month = parser->month;
+
+    /* A leap second (:60) cannot be represented by the RTC */
+    if ((dateTime.hour > CY_RTC_MAX_HOURS_24H) || (dateTime.min > CY_RTC_MAX_SEC_OR_MIN) ||
+        (dateTime.sec > CY_RTC_MAX_SEC_OR_MIN) ||
+        (parser->year < TIME_UTILS_BASE_YEAR) || (parser->year > NMEA_MAX_YEAR) ||
+        (dateTime.month < 1u) || (dateTime.month > CY_RTC_MONTHS_PER_YEAR) ||
+        (dateTime.date < 1u) ||
+        (dateTime.date > time_utils_days_in_month(dateTime.month, parser->year)))
+    {
+        return NMEA_RESULT_FORMAT_ERROR;
+    }
+
+    dateTime.year = parser->year - TIME_UTILS_BASE_YEAR;
+
+    fix->epoch = time_utils_to_epoch(&dateTime);
+    fix->millis = parser->millis;
+    fix->sentence = parser->sentence;
+
+    return NMEA_RESULT_FIX;
+}
+
+/*******************************************************************************
+* Function Name: nmea_parser_init
+********************************************************************************
+* Summary:
+*  Initializes the parser. The parser then waits for the start of a sentence.
+*
+* Parameters:
+*  nmea_parser_t *parser : Parser
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void nmea_parser_init(nmea_parser_t *parser)
+{
+    parser->state = STATE_IDLE;
+}
+
+/*******************************************************************************
+* Function Name: nmea_parser_feed
+********************************************************************************
+* Summary:
+*  Processes one received character. Characters outside a sentence are
+*  skipped; a '$' always starts a new sentence, so the parser resynchronizes
+*  on the next sentence after an error or a lost character.
+*
+* Parameters:
+*  nmea_parser_t *parser : Parser
+*  char ch               : Received character
+*  nmea_fix_t *fix       : Destination of the fix, written only when
+*                          NMEA_RESULT_FIX is returned
+*
+* Return:
+*  nmea_result_t : NMEA_RESULT_PENDING until the end of a sentence
+*
+*******************************************************************************/
+nmea_result_t nmea_parser_feed(nmea_parser_t *parser, char ch, nmea_fix_t *fix)
+{
+    nmea_result_t result = NMEA_RESULT_PENDING;
+    uint32_t digit;
+
+    if ('$' == ch)
+    {
+        parser->state = STATE_BODY;
+        parser->checksum = 0u;
+        parser->field = 0u;
+        parser->length = 1u;
+        parser->flags = 0u;
+        parser->sentence = NMEA_SENTENCE_OTHER;
+        parser->address = 0u;
+        start_field(parser);
+        return result;
+    }
+
+    if (STATE_IDLE == parser->state)
+    {
+        return result;
+    }
+
+    parser->length++;
+    if (parser->length > NMEA_MAX_SENTENCE_LENGTH)
+    {
+        parser->state = STATE_IDLE;
+        return NMEA_RESULT_FORMAT_ERROR;
+    }
+
+    switch (parser->state)
+    {
+        case STATE_BODY:
+            if ('*' == ch)
+            {
+                end_field(parser);
+                parser->state = STATE_CHECKSUM_HIGH;
+            }
+            else if (('\r' == ch) || ('\n' == ch))
+            {
+                /* The checksum is mandatory */
+                parser->state = STATE_IDLE;
+                result = NMEA_RESULT_CHECKSUM_ERROR;
+            }
+            else
+            {
+                parser->checksum ^= (uint8_t)ch;
+                if (',' == ch)
+                {
+                    end_field(parser);
+                }
+                else
+                {
+                    add_char(parser, ch);
+                }
+            }
+            break;
+
+        case STATE_CHECKSUM_HIGH:
+            digit = hex_value(ch);
+            if (digit > 0xFu)
+            {
+                parser->state = STATE_IDLE;
+                result = NMEA_RESULT_CHECKSUM_ERROR;
+            }
+            else
+            {
+                parser->received_checksum = (uint8_t)(digit << 4u);
+                parser->state = STATE_CHECKSUM_LOW;
+            }
+            break;
+
+        case STATE_CHECKSUM_LOW:
+            digit = hex_value(ch);
+            parser->state = STATE_IDLE;
+            if ((digit > 0xFu) || ((parser->received_checksum | digit) != parser->checksum))
+            {
+                result = NMEA_RESULT_CHECKSUM_ERROR;
+            }
+            else
+            {
+                result = make_fix(parser, fix);
+            }
+            break;
+
+        default:
+            parser->state = STATE_IDLE;
+            break;
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/******************************************************************************
+* File Name:   nmea.h
+*
+* Description: This file contains the declarations of the incremental NMEA 0183
+*              sentence parser used to take the time from a GPS receiver.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef NMEA_H
+#define NMEA_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Longest sentence allowed by NMEA 0183, from '$' to the line feed */
+#define NMEA_MAX_SENTENCE_LENGTH     (82u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    NMEA_RESULT_PENDING = 0,     /* Sentence not complete yet */
+    NMEA_RESULT_FIX,             /* Valid time sentence, the fix is filled in */
+    NMEA_RESULT_IGNORED,         /* Valid sentence without a usable time */
+    NMEA_RESULT_CHECKSUM_ERROR,  /* Checksum missing or wrong */
+    NMEA_RESULT_FORMAT_ERROR     /* Sentence too long or field out of range */
+} nmea_result_t;
+
+typedef enum
+{
+    NMEA_SENTENCE_OTHER = 0,
+    NMEA_SENTENCE_RMC,           /* Recommended minimum data, time and date */
+    NMEA_SENTENCE_ZDA            /* Time and date */
+} nmea_sentence_t;
+
+typedef struct
+{
+    uint32_t epoch;              /* UTC time in seconds since 01/01/2000 */
+    uint32_t millis;             /* Fraction of the second, in milliseconds */
+    nmea_sentence_t sentence;
+} nmea_fix_t;
+
+/* Parser state; all fields are private */
+typedef struct
+{
+    uint8_t state;
+    uint8_t checksum;
+    uint8_t received_checksum;
+    uint8_t field;
+    uint8_t length;
+    uint8_t field_length;
+    uint8_t frac_digits;
+    uint8_t flags;
+    nmea_sentence_t sentence;
+    uint32_t address;
+    uint32_t value;
+    uint32_t frac;
+    uint32_t time;
+    uint32_t millis;
+    uint32_t day;
+    uint32_t month;
+    uint32_t year;
+} nmea_parser_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void nmea_parser_init(nmea_parser_t *parser);
+nmea_result_t nmea_parser_feed(nmea_parser_t *parser, char ch, nmea_fix_t *fix);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* NMEA_H */
+
+/* [] END OF FILE */
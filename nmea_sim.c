@@ -0,0 +1,208 @@
+/******************************************************************************
+* File Name:   nmea_sim.c
+*
+* Description: This file contains an NMEA generator that stands in for a GPS
+*              receiver. On every RTC second it formats the $GPRMC and $GPZDA
+*              sentences of its own free-running UTC clock and feeds them character by
+*              character to the GPS time source, as the UART of a receiver would.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "nmea_sim.h"
+#include "nmea.h"
+#include "gps_time.h"
+#include "time_utils.h"
+#include "app_arena.h"
+#include "stdio.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Room for the sentence and the terminating null */
+#define SENTENCE_BUFFER_SIZE     (NMEA_MAX_SENTENCE_LENGTH + 1u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static bool sim_running = false;
+
+/* UTC time of the generated sentences */
+static uint32_t sim_epoch = 0u;
+
+/*******************************************************************************
+* Function Name: send_sentence
+********************************************************************************
+* Summary:
+*  Appends the checksum to a sentence body and feeds the sentence to the GPS
+*  time source.
+*
+* Parameters:
+*  char *sentence : Sentence from '$' to the last field, in a buffer of
+*                   SENTENCE_BUFFER_SIZE bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void send_sentence(char *sentence)
+{
+    size_t length = strlen(sentence);
+    uint8_t checksum = 0u;
+    size_t index;
+
+    for (index = 1u; index < length; index++)
+    {
+        checksum ^= (uint8_t)sentence[index];
+    }
+
+    snprintf(&sentence[length], SENTENCE_BUFFER_SIZE - length, "*%02X\r\n", checksum);
+
+    for (index = 0u; '\0' != sentence[index]; index++)
+    {
+        gps_time_feed(sentence[index]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: nmea_sim_start
+********************************************************************************
+* Summary:
+*  Starts the generator with its clock offset from the RTC, so that the GPS
+*  time source has an error to correct.
+*
+* Parameters:
+*  uint32_t rtc_epoch : Current RTC time in seconds since the epoch
+*  int32_t offset_s   : Offset of the generated time from the RTC
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void nmea_sim_start(uint32_t rtc_epoch, int32_t offset_s)
+{
+    sim_epoch = rtc_epoch + (uint32_t)offset_s;
+    sim_running = true;
+}
+
+/*******************************************************************************
+* Function Name: nmea_sim_stop
+********************************************************************************
+* Summary:
+*  Stops the generator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void nmea_sim_stop(void)
+{
+    sim_running = false;
+}
+
+/*******************************************************************************
+* Function Name: nmea_sim_is_running
+********************************************************************************
+* Summary:
+*  Checks whether the generator is running.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if the generator is running
+*
+*******************************************************************************/
+bool nmea_sim_is_running(void)
+{
+    return sim_running;
+}
+
+/*******************************************************************************
+* Function Name: nmea_sim_on_tick
+********************************************************************************
+* Summary:
+*  Advances the generator clock by one second and sends the sentences of the
+*  new second. Must be called once per RTC second.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void nmea_sim_on_tick(void)
+{
+    app_arena_mark_t mark;
+    cy_stc_rtc_config_t utc;
+    char *sentence;
+
+    if (!sim_running)
+    {
+        return;
+    }
+
+    sim_epoch++;
+    time_utils_from_epoch(sim_epoch, &utc);
+
+    mark = app_arena_mark();
+    sentence = app_arena_alloc(SENTENCE_BUFFER_SIZE);
+    if (NULL != sentence)
+    {
+        snprintf(sentence, SENTENCE_BUFFER_SIZE,
+                 "$GPRMC,%02lu%02lu%02lu.00,A,4807.038,N,01131.000,E,0.0,0.0,%02lu%02lu%02lu,,,A",
+                 (unsigned long)utc.hour, (unsigned long)utc.min, (unsigned long)utc.sec,
+                 (unsigned long)utc.date, (unsigned long)utc.month, (unsigned long)utc.year);
+        send_sentence(sentence);
+
+        snprintf(sentence, SENTENCE_BUFFER_SIZE, "$GPZDA,%02lu%02lu%02lu.00,%02lu,%02lu,%04lu,00,00",
+                 (unsigned long)utc.hour, (unsigned long)utc.min, (unsigned long)utc.sec,
+                 (unsigned long)utc.date, (unsigned long)utc.month,
+                 (unsigned long)(utc.year + TIME_UTILS_BASE_YEAR));
+        send_sentence(sentence);
+    }
+    app_arena_release(mark);
+}
+
+/* [] END OF FILE */
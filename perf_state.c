@@ -0,0 +1,413 @@
+/******************************************************************************
+* File Name:   perf_state.c
+*
+* Description: This file contains the performance state manager. The CPU clock is
+*              divided and the regulator is set to its minimum current mode while the
+*              application only keeps time, and restored when console work starts.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "perf_state.h"
+#include "user_uart.h"
+#include "rtc_tick.h"
+#include "discipline.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HZ_PER_MHZ               (1000000u)
+#define HZ_PER_KHZ               (1000u)
+#define MS_PER_SECOND            (1000u)
+#define NS_PER_MS                (1000000u)
+
+/* CLK_HF0 feeds the CPU */
+#define CPU_CLK_HF               (0u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static perf_state_t current_state = PERF_STATE_ACTIVE;
+static perf_state_stats_t perf_stats;
+
+/* CPU clock of each state, 0 until the state is entered */
+static uint32_t state_hz[PERF_STATE_COUNT];
+
+/* Monotonic time of the last transition, in ms */
+static uint64_t state_since_ms = 0u;
+
+/* RTC tick of the last console activity */
+static uint32_t activity_tick = 0u;
+
+/* Cleared when a clock change did not affect the UART: the TX queue does not
+ * have to be flushed before the next transitions */
+static bool uart_follows_cpu = true;
+
+static perf_state_listener_t listeners[PERF_STATE_MAX_LISTENERS];
+static uint32_t listener_count = 0u;
+
+/*******************************************************************************
+* Function Name: monotonic_ms
+********************************************************************************
+* Summary:
+*  Returns the monotonic time since boot in milliseconds.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t : Milliseconds since boot
+*
+*******************************************************************************/
+static uint64_t monotonic_ms(void)
+{
+    uint32_t sec;
+    uint32_t ns;
+
+    discipline_monotonic(&sec, &ns);
+
+    return ((uint64_t)sec * MS_PER_SECOND) + (ns / NS_PER_MS);
+}
+
+/*******************************************************************************
+* Function Name: cycles_to_us
+********************************************************************************
+* Summary:
+*  Converts CPU cycles counted at a given clock to microseconds.
+*
+* Parameters:
+*  uint32_t cycles : CPU cycles
+*  uint32_t hz     : CPU clock while the cycles were counted
+*
+* Return:
+*  uint32_t : Microseconds
+*
+*******************************************************************************/
+static uint32_t cycles_to_us(uint32_t cycles, uint32_t hz)
+{
+    return (uint32_t)(((uint64_t)cycles * HZ_PER_MHZ) / hz);
+}
+
+/*******************************************************************************
+* Function Name: perf_state_init
+********************************************************************************
+* Summary:
+*  Starts in the active state, with the clock configured in the Device
+*  Configurator. Must be called after the UART and the discipline loop are
+*  initialized.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void perf_state_init(void)
+{
+    memset(&perf_stats, 0, sizeof(perf_stats));
+    memset(state_hz, 0, sizeof(state_hz));
+
+    current_state = PERF_STATE_ACTIVE;
+    state_hz[PERF_STATE_ACTIVE] = SystemCoreClock;
+    state_since_ms = monotonic_ms();
+    activity_tick = rtc_tick_count();
+    uart_follows_cpu = true;
+}
+
+/*******************************************************************************
+* Function Name: perf_state_add_listener
+********************************************************************************
+* Summary:
+*  Registers a function notified of the changes of the CPU clock, for the
+*  code that converts cycle counts to time.
+*
+* Parameters:
+*  perf_state_listener_t listener : Function to call
+*
+* Return:
+*  bool : false if PERF_STATE_MAX_LISTENERS are already registered
+*
+*******************************************************************************/
+bool perf_state_add_listener(perf_state_listener_t listener)
+{
+    if (listener_count >= PERF_STATE_MAX_LISTENERS)
+    {
+        return false;
+    }
+
+    listeners[listener_count] = listener;
+    listener_count++;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: perf_state_set
+********************************************************************************
+* Summary:
+*  Changes the performance state. The regulator leaves its minimum current
+*  mode before the clock is raised and enters it after the clock is lowered.
+*  The listeners and the UART clock divider are updated with interrupts
+*  disabled, so no interrupt sees the new clock with stale settings. The
+*  flash wait states stay those of the full clock, which are valid at the
+*  lower clock.
+*
+* Parameters:
+*  perf_state_t state : State to enter
+*
+* Return:
+*  cy_en_sysclk_status_t : Status of the clock change
+*
+*******************************************************************************/
+cy_en_sysclk_status_t perf_state_set(perf_state_t state)
+{
+    cy_en_clkhf_dividers_t divider = (PERF_STATE_IDLE == state) ?
+                                     PERF_STATE_IDLE_DIVIDER : CY_SYSCLK_CLKHF_NO_DIVIDE;
+    cy_en_sysclk_status_t result;
+    uint32_t old_hz = SystemCoreClock;
+    uint32_t interruptState;
+    uint32_t start;
+    uint32_t switched;
+    uint32_t latency_us;
+    uint64_t now_ms;
+    uint32_t i;
+
+    if (state == current_state)
+    {
+        return CY_SYSCLK_SUCCESS;
+    }
+
+    start = cycle_count_get();
+
+    /* The UART clock may be derived from the CPU clock: the bytes still to
+     * send would be shifted out at a wrong baud rate */
+    if (uart_follows_cpu)
+    {
+        (void)user_uart_flush();
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+
+#if PERF_STATE_IDLE_MIN_REGULATOR
+    if ((PERF_STATE_ACTIVE == state) &&
+        (CY_SYSPM_SUCCESS != Cy_SysPm_SystemSetNormalRegulatorCurrent()))
+    {
+        perf_stats.errors++;
+        Cy_SysLib_ExitCriticalSection(interruptState);
+        return CY_SYSCLK_INVALID_STATE;
+    }
+#endif
+
+    now_ms = monotonic_ms();
+    result = Cy_SysClk_ClkHfSetDivider(CPU_CLK_HF, divider);
+    if (CY_SYSCLK_SUCCESS == result)
+    {
+        switched = cycle_count_get();
+        SystemCoreClockUpdate();
+
+        for (i = 0u; i < listener_count; i++)
+        {
+            listeners[i](old_hz);
+        }
+        uart_follows_cpu = user_uart_update_clock();
+
+#if PERF_STATE_IDLE_MIN_REGULATOR
+        /* The normal mode is kept if the minimum mode cannot be entered */
+        if ((PERF_STATE_IDLE == state) &&
+            (CY_SYSPM_SUCCESS != Cy_SysPm_SystemSetMinRegulatorCurrent()))
+        {
+            perf_stats.errors++;
+        }
+#endif
+
+        /* The cycles before the change were counted at the old clock */
+        latency_us = cycles_to_us(switched - start, old_hz) +
+                     cycles_to_us(cycle_count_get() - switched, SystemCoreClock);
+
+        perf_stats.residency_ms[current_state] += now_ms - state_since_ms;
+        state_since_ms = now_ms;
+        current_state = state;
+        state_hz[state] = SystemCoreClock;
+
+        perf_stats.entries[state]++;
+        perf_stats.latency_us_last[state] = latency_us;
+        if (latency_us > perf_stats.latency_us_max[state])
+        {
+            perf_stats.latency_us_max[state] = latency_us;
+        }
+    }
+    else
+    {
+        perf_stats.errors++;
+    }
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: perf_state_get
+********************************************************************************
+* Summary:
+*  Returns the current performance state.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  perf_state_t : Current state
+*
+*******************************************************************************/
+perf_state_t perf_state_get(void)
+{
+    return current_state;
+}
+
+/*******************************************************************************
+* Function Name: perf_state_activity
+********************************************************************************
+* Summary:
+*  Reports console activity: enters the active state if needed and delays
+*  the return to the idle state. Called from the work items only.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void perf_state_activity(void)
+{
+    activity_tick = rtc_tick_count();
+
+    if (PERF_STATE_ACTIVE != current_state)
+    {
+        (void)perf_state_set(PERF_STATE_ACTIVE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: perf_state_on_tick
+********************************************************************************
+* Summary:
+*  Called on every RTC second from the tick work item. Enters the idle state
+*  once the console has been quiet for PERF_STATE_IDLE_DELAY_S seconds. The
+*  tick count of the work item can be older than the last activity when
+*  ticks were merged behind a long command, so the current count is used.
+*
+* Parameters:
+*  uint32_t tick : Tick count, not used
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void perf_state_on_tick(uint32_t tick)
+{
+    (void)tick;
+
+    if ((PERF_STATE_ACTIVE == current_state) &&
+        ((rtc_tick_count() - activity_tick) >= PERF_STATE_IDLE_DELAY_S))
+    {
+        (void)perf_state_set(PERF_STATE_IDLE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: perf_state_get_stats
+********************************************************************************
+* Summary:
+*  Returns the transition statistics and the time spent in each state, up
+*  to now. The power proxy is the CPU clock averaged over the time: the
+*  dynamic power of the core is proportional to its clock.
+*
+* Parameters:
+*  perf_state_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void perf_state_get_stats(perf_state_stats_t *stats)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    uint64_t total_ms = 0u;
+    uint64_t khz_ms = 0u;
+    uint32_t state;
+
+    *stats = perf_stats;
+    stats->residency_ms[current_state] += monotonic_ms() - state_since_ms;
+    stats->state = current_state;
+    stats->cpu_hz = SystemCoreClock;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    for (state = 0u; state < (uint32_t)PERF_STATE_COUNT; state++)
+    {
+        total_ms += stats->residency_ms[state];
+        khz_ms += stats->residency_ms[state] * (state_hz[state] / HZ_PER_KHZ);
+    }
+
+    stats->average_khz = (0u != total_ms) ? (uint32_t)(khz_ms / total_ms) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: perf_state_name
+********************************************************************************
+* Summary:
+*  Returns the name of a performance state.
+*
+* Parameters:
+*  perf_state_t state : State
+*
+* Return:
+*  const char * : Name of the state
+*
+*******************************************************************************/
+const char *perf_state_name(perf_state_t state)
+{
+    return (PERF_STATE_IDLE == state) ? "idle" : "active";
+}
+
+/* [] END OF FILE */
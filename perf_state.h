@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   perf_state.h
+*
+* Description: This file contains the declarations of the performance state manager,
+*              which lowers the CPU clock while the application only keeps time.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef PERF_STATE_H
+#define PERF_STATE_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Divider of the CPU clock (CLK_HF0) in the idle state */
+#if !defined(PERF_STATE_IDLE_DIVIDER)
+#define PERF_STATE_IDLE_DIVIDER      (CY_SYSCLK_CLKHF_DIVIDE_BY_4)
+#endif
+
+/* Seconds without console activity before the idle state is entered */
+#define PERF_STATE_IDLE_DELAY_S      (2u)
+
+/* Set to 0 to keep the normal regulator current mode in the idle state */
+#if !defined(PERF_STATE_IDLE_MIN_REGULATOR)
+#define PERF_STATE_IDLE_MIN_REGULATOR (1)
+#endif
+
+/* Functions notified of a change of the CPU clock */
+#define PERF_STATE_MAX_LISTENERS     (4u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    PERF_STATE_IDLE,             /* Divided clock, minimum regulator current */
+    PERF_STATE_ACTIVE,           /* Clock and regulator as configured */
+    PERF_STATE_COUNT
+} perf_state_t;
+
+/* Called with interrupts disabled after a change of the CPU clock, once
+ * SystemCoreClock has been updated */
+typedef void (*perf_state_listener_t)(uint32_t old_hz);
+
+typedef struct
+{
+    perf_state_t state;
+    uint32_t cpu_hz;                              /* Current CPU clock */
+    uint32_t entries[PERF_STATE_COUNT];           /* Transitions into each state */
+    uint32_t latency_us_last[PERF_STATE_COUNT];   /* Duration of the transition into */
+    uint32_t latency_us_max[PERF_STATE_COUNT];    /* each state, TX flush included */
+    uint64_t residency_ms[PERF_STATE_COUNT];      /* Time spent in each state */
+    uint32_t average_khz;        /* CPU clock averaged over the time, the power proxy */
+    uint32_t errors;             /* Clock or regulator changes that failed */
+} perf_state_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void perf_state_init(void);
+bool perf_state_add_listener(perf_state_listener_t listener);
+cy_en_sysclk_status_t perf_state_set(perf_state_t state);
+perf_state_t perf_state_get(void);
+void perf_state_activity(void);
+void perf_state_on_tick(uint32_t tick);
+void perf_state_get_stats(perf_state_stats_t *stats);
+const char *perf_state_name(perf_state_t state);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* PERF_STATE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,603 @@
+/******************************************************************************
+* File Name:   power_bench.c
+*
+* Description: This file contains the power mode benchmark. Each iteration enters a
+*              CPU low power mode and is woken by the RTC second or by the USER_UART,
+*              and the latencies are timed with the DWT cycle counter.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "power_bench.h"
+#include "cybsp.h"
+#include "rtc_tick.h"
+#include "user_uart.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HZ_PER_MHZ               (1000000u)
+
+/* The callbacks run after all others before the transition */
+#define LAST_CALLBACK_ORDER      (255u)
+
+/* Longest block sent for the UART wake, must exceed the TX FIFO */
+#define UART_BLOCK_MAX           (96u)
+
+/* RTC seconds after which a UART wake is given up */
+#define UART_WAKE_TIMEOUT_TICKS  (2u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static cy_en_syspm_status_t on_transition(cy_stc_syspm_callback_params_t *params,
+                                          cy_en_syspm_callback_mode_t mode);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Cycle count in the last callback, just before WFI */
+static volatile uint32_t transition_cycles = 0u;
+
+/* Sent for the UART wake: spaces and a carriage return, so the terminal
+ * shows nothing */
+static uint8_t uart_block[UART_BLOCK_MAX];
+
+static cy_stc_syspm_callback_params_t callback_params =
+{
+    .base = NULL,
+    .context = NULL
+};
+
+static cy_stc_syspm_callback_t sleep_callback =
+{
+    .callback = on_transition,
+    .type = CY_SYSPM_SLEEP,
+    .skipMode = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                CY_SYSPM_SKIP_AFTER_TRANSITION,
+    .callbackParams = &callback_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = LAST_CALLBACK_ORDER
+};
+
+static cy_stc_syspm_callback_t deep_sleep_callback =
+{
+    .callback = on_transition,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                CY_SYSPM_SKIP_AFTER_TRANSITION,
+    .callbackParams = &callback_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = LAST_CALLBACK_ORDER
+};
+
+static bool initialized = false;
+
+/*******************************************************************************
+* Function Name: on_transition
+********************************************************************************
+* Summary:
+*  Low power callback, registered last. Records the cycle count just before
+*  the CPU executes WFI.
+*
+* Parameters:
+*  cy_stc_syspm_callback_params_t *params : Unused
+*  cy_en_syspm_callback_mode_t mode       : Callback mode
+*
+* Return:
+*  cy_en_syspm_status_t : Always CY_SYSPM_SUCCESS
+*
+*******************************************************************************/
+static cy_en_syspm_status_t on_transition(cy_stc_syspm_callback_params_t *params,
+                                          cy_en_syspm_callback_mode_t mode)
+{
+    (void)params;
+
+    if (CY_SYSPM_BEFORE_TRANSITION == mode)
+    {
+        transition_cycles = cycle_count_get();
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cycles_to_us
+********************************************************************************
+* Summary:
+*  Converts a signed number of CPU cycles to microseconds. Negative values,
+*  which are measurement noise, count as 0.
+*
+* Parameters:
+*  int32_t cycles : CPU cycles
+*
+* Return:
+*  uint32_t : Microseconds
+*
+*******************************************************************************/
+static uint32_t cycles_to_us(int32_t cycles)
+{
+    if (cycles <= 0)
+    {
+        return 0u;
+    }
+
+    return (uint32_t)(((uint64_t)(uint32_t)cycles * HZ_PER_MHZ) / SystemCoreClock);
+}
+
+/*******************************************************************************
+* Function Name: dist_add
+********************************************************************************
+* Summary:
+*  Adds a latency to a distribution.
+*
+* Parameters:
+*  power_bench_dist_t *dist : Distribution
+*  uint32_t us              : Latency in microseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void dist_add(power_bench_dist_t *dist, uint32_t us)
+{
+    uint32_t bucket = (0u == us) ? 0u : (32u - (uint32_t)__CLZ(us));
+
+    if (bucket >= POWER_BENCH_BUCKETS)
+    {
+        bucket = POWER_BENCH_BUCKETS - 1u;
+    }
+
+    if ((0u == dist->count) || (us < dist->min_us))
+    {
+        dist->min_us = us;
+    }
+    if (us > dist->max_us)
+    {
+        dist->max_us = us;
+    }
+    dist->total_us += us;
+    dist->buckets[bucket]++;
+    dist->count++;
+}
+
+/*******************************************************************************
+* Function Name: enter_mode
+********************************************************************************
+* Summary:
+*  Enters a CPU low power mode until the next interrupt.
+*
+* Parameters:
+*  power_bench_mode_t mode : Mode to enter
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void enter_mode(power_bench_mode_t mode)
+{
+    if (POWER_BENCH_SLEEP == mode)
+    {
+        (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+    }
+    else
+    {
+        (void)Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+    }
+}
+
+/*******************************************************************************
+* Function Name: wait_for_tick
+********************************************************************************
+* Summary:
+*  Waits awake, without WFI, until the RTC interrupt has run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Cycle count at the start of the RTC interrupt handler
+*
+*******************************************************************************/
+static uint32_t wait_for_tick(void)
+{
+    uint32_t tick = rtc_tick_count();
+    cycle_stats_t isr;
+
+    while (tick == rtc_tick_count())
+    {
+    }
+
+    rtc_tick_get_isr_cycles(&isr);
+
+    return isr.last_start;
+}
+
+/*******************************************************************************
+* Function Name: wait_for_uart_isr
+********************************************************************************
+* Summary:
+*  Waits awake, without WFI, until the UART interrupt has run a given number
+*  of times, or until the RTC has counted UART_WAKE_TIMEOUT_TICKS seconds.
+*
+* Parameters:
+*  uint32_t count : Interrupt count to reach
+*
+* Return:
+*  bool : false on timeout
+*
+*******************************************************************************/
+static bool wait_for_uart_isr(uint32_t count)
+{
+    uint32_t tick = rtc_tick_count();
+    cycle_stats_t isr;
+
+    do
+    {
+        user_uart_get_isr_cycles(&isr);
+    } while ((isr.count < count) && ((rtc_tick_count() - tick) < UART_WAKE_TIMEOUT_TICKS));
+
+    return (isr.count >= count);
+}
+
+/*******************************************************************************
+* Function Name: run_rtc
+********************************************************************************
+* Summary:
+*  Runs the iterations woken by the RTC second. The RTC period is first
+*  measured in cycles with the CPU awake. Each iteration starts just after an
+*  RTC interrupt and sleeps until the next one. If the cycle counter runs in
+*  the mode, the wake latency is the delay of the interrupt beyond one
+*  period. Otherwise it is the time counted between WFI and the interrupt.
+*  A byte is then sent and flushed for the wake to byte latency.
+*
+* Parameters:
+*  power_bench_mode_t mode      : Mode to enter
+*  uint32_t iterations          : Number of iterations
+*  power_bench_result_t *result : Accumulated results
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_rtc(power_bench_mode_t mode, uint32_t iterations,
+                    power_bench_result_t *result)
+{
+    uint32_t period;
+    uint32_t previous;
+    uint32_t woke;
+    uint32_t start;
+    uint32_t tick;
+    uint32_t wake_us;
+    uint32_t i;
+    cycle_stats_t isr;
+
+    previous = wait_for_tick();
+    period = wait_for_tick() - previous;
+
+    for (i = 0u; i < iterations; i++)
+    {
+        previous = wait_for_tick();
+        tick = rtc_tick_count();
+
+        /* The UART is not clocked in Deep Sleep */
+        (void)user_uart_flush();
+
+        start = cycle_count_get();
+        enter_mode(mode);
+        dist_add(&result->entry, cycles_to_us((int32_t)(transition_cycles - start)));
+
+        while (tick == rtc_tick_count())
+        {
+            result->other_wakes++;
+            enter_mode(mode);
+        }
+
+        rtc_tick_get_isr_cycles(&isr);
+        woke = isr.last_start;
+        if ((woke - previous) >= (period / 2u))
+        {
+            wake_us = cycles_to_us((int32_t)((woke - previous) - period));
+        }
+        else
+        {
+            result->counter_stopped = true;
+            wake_us = cycles_to_us((int32_t)(woke - transition_cycles));
+        }
+        dist_add(&result->wake_to_isr, wake_us);
+
+        user_uart_putc('.');
+        (void)user_uart_flush();
+        dist_add(&result->wake_to_byte,
+                 wake_us + cycles_to_us((int32_t)(cycle_count_get() - woke)));
+    }
+
+    user_uart_puts("\r\n");
+}
+
+/*******************************************************************************
+* Function Name: run_uart
+********************************************************************************
+* Summary:
+*  Runs the iterations woken by the USER_UART. A block longer than the TX
+*  FIFO is queued: the first interrupt fills the FIFO, and the next one,
+*  when the FIFO is half empty, wakes the CPU. The delay between the two
+*  interrupts is first measured with the CPU awake; the wake latency is the
+*  extra delay when the CPU sleeps. If the calibration times out, no
+*  iteration is run and the timeout is counted.
+*
+* Parameters:
+*  uint32_t iterations          : Number of iterations
+*  power_bench_result_t *result : Accumulated results
+*
+* Return:
+*  bool : false if the TX FIFO is too large for the block
+*
+*******************************************************************************/
+static bool run_uart(uint32_t iterations, power_bench_result_t *result)
+{
+    uint32_t fifo_size = Cy_SCB_GetFifoSize(USER_UART_HW);
+    uint32_t block_size = fifo_size + (fifo_size / 2u);
+    uint32_t period = 0u;
+    uint32_t first;
+    uint32_t start;
+    uint32_t tick;
+    uint32_t wake_us;
+    uint32_t i;
+    cycle_stats_t isr;
+
+    if (block_size > UART_BLOCK_MAX)
+    {
+        return false;
+    }
+
+    memset(uart_block, ' ', block_size);
+    uart_block[block_size - 1u] = '\r';
+
+    /* One calibration pass awake, then the iterations */
+    for (i = 0u; i <= iterations; i++)
+    {
+        (void)user_uart_flush();
+        user_uart_get_isr_cycles(&isr);
+        user_uart_write(uart_block, block_size);
+        if (!wait_for_uart_isr(isr.count + 1u))
+        {
+            result->timeouts++;
+            if (0u == i)
+            {
+                /* The iterations need the calibrated period */
+                break;
+            }
+            continue;
+        }
+        user_uart_get_isr_cycles(&isr);
+        first = isr.last_start;
+
+        if (0u == i)
+        {
+            if (!wait_for_uart_isr(isr.count + 1u))
+            {
+                result->timeouts++;
+                break;
+            }
+            user_uart_get_isr_cycles(&isr);
+            period = isr.last_start - first;
+            continue;
+        }
+
+        tick = rtc_tick_count();
+        start = cycle_count_get();
+        enter_mode(POWER_BENCH_SLEEP);
+        dist_add(&result->entry, cycles_to_us((int32_t)(transition_cycles - start)));
+
+        user_uart_get_isr_cycles(&isr);
+        while ((isr.last_start == first) && ((rtc_tick_count() - tick) < UART_WAKE_TIMEOUT_TICKS))
+        {
+            result->other_wakes++;
+            enter_mode(POWER_BENCH_SLEEP);
+            user_uart_get_isr_cycles(&isr);
+        }
+
+        if (isr.last_start == first)
+        {
+            result->timeouts++;
+        }
+        else
+        {
+            if ((isr.last_start - first) >= (period / 2u))
+            {
+                wake_us = cycles_to_us((int32_t)((isr.last_start - first) - period));
+            }
+            else
+            {
+                result->counter_stopped = true;
+                wake_us = cycles_to_us((int32_t)(isr.last_start - transition_cycles));
+            }
+            dist_add(&result->wake_to_isr, wake_us);
+        }
+    }
+
+    (void)user_uart_flush();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: power_bench_init
+********************************************************************************
+* Summary:
+*  Registers the low power callbacks that timestamp the entry into Sleep and
+*  Deep Sleep. Called once, before the first run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : false if a callback could not be registered
+*
+*******************************************************************************/
+bool power_bench_init(void)
+{
+    if (!initialized)
+    {
+        initialized = Cy_SysPm_RegisterCallback(&sleep_callback) &&
+                      Cy_SysPm_RegisterCallback(&deep_sleep_callback);
+    }
+
+    return initialized;
+}
+
+/*******************************************************************************
+* Function Name: power_bench_run
+********************************************************************************
+* Summary:
+*  Runs the iterations of one mode and wake source. Must be called from a
+*  work item with interrupts enabled. An RTC iteration lasts up to two
+*  seconds; each prints a dot. Hibernate is not supported: its wake is a
+*  reset.
+*
+* Parameters:
+*  power_bench_mode_t mode      : Mode to enter
+*  power_bench_wake_t wake      : Wake source
+*  uint32_t iterations          : 1 to POWER_BENCH_MAX_ITERATIONS
+*  power_bench_result_t *result : Destination of the results
+*
+* Return:
+*  bool : false if the combination is not supported or the parameters are
+*         invalid
+*
+*******************************************************************************/
+bool power_bench_run(power_bench_mode_t mode, power_bench_wake_t wake,
+                     uint32_t iterations, power_bench_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    /* The SCB is not clocked in Deep Sleep, and its RX wake is not routed */
+    if ((!initialized) || (0u == iterations) || (iterations > POWER_BENCH_MAX_ITERATIONS) ||
+        ((POWER_BENCH_WAKE_UART == wake) && (POWER_BENCH_SLEEP != mode)))
+    {
+        return false;
+    }
+
+    if (POWER_BENCH_WAKE_RTC == wake)
+    {
+        run_rtc(mode, iterations, result);
+        return true;
+    }
+
+    return run_uart(iterations, result);
+}
+
+/*******************************************************************************
+* Function Name: power_bench_percentile
+********************************************************************************
+* Summary:
+*  Returns an upper bound of a percentile of a distribution: the end of the
+*  histogram bucket that contains it, limited to the highest value.
+*
+* Parameters:
+*  const power_bench_dist_t *dist : Distribution
+*  uint32_t percent               : Percentile, 1 to 100
+*
+* Return:
+*  uint32_t : Upper bound in microseconds, 0 if the distribution is empty
+*
+*******************************************************************************/
+uint32_t power_bench_percentile(const power_bench_dist_t *dist, uint32_t percent)
+{
+    uint32_t rank = ((dist->count * percent) + 99u) / 100u;
+    uint32_t seen = 0u;
+    uint32_t bucket;
+    uint32_t bound = dist->max_us;
+
+    for (bucket = 0u; bucket < (POWER_BENCH_BUCKETS - 1u); bucket++)
+    {
+        seen += dist->buckets[bucket];
+        if (seen >= rank)
+        {
+            bound = (0u == bucket) ? 0u : ((1uL << bucket) - 1u);
+            break;
+        }
+    }
+
+    return (bound < dist->max_us) ? bound : dist->max_us;
+}
+
+/*******************************************************************************
+* Function Name: power_bench_mode_name
+********************************************************************************
+* Summary:
+*  Returns the name of a low power mode.
+*
+* Parameters:
+*  power_bench_mode_t mode : Mode
+*
+* Return:
+*  const char * : Name of the mode
+*
+*******************************************************************************/
+const char *power_bench_mode_name(power_bench_mode_t mode)
+{
+    return (POWER_BENCH_SLEEP == mode) ? "Sleep" : "Deep Sleep";
+}
+
+/*******************************************************************************
+* Function Name: power_bench_wake_name
+********************************************************************************
+* Summary:
+*  Returns the name of a wake source.
+*
+* Parameters:
+*  power_bench_wake_t wake : Wake source
+*
+* Return:
+*  const char * : Name of the wake source
+*
+*******************************************************************************/
+const char *power_bench_wake_name(power_bench_wake_t wake)
+{
+    return (POWER_BENCH_WAKE_RTC == wake) ? "RTC" : "UART";
+}
+
+/* [] END OF FILE */
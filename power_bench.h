@@ -0,0 +1,118 @@
+/******************************************************************************
+* File Name:   power_bench.h
+*
+* Description: This file contains the declarations of the power mode benchmark, which
+*              measures the cost of entering and leaving the CPU low power modes.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef POWER_BENCH_H
+#define POWER_BENCH_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Latency histogram buckets: bucket 0 counts 0 us, bucket n counts
+ * 2^(n-1) to 2^n - 1 us, the last bucket everything above */
+#define POWER_BENCH_BUCKETS          (16u)
+
+/* Highest number of iterations of a run */
+#define POWER_BENCH_MAX_ITERATIONS   (1000u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    POWER_BENCH_SLEEP,
+    POWER_BENCH_DEEPSLEEP
+} power_bench_mode_t;
+
+typedef enum
+{
+    POWER_BENCH_WAKE_RTC,        /* RTC second alarm */
+    POWER_BENCH_WAKE_UART        /* USER_UART TX FIFO level, Sleep only */
+} power_bench_wake_t;
+
+/* Distribution of a latency over the iterations */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint16_t buckets[POWER_BENCH_BUCKETS];
+} power_bench_dist_t;
+
+typedef struct
+{
+    power_bench_dist_t entry;        /* Call to the last instruction before WFI */
+    power_bench_dist_t wake_to_isr;  /* Wake event to the interrupt handler */
+    power_bench_dist_t wake_to_byte; /* Wake event to a byte sent, RTC wake only */
+    bool counter_stopped;        /* The cycle counter stops in the mode, so the wake
+                                  * latencies only count the CPU part */
+    uint32_t other_wakes;        /* Wakes by other interrupts, slept again */
+    uint32_t timeouts;           /* Iterations without the expected wake */
+} power_bench_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool power_bench_init(void);
+bool power_bench_run(power_bench_mode_t mode, power_bench_wake_t wake,
+                     uint32_t iterations, power_bench_result_t *result);
+uint32_t power_bench_percentile(const power_bench_dist_t *dist, uint32_t percent);
+const char *power_bench_mode_name(power_bench_mode_t mode);
+const char *power_bench_wake_name(power_bench_wake_t wake);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* POWER_BENCH_H */
+
+/* [] END OF FILE */
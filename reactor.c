@@ -0,0 +1,235 @@
+/******************************************************************************
+* File Name:   reactor.c
+*
+* Description: This file contains the event loop of the application. The interrupt
+*              handlers post work items, each one registered by its event source, and
+*              the loop runs them in priority order. When no work is pending, the CPU
+*              sleeps in WFI until the next interrupt, so the loop costs no cycles
+*              between events. The time spent awake is measured with the cycle counter
+*              and reported as a CPU load once per RTC second.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "reactor.h"
+#include "work_queue.h"
+#include "rtc_tick.h"
+#include "cycle_count.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CYCLES_PER_LOAD_UNIT     (SystemCoreClock / REACTOR_LOAD_FULL)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Cycle count and RTC tick count when the CPU last woke up */
+static uint32_t awake_since = 0u;
+static uint32_t awake_tick = 0u;
+
+/* Awake cycles and wakeups of the current window. Merged windows can hold
+ * more cycles than 32 bits, over 28 s at 150 MHz. */
+static uint64_t window_busy = 0u;
+static uint32_t window_wakeups = 0u;
+static uint32_t window_tick = 0u;
+
+static reactor_stats_t reactor_stats;
+
+/*******************************************************************************
+* Function Name: awake_cycles
+********************************************************************************
+* Summary:
+*  Returns the cycles since the CPU last woke up. The cycle counter wraps
+*  after 2^32 cycles, so a longer span, behind a command that blocks the
+*  loop, is counted in whole RTC seconds instead.
+*
+* Parameters:
+*  uint32_t now : Current cycle count
+*
+* Return:
+*  uint64_t : Cycles spent awake
+*
+*******************************************************************************/
+static uint64_t awake_cycles(uint32_t now)
+{
+    uint32_t ticks = rtc_tick_count() - awake_tick;
+
+    if (ticks >= (UINT32_MAX / SystemCoreClock))
+    {
+        return (uint64_t)ticks * SystemCoreClock;
+    }
+
+    return now - awake_since;
+}
+
+/*******************************************************************************
+* Function Name: update_load
+********************************************************************************
+* Summary:
+*  Closes the measurement window when the RTC tick count has changed and
+*  computes the CPU load of the window.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void update_load(void)
+{
+    uint32_t tick = rtc_tick_count();
+    uint32_t now;
+    uint64_t busy;
+    uint64_t load;
+
+    if (tick == window_tick)
+    {
+        return;
+    }
+
+    now = cycle_count_get();
+    busy = window_busy + awake_cycles(now);
+    load = busy / ((uint64_t)CYCLES_PER_LOAD_UNIT * (tick - window_tick));
+    if (load > REACTOR_LOAD_FULL)
+    {
+        load = REACTOR_LOAD_FULL;
+    }
+
+    reactor_stats.load = (uint32_t)load;
+    reactor_stats.busy_cycles = busy;
+    reactor_stats.wakeups = window_wakeups;
+    if (reactor_stats.load > reactor_stats.peak_load)
+    {
+        reactor_stats.peak_load = reactor_stats.load;
+    }
+
+    awake_since = now;
+    awake_tick = tick;
+    window_busy = 0u;
+    window_wakeups = 0u;
+    window_tick = tick;
+}
+
+/*******************************************************************************
+* Function Name: reactor_sleep
+********************************************************************************
+* Summary:
+*  Sleeps until the next interrupt and accounts the time spent awake. Must be
+*  called with interrupts disabled, after checking that there is nothing to
+*  do, so that an interrupt between the check and WFI still wakes the CPU.
+*  The pending interrupt runs when the caller re-enables interrupts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reactor_sleep(void)
+{
+    window_busy += awake_cycles(cycle_count_get());
+
+    trace_record(TRACE_EVENT_SLEEP_BEGIN, 0u);
+    __WFI();
+    trace_record(TRACE_EVENT_SLEEP_END, 0u);
+
+    awake_since = cycle_count_get();
+    awake_tick = rtc_tick_count();
+    window_wakeups++;
+}
+
+/*******************************************************************************
+* Function Name: reactor_run
+********************************************************************************
+* Summary:
+*  Runs the event loop: runs the pending work items, then sleeps until an
+*  interrupt posts more. Does not return.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reactor_run(void)
+{
+    uint32_t interruptState;
+
+    awake_since = cycle_count_get();
+    window_tick = rtc_tick_count();
+    awake_tick = window_tick;
+
+    for (;;)
+    {
+        (void)work_queue_drain();
+        update_load();
+
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        if (work_queue_is_empty())
+        {
+            reactor_sleep();
+        }
+        Cy_SysLib_ExitCriticalSection(interruptState);
+    }
+}
+
+/*******************************************************************************
+* Function Name: reactor_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the CPU load statistics.
+*
+* Parameters:
+*  reactor_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reactor_get_stats(reactor_stats_t *stats)
+{
+    *stats = reactor_stats;
+}
+
+/* [] END OF FILE */
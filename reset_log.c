@@ -0,0 +1,373 @@
+/******************************************************************************
+* File Name:   reset_log.c
+*
+* Description: This file contains the reset history kept in the backup registers,
+*              which survive all resets except a loss of the backup supply.
+*              A heartbeat with the RTC time and the uptime is refreshed every
+*              second, so that a record can be created at the next boot for resets
+*              that give no warning (watchdog, brown-out). Application errors are
+*              recorded on the fault path with a fixed number of register writes.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "reset_log.h"
+#include "timekeeping.h"
+#include "rtc_tick.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Backup register layout */
+#define BREG_HEADER              (0u)
+#define BREG_HEARTBEAT_EPOCH     (1u)
+#define BREG_HEARTBEAT_UPTIME    (2u)
+#define BREG_FIRST_RECORD        (3u)
+#define BREGS_PER_RECORD         (2u)
+
+/* Header word: [31:16] magic, [15:8] record count, [7:4] next slot,
+ * [0] a record was already written on the fault path */
+#define HEADER_MAGIC             (0xB5A7u)
+#define HEADER_MAGIC_Pos         (16u)
+#define HEADER_COUNT_Pos         (8u)
+#define HEADER_COUNT_Msk         (0x0000FF00u)
+#define HEADER_NEXT_Pos          (4u)
+#define HEADER_NEXT_Msk          (0x000000F0u)
+#define HEADER_FAULT_PENDING     (0x00000001u)
+
+/* Second record word: [7:0] cause, [31:8] uptime in seconds */
+#define RECORD_CAUSE_Msk         (0x000000FFu)
+#define RECORD_UPTIME_Pos        (8u)
+#define RECORD_UPTIME_MAX        (0x00FFFFFFu)
+
+#define RESET_LOG_BREG           (BACKUP_BREG)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* RTC tick count at boot. The uptime is counted in RTC ticks, which are
+ * not lost when the tick work items are merged behind a long command */
+static uint32_t boot_tick = 0u;
+
+static const char * const cause_names[RESET_CAUSE_COUNT] =
+{
+    "unknown",
+    "power-on",
+    "external",
+    "brown-out",
+    "watchdog",
+    "cpu fault",
+    "software",
+    "hibernate",
+    "app error"
+};
+
+/*******************************************************************************
+* Function Name: append_record
+********************************************************************************
+* Summary:
+*  Writes a record into the next slot of the ring and updates the header.
+*  Uses a fixed number of register accesses, so it is safe on the fault path.
+*
+* Parameters:
+*  reset_cause_t cause : Cause of the reset
+*  uint32_t epoch      : RTC time of the reset
+*  uint32_t uptime     : Seconds since the previous boot
+*  uint32_t flags      : Header flags to set
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void append_record(reset_cause_t cause, uint32_t epoch, uint32_t uptime,
+                          uint32_t flags)
+{
+    uint32_t header = RESET_LOG_BREG[BREG_HEADER];
+    uint32_t next = (header & HEADER_NEXT_Msk) >> HEADER_NEXT_Pos;
+    uint32_t count = (header & HEADER_COUNT_Msk) >> HEADER_COUNT_Pos;
+    uint32_t breg = BREG_FIRST_RECORD + (next * BREGS_PER_RECORD);
+
+    if (uptime > RECORD_UPTIME_MAX)
+    {
+        uptime = RECORD_UPTIME_MAX;
+    }
+
+    RESET_LOG_BREG[breg] = epoch;
+    RESET_LOG_BREG[breg + 1u] = ((uint32_t)cause & RECORD_CAUSE_Msk) |
+                                (uptime << RECORD_UPTIME_Pos);
+
+    next = (next + 1u) % RESET_LOG_RECORDS;
+    if (count < RESET_LOG_RECORDS)
+    {
+        count++;
+    }
+
+    RESET_LOG_BREG[BREG_HEADER] = (HEADER_MAGIC << HEADER_MAGIC_Pos) |
+                                  (count << HEADER_COUNT_Pos) |
+                                  (next << HEADER_NEXT_Pos) | flags;
+}
+
+/*******************************************************************************
+* Function Name: decode_reset_reason
+********************************************************************************
+* Summary:
+*  Maps the reset reason reported by the SRSS to a reset cause.
+*
+* Parameters:
+*  uint32_t reason : Value returned by Cy_SysLib_GetResetReason()
+*
+* Return:
+*  reset_cause_t : Cause of the last reset
+*
+*******************************************************************************/
+static reset_cause_t decode_reset_reason(uint32_t reason)
+{
+    reset_cause_t cause = RESET_CAUSE_UNKNOWN;
+
+    if (0u != (reason & (CY_SYSLIB_RESET_HWWDT | CY_SYSLIB_RESET_SWWDT0)))
+    {
+        cause = RESET_CAUSE_WATCHDOG;
+    }
+    else if (0u != (reason & (CY_SYSLIB_RESET_ACT_FAULT | CY_SYSLIB_RESET_DPSLP_FAULT)))
+    {
+        cause = RESET_CAUSE_CPU_FAULT;
+    }
+    else if (0u != (reason & CY_SYSLIB_RESET_SOFT))
+    {
+        cause = RESET_CAUSE_SOFTWARE;
+    }
+    else if (0u != (reason & CY_SYSLIB_RESET_HIB_WAKEUP))
+    {
+        cause = RESET_CAUSE_HIBERNATE;
+    }
+    else if (0u != (reason & CY_SYSLIB_RESET_BODVDDD))
+    {
+        cause = RESET_CAUSE_BROWNOUT;
+    }
+    else if (0u != (reason & CY_SYSLIB_RESET_XRES))
+    {
+        cause = RESET_CAUSE_EXTERNAL;
+    }
+    else if (0u == reason)
+    {
+        /* No reason is latched after a power-on reset */
+        cause = RESET_CAUSE_POWER_ON;
+    }
+
+    return cause;
+}
+
+/*******************************************************************************
+* Function Name: reset_log_init
+********************************************************************************
+* Summary:
+*  Validates the reset history and records the reset that led to this boot,
+*  with the time and uptime of the last heartbeat. Nothing is added if the
+*  record was already written on the fault path. Call once at boot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reset_log_init(void)
+{
+    uint32_t header = RESET_LOG_BREG[BREG_HEADER];
+
+    if ((header >> HEADER_MAGIC_Pos) != HEADER_MAGIC)
+    {
+        /* Backup domain lost: start an empty history */
+        RESET_LOG_BREG[BREG_HEADER] = HEADER_MAGIC << HEADER_MAGIC_Pos;
+    }
+    else if (0u != (header & HEADER_FAULT_PENDING))
+    {
+        RESET_LOG_BREG[BREG_HEADER] = header & ~HEADER_FAULT_PENDING;
+    }
+    else
+    {
+        append_record(decode_reset_reason(Cy_SysLib_GetResetReason()),
+                      RESET_LOG_BREG[BREG_HEARTBEAT_EPOCH],
+                      RESET_LOG_BREG[BREG_HEARTBEAT_UPTIME], 0u);
+    }
+
+    Cy_SysLib_ClearResetReason();
+    boot_tick = rtc_tick_count();
+}
+
+/*******************************************************************************
+* Function Name: reset_log_on_tick
+********************************************************************************
+* Summary:
+*  Refreshes the heartbeat. Call on every RTC second.
+*
+* Parameters:
+*  uint32_t epoch : RTC time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reset_log_on_tick(uint32_t epoch)
+{
+    RESET_LOG_BREG[BREG_HEARTBEAT_EPOCH] = epoch;
+    RESET_LOG_BREG[BREG_HEARTBEAT_UPTIME] = reset_log_uptime();
+}
+
+/*******************************************************************************
+* Function Name: reset_log_record_fault
+********************************************************************************
+* Summary:
+*  Records a fault with the shadow time and the current uptime, and marks it
+*  so that the next boot does not add a second record. Runs in a bounded
+*  number of cycles and can be called with interrupts disabled.
+*
+* Parameters:
+*  reset_cause_t cause : Cause to record
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void reset_log_record_fault(reset_cause_t cause)
+{
+    time_reading_t reading;
+
+    timekeeping_get(&reading);
+    append_record(cause, reading.epoch, reset_log_uptime(), HEADER_FAULT_PENDING);
+}
+
+/*******************************************************************************
+* Function Name: reset_log_count
+********************************************************************************
+* Summary:
+*  Returns the number of records in the history.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of records
+*
+*******************************************************************************/
+uint32_t reset_log_count(void)
+{
+    return (RESET_LOG_BREG[BREG_HEADER] & HEADER_COUNT_Msk) >> HEADER_COUNT_Pos;
+}
+
+/*******************************************************************************
+* Function Name: reset_log_get
+********************************************************************************
+* Summary:
+*  Reads one record of the history.
+*
+* Parameters:
+*  uint32_t index         : Record index, 0 is the most recent reset
+*  reset_record_t *record : Destination of the record
+*
+* Return:
+*  bool : false if the index is out of range
+*
+*******************************************************************************/
+bool reset_log_get(uint32_t index, reset_record_t *record)
+{
+    uint32_t header = RESET_LOG_BREG[BREG_HEADER];
+    uint32_t next = (header & HEADER_NEXT_Msk) >> HEADER_NEXT_Pos;
+    uint32_t slot;
+    uint32_t word;
+    bool valid = (index < reset_log_count());
+
+    if (valid)
+    {
+        slot = (next + RESET_LOG_RECORDS - 1u - index) % RESET_LOG_RECORDS;
+        word = RESET_LOG_BREG[BREG_FIRST_RECORD + (slot * BREGS_PER_RECORD) + 1u];
+
+        record->epoch = RESET_LOG_BREG[BREG_FIRST_RECORD + (slot * BREGS_PER_RECORD)];
+        record->cause = (reset_cause_t)(word & RECORD_CAUSE_Msk);
+        record->uptime = word >> RECORD_UPTIME_Pos;
+    }
+
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: reset_log_uptime
+********************************************************************************
+* Summary:
+*  Returns the number of seconds since boot, counted in RTC ticks.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Uptime in seconds
+*
+*******************************************************************************/
+uint32_t reset_log_uptime(void)
+{
+    return rtc_tick_count() - boot_tick;
+}
+
+/*******************************************************************************
+* Function Name: reset_log_cause_name
+********************************************************************************
+* Summary:
+*  Returns a printable name of a reset cause.
+*
+* Parameters:
+*  reset_cause_t cause : Reset cause
+*
+* Return:
+*  const char* : Name of the cause
+*
+*******************************************************************************/
+const char *reset_log_cause_name(reset_cause_t cause)
+{
+    const char *name = cause_names[RESET_CAUSE_UNKNOWN];
+
+    if ((uint32_t)cause < (uint32_t)RESET_CAUSE_COUNT)
+    {
+        name = cause_names[cause];
+    }
+
+    return name;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   reset_log.h
+*
+* Description: This file contains the declarations of the reset history kept in
+*              the backup registers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RESET_LOG_H
+#define RESET_LOG_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of reset records kept in the backup registers */
+#define RESET_LOG_RECORDS        (6u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    RESET_CAUSE_UNKNOWN = 0,
+    RESET_CAUSE_POWER_ON,
+    RESET_CAUSE_EXTERNAL,
+    RESET_CAUSE_BROWNOUT,
+    RESET_CAUSE_WATCHDOG,
+    RESET_CAUSE_CPU_FAULT,
+    RESET_CAUSE_SOFTWARE,
+    RESET_CAUSE_HIBERNATE,
+    RESET_CAUSE_APP_ERROR,
+    RESET_CAUSE_COUNT
+} reset_cause_t;
+
+typedef struct
+{
+    reset_cause_t cause;
+    uint32_t epoch;          /* RTC time of the reset, seconds since the epoch */
+    uint32_t uptime;         /* Seconds since the previous boot */
+} reset_record_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void reset_log_init(void);
+void reset_log_on_tick(uint32_t epoch);
+void reset_log_record_fault(reset_cause_t cause);
+uint32_t reset_log_count(void);
+bool reset_log_get(uint32_t index, reset_record_t *record);
+uint32_t reset_log_uptime(void);
+const char *reset_log_cause_name(reset_cause_t cause);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* RESET_LOG_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,128 @@
+/******************************************************************************
+* File Name:   rtc_snapshot.c
+*
+* Description: This file contains the low-latency RTC snapshot read path. One
+*              read synchronization is performed and the packed time and date
+*              registers are copied back to back; the field extraction and the
+*              BCD conversion done by Cy_RTC_GetDateAndTime() are left to the
+*              consumer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "rtc_snapshot.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HOURS_PER_HALF_DAY       (12u)
+
+/* Layout of the hour field in the 12-hour mode */
+#define RTC_HOUR_PM_FLAG         (0x20u)
+#define RTC_HOUR_12H_MASK        (0x1Fu)
+
+/*******************************************************************************
+* Function Name: rtc_snapshot_read
+********************************************************************************
+* Summary:
+*  Copies the RTC time and date registers after a single read
+*  synchronization. Both registers come from the same synchronization, so the
+*  snapshot is consistent across a second or day rollover.
+*
+* Parameters:
+*  rtc_snapshot_t *snapshot : Destination of the raw snapshot
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_snapshot_read(rtc_snapshot_t *snapshot)
+{
+    uint32_t time;
+    uint32_t date;
+
+    Cy_RTC_SyncFromRtc();
+
+    time = BACKUP_RTC_TIME;
+    date = BACKUP_RTC_DATE;
+
+    snapshot->time = time;
+    snapshot->date = date;
+}
+
+/*******************************************************************************
+* Function Name: rtc_snapshot_decode
+********************************************************************************
+* Summary:
+*  Decodes a raw snapshot into the PDL date and time structure.
+*
+* Parameters:
+*  const rtc_snapshot_t *snapshot  : Raw snapshot
+*  cy_stc_rtc_config_t *dateTime   : Decoded date and time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_snapshot_decode(const rtc_snapshot_t *snapshot, cy_stc_rtc_config_t *dateTime)
+{
+    uint32_t hour = _FLD2VAL(BACKUP_RTC_TIME_RTC_HOUR, snapshot->time);
+
+    dateTime->sec = Cy_RTC_ConvertBcdToDec(_FLD2VAL(BACKUP_RTC_TIME_RTC_SEC, snapshot->time));
+    dateTime->min = Cy_RTC_ConvertBcdToDec(_FLD2VAL(BACKUP_RTC_TIME_RTC_MIN, snapshot->time));
+    dateTime->dayOfWeek = _FLD2VAL(BACKUP_RTC_TIME_RTC_DAY, snapshot->time);
+
+    if (_FLD2BOOL(BACKUP_RTC_TIME_CTRL_12HR, snapshot->time))
+    {
+        dateTime->hrFormat = CY_RTC_12_HOURS;
+        dateTime->amPm = (0u != (hour & RTC_HOUR_PM_FLAG)) ? CY_RTC_PM : CY_RTC_AM;
+        dateTime->hour = Cy_RTC_ConvertBcdToDec(hour & RTC_HOUR_12H_MASK);
+    }
+    else
+    {
+        dateTime->hrFormat = CY_RTC_24_HOURS;
+        dateTime->amPm = (Cy_RTC_ConvertBcdToDec(hour) < HOURS_PER_HALF_DAY) ? CY_RTC_AM : CY_RTC_PM;
+        dateTime->hour = Cy_RTC_ConvertBcdToDec(hour);
+    }
+
+    dateTime->date = Cy_RTC_ConvertBcdToDec(_FLD2VAL(BACKUP_RTC_DATE_RTC_DATE, snapshot->date));
+    dateTime->month = Cy_RTC_ConvertBcdToDec(_FLD2VAL(BACKUP_RTC_DATE_RTC_MON, snapshot->date));
+    dateTime->year = Cy_RTC_ConvertBcdToDec(_FLD2VAL(BACKUP_RTC_DATE_RTC_YEAR, snapshot->date));
+}
+
+/* [] END OF FILE */
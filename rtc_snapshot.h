@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name:   rtc_snapshot.h
+*
+* Description: This file contains the declarations of the low-latency RTC
+*              snapshot read path.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RTC_SNAPSHOT_H
+#define RTC_SNAPSHOT_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Packed BCD copy of the RTC time and date registers. The fields are decoded
+ * by the consumer, only when needed. */
+typedef struct
+{
+    uint32_t time;      /* BACKUP_RTC_TIME: sec, min, hour, 12HR, day of week */
+    uint32_t date;      /* BACKUP_RTC_DATE: date, month, year */
+} rtc_snapshot_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void rtc_snapshot_read(rtc_snapshot_t *snapshot);
+void rtc_snapshot_decode(const rtc_snapshot_t *snapshot, cy_stc_rtc_config_t *dateTime);
+
+/*******************************************************************************
+* Function Name: rtc_snapshot_sec_bcd
+********************************************************************************
+* Summary:
+*  Returns the BCD seconds field of a snapshot, for cheap change detection.
+*
+* Parameters:
+*  const rtc_snapshot_t *snapshot : Raw snapshot
+*
+* Return:
+*  uint32_t : Seconds in BCD
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t rtc_snapshot_sec_bcd(const rtc_snapshot_t *snapshot)
+{
+    return _FLD2VAL(BACKUP_RTC_TIME_RTC_SEC, snapshot->time);
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* RTC_SNAPSHOT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,333 @@
+/******************************************************************************
+* File Name:   rtc_tick.c
+*
+* Description: This file contains the RTC second tick. ALARM1 is configured with
+*              all fields disabled, so it matches every second. The interrupt
+*              handler only posts the tick work item; the processing runs from
+*              the main loop. ALARM2 remains used by the PDL for the DST events.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "rtc_tick.h"
+#include "app_config.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_ATTEMPTS             (500u)  /* Maximum number of attempts for RTC operation */
+#define INIT_DELAY_MS            (5u)    /* delay 5 milliseconds before trying again */
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static work_handler_t tick_work = NULL;
+static volatile uint32_t tick_count = 0u;
+
+/* Cost of the RTC interrupt handler, hook included */
+static cycle_stats_t isr_cycles;
+
+/* Called in the interrupt on every second, before the work item is posted */
+static rtc_tick_hook_t tick_hook = NULL;
+
+static const cy_stc_rtc_dst_t *dst_rules = NULL;
+static volatile bool dst_enabled = false;
+
+/* RTC writes tried again because the RTC was busy */
+static uint32_t write_retries = 0u;
+
+/* No field is compared, so the alarm matches on every second */
+static const cy_stc_rtc_alarm_t every_second_alarm =
+{
+    .sec = 0u,
+    .secEn = CY_RTC_ALARM_DISABLE,
+    .min = 0u,
+    .minEn = CY_RTC_ALARM_DISABLE,
+    .hour = 0u,
+    .hourEn = CY_RTC_ALARM_DISABLE,
+    .dayOfWeek = 1u,
+    .dayOfWeekEn = CY_RTC_ALARM_DISABLE,
+    .date = 1u,
+    .dateEn = CY_RTC_ALARM_DISABLE,
+    .month = 1u,
+    .monthEn = CY_RTC_ALARM_DISABLE,
+    .almEn = CY_RTC_ALARM_ENABLE
+};
+
+static const cy_stc_sysint_t rtc_irq_cfg =
+{
+    .intrSrc = RTC_TICK_IRQ,
+    .intrPriority = RTC_TICK_IRQ_PRIORITY
+};
+
+/*******************************************************************************
+* Function Name: rtc_tick_isr
+********************************************************************************
+* Summary:
+*  RTC interrupt handler. The PDL dispatches ALARM1 to
+*  Cy_RTC_Alarm1Interrupt() and ALARM2 to the DST handling. The cost of the
+*  handler is accumulated in isr_cycles.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void rtc_tick_isr(void)
+{
+    uint32_t start = cycle_count_get();
+
+    trace_record(TRACE_EVENT_RTC_ISR_BEGIN, 0u);
+    Cy_RTC_Interrupt(dst_rules, dst_enabled && (NULL != dst_rules));
+    trace_record(TRACE_EVENT_RTC_ISR_END, 0u);
+
+    cycle_stats_add(&isr_cycles, start);
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: Cy_RTC_Alarm1Interrupt
+********************************************************************************
+* Summary:
+*  Called by Cy_RTC_Interrupt() on every second. Counts the tick, runs the
+*  tick hook and posts the tick work item.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+void Cy_RTC_Alarm1Interrupt(void)
+{
+    tick_count++;
+
+    if (NULL != tick_hook)
+    {
+        tick_hook(tick_count);
+    }
+
+    if (NULL != tick_work)
+    {
+        (void)work_queue_post(WORK_PRIORITY_HIGH, tick_work, tick_count,
+                              RTC_TICK_WORK_KEY);
+    }
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: rtc_tick_init
+********************************************************************************
+* Summary:
+*  Configures ALARM1 to fire every second and enables the RTC interrupt.
+*
+* Parameters:
+*  work_handler_t tick_handler : Work item posted on every second; its
+*                                argument is the tick count
+*
+* Return:
+*  cy_en_rtc_status_t : Status of the alarm configuration
+*
+*******************************************************************************/
+cy_en_rtc_status_t rtc_tick_init(work_handler_t tick_handler)
+{
+    uint32_t attempts = MAX_ATTEMPTS;
+    cy_en_rtc_status_t rtc_result;
+
+    tick_work = tick_handler;
+
+    /* The RTC might be busy, try again if necessary */
+    do
+    {
+        rtc_result = Cy_RTC_SetAlarmDateAndTime(&every_second_alarm, CY_RTC_ALARM_1);
+        attempts--;
+
+        if (rtc_result != CY_RTC_SUCCESS)
+        {
+            Cy_SysLib_Delay(INIT_DELAY_MS);
+        }
+    } while ((rtc_result != CY_RTC_SUCCESS) && (attempts != 0u));
+
+    rtc_tick_add_retries(MAX_ATTEMPTS - attempts - 1u);
+
+    if (rtc_result == CY_RTC_SUCCESS)
+    {
+        Cy_RTC_ClearInterrupt(CY_RTC_INTR_ALARM1 | CY_RTC_INTR_ALARM2);
+        Cy_RTC_SetInterruptMask(CY_RTC_INTR_ALARM1 | CY_RTC_INTR_ALARM2);
+
+        (void)Cy_SysInt_Init(&rtc_irq_cfg, rtc_tick_isr);
+        NVIC_EnableIRQ(rtc_irq_cfg.intrSrc);
+    }
+
+    return rtc_result;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_set_hook
+********************************************************************************
+* Summary:
+*  Registers a function called in the RTC interrupt on every second, for
+*  the work that must be aligned on the second boundary. The hook runs at
+*  interrupt priority and must be short.
+*
+* Parameters:
+*  rtc_tick_hook_t hook : Function to call, or NULL to remove it
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_set_hook(rtc_tick_hook_t hook)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    tick_hook = hook;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_set_dst
+********************************************************************************
+* Summary:
+*  Sets the DST rules used by the PDL when ALARM2 fires.
+*
+* Parameters:
+*  const cy_stc_rtc_dst_t *dst_time : DST rules, must remain valid
+*  bool enabled                     : true if DST is enabled
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_set_dst(const cy_stc_rtc_dst_t *dst_time, bool enabled)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    dst_rules = dst_time;
+    dst_enabled = enabled;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_count
+********************************************************************************
+* Summary:
+*  Returns the number of second ticks since boot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Tick count
+*
+*******************************************************************************/
+uint32_t rtc_tick_count(void)
+{
+    return tick_count;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_add_retries
+********************************************************************************
+* Summary:
+*  Counts the RTC writes that were tried again because the RTC was busy.
+*  Called by the retry loops of the application, not in an interrupt.
+*
+* Parameters:
+*  uint32_t retries : Attempts beyond the first one
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_add_retries(uint32_t retries)
+{
+    write_retries += retries;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_retries
+********************************************************************************
+* Summary:
+*  Returns the number of RTC writes tried again since boot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Retries
+*
+*******************************************************************************/
+uint32_t rtc_tick_retries(void)
+{
+    return write_retries;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_get_isr_cycles
+********************************************************************************
+* Summary:
+*  Returns the cost in CPU cycles of the RTC interrupt handler since boot,
+*  from the handler entry to its return. The hardware exception entry and
+*  exit are not included.
+*
+* Parameters:
+*  cycle_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_get_isr_cycles(cycle_stats_t *stats)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    *stats = isr_cycles;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/* [] END OF FILE */
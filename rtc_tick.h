@@ -0,0 +1,95 @@
+/******************************************************************************
+* File Name:   rtc_tick.h
+*
+* Description: This file contains the declarations of the RTC second tick and
+*              alarm interrupt handling.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RTC_TICK_H
+#define RTC_TICK_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "work_queue.h"
+#include "cycle_count.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Interrupt of the RTC (backup domain) */
+#if !defined(RTC_TICK_IRQ)
+#define RTC_TICK_IRQ                 (srss_interrupt_backup_IRQn)
+#endif
+
+#define RTC_TICK_IRQ_PRIORITY        (2u)
+
+/* Coalescing key of the tick work item: ticks that arrive while one is
+ * pending are merged */
+#define RTC_TICK_WORK_KEY            (0u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Called in the RTC interrupt with the tick count */
+typedef void (*rtc_tick_hook_t)(uint32_t tick);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_en_rtc_status_t rtc_tick_init(work_handler_t tick_handler);
+void rtc_tick_set_hook(rtc_tick_hook_t hook);
+void rtc_tick_set_dst(const cy_stc_rtc_dst_t *dst_time, bool enabled);
+uint32_t rtc_tick_count(void);
+void rtc_tick_add_retries(uint32_t retries);
+uint32_t rtc_tick_retries(void);
+void rtc_tick_get_isr_cycles(cycle_stats_t *stats);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* RTC_TICK_H */
+
+/* [] END OF FILE */
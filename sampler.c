@@ -0,0 +1,505 @@
+/******************************************************************************
+* File Name:   sampler.c
+*
+* Description: This file contains the sampling scheduler. The RTC interrupt reads the
+*              time of the second that starts, samples the channels due with phase 0
+*              and starts the SysTick as a 1 ms sub-second counter for the channels due
+*              later in the second. Each trigger is timed with the cycle counter from
+*              the RTC interrupt, which gives the delay after the nominal time and the
+*              period jitter. The samples are passed to a work item that appends them
+*              to the time-series store of the channel.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "sampler.h"
+#include "app_config.h"
+#include "rtc_tick.h"
+#include "rtc_snapshot.h"
+#include "time_utils.h"
+#include "work_queue.h"
+#include "cycle_count.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MS_PER_SECOND            (1000u)
+#define NS_PER_SECOND            (1000000000u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t epoch;
+    int32_t value;
+    uint8_t channel;
+} sample_t;
+
+typedef struct
+{
+    sampler_channel_config_t config;
+    sampler_stats_t stats;
+    uint64_t jitter_sq_sum;      /* Sum of the squared period errors, ns^2 */
+    int32_t last_delay_ns;
+    bool have_delay;
+} channel_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void on_second(uint32_t tick);
+static void on_subtick(void);
+static void store_samples(uint32_t arg);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static channel_t channels[SAMPLER_CHANNELS];
+
+/* Second in progress: RTC time, cycle count at the RTC interrupt, channels
+ * still due and milliseconds counted by the SysTick. When the CPU clock
+ * changes, second_cycles moves to the change and the time before it is kept
+ * in second_offset_ns. */
+static uint32_t second_epoch = 0u;
+static uint32_t second_cycles = 0u;
+static int32_t second_offset_ns = 0;
+static uint32_t due_mask = 0u;
+static uint32_t subtick_ms = 0u;
+
+/* Filled by the interrupts, emptied by the work item */
+static sample_t queue[SAMPLER_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0u;
+static volatile uint32_t queue_tail = 0u;
+
+/*******************************************************************************
+* Function Name: cycles_to_ns
+********************************************************************************
+* Summary:
+*  Converts a signed number of CPU cycles to nanoseconds.
+*
+* Parameters:
+*  int32_t cycles : CPU cycles
+*
+* Return:
+*  int32_t : Nanoseconds
+*
+*******************************************************************************/
+static int32_t cycles_to_ns(int32_t cycles)
+{
+    return (int32_t)(((int64_t)cycles * NS_PER_SECOND) / (int64_t)SystemCoreClock);
+}
+
+/*******************************************************************************
+* Function Name: isqrt
+********************************************************************************
+* Summary:
+*  Returns the integer square root, rounded down.
+*
+* Parameters:
+*  uint64_t value : Value
+*
+* Return:
+*  uint32_t : Square root
+*
+*******************************************************************************/
+static uint32_t isqrt(uint64_t value)
+{
+    uint64_t root = 0u;
+    uint64_t bit = (uint64_t)1u << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (0u != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+/*******************************************************************************
+* Function Name: trigger
+********************************************************************************
+* Summary:
+*  Acquires a sample of a channel, measures its delay after the nominal time
+*  and queues it for the work item. The period error is the change of the
+*  delay since the previous period: both delays are measured from an RTC
+*  interrupt, so the error of the CPU clock cancels out. Called from the
+*  RTC and SysTick interrupts.
+*
+* Parameters:
+*  uint32_t index : Channel to sample
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void trigger(uint32_t index)
+{
+    channel_t *channel = &channels[index];
+    sampler_stats_t *stats = &channel->stats;
+    uint32_t cycles = cycle_count_get();
+    int32_t value = channel->config.read(index);
+    int32_t delay_ns = second_offset_ns + cycles_to_ns((int32_t)(cycles - second_cycles)) -
+                       (int32_t)(channel->config.phase_ms * (NS_PER_SECOND / MS_PER_SECOND));
+    int32_t jitter_ns;
+
+    if (channel->have_delay && ((stats->last_epoch + channel->config.period_s) == second_epoch))
+    {
+        jitter_ns = delay_ns - channel->last_delay_ns;
+        if ((0u == stats->jitter_count) || (jitter_ns < stats->min_jitter_ns))
+        {
+            stats->min_jitter_ns = jitter_ns;
+        }
+        if ((0u == stats->jitter_count) || (jitter_ns > stats->max_jitter_ns))
+        {
+            stats->max_jitter_ns = jitter_ns;
+        }
+        channel->jitter_sq_sum += (uint64_t)((int64_t)jitter_ns * jitter_ns);
+        stats->jitter_count++;
+    }
+
+    if ((delay_ns > 0) && ((uint32_t)delay_ns > stats->max_latency_ns))
+    {
+        stats->max_latency_ns = (uint32_t)delay_ns;
+    }
+
+    channel->last_delay_ns = delay_ns;
+    channel->have_delay = true;
+    stats->samples++;
+    stats->last_epoch = second_epoch;
+    stats->last_value = value;
+
+    if ((queue_head - queue_tail) < SAMPLER_QUEUE_SIZE)
+    {
+        sample_t *sample = &queue[queue_head & (SAMPLER_QUEUE_SIZE - 1u)];
+
+        sample->epoch = second_epoch;
+        sample->value = value;
+        sample->channel = (uint8_t)index;
+        queue_head++;
+        (void)work_queue_post(WORK_PRIORITY_NORMAL, store_samples, 0u, SAMPLER_WORK_KEY);
+    }
+    else
+    {
+        stats->dropped++;
+    }
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: on_second
+********************************************************************************
+* Summary:
+*  RTC tick hook. Reads the time of the second that starts, samples the
+*  channels due with phase 0 and starts the sub-second counter for the
+*  others. Phases of the previous second that were not reached are counted
+*  as missed.
+*
+* Parameters:
+*  uint32_t tick : Tick count
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void on_second(uint32_t tick)
+{
+    rtc_snapshot_t snapshot;
+    cy_stc_rtc_config_t dateTime;
+    uint32_t index;
+
+    (void)tick;
+
+    second_cycles = cycle_count_get();
+    second_offset_ns = 0;
+    rtc_snapshot_read(&snapshot);
+    rtc_snapshot_decode(&snapshot, &dateTime);
+    second_epoch = time_utils_to_epoch(&dateTime);
+
+    Cy_SysTick_Disable();
+    for (index = 0u; index < SAMPLER_CHANNELS; index++)
+    {
+        if (0u != (due_mask & (1uL << index)))
+        {
+            channels[index].stats.missed++;
+        }
+    }
+    due_mask = 0u;
+
+    for (index = 0u; index < SAMPLER_CHANNELS; index++)
+    {
+        if ((0u != channels[index].config.period_s) &&
+            (0u == (second_epoch % channels[index].config.period_s)))
+        {
+            if (0u == channels[index].config.phase_ms)
+            {
+                trigger(index);
+            }
+            else
+            {
+                due_mask |= 1uL << index;
+            }
+        }
+    }
+
+    if (0u != due_mask)
+    {
+        subtick_ms = 0u;
+        Cy_SysTick_Clear();
+        Cy_SysTick_Enable();
+    }
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: on_subtick
+********************************************************************************
+* Summary:
+*  SysTick callback, every millisecond while channels are due. Samples the
+*  channels whose phase is reached and stops the counter after the last one.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void on_subtick(void)
+{
+    uint32_t index;
+
+    subtick_ms++;
+
+    for (index = 0u; index < SAMPLER_CHANNELS; index++)
+    {
+        if ((0u != (due_mask & (1uL << index))) &&
+            (channels[index].config.phase_ms <= subtick_ms))
+        {
+            due_mask &= ~(1uL << index);
+            trigger(index);
+        }
+    }
+
+    if (0u == due_mask)
+    {
+        Cy_SysTick_Disable();
+    }
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: store_samples
+********************************************************************************
+* Summary:
+*  Work item posted by the interrupts when samples are queued. Appends them
+*  to the time-series store of their channel.
+*
+* Parameters:
+*  uint32_t arg : Unused
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void store_samples(uint32_t arg)
+{
+    sample_t sample;
+    ts_store_t *store;
+    uint32_t interruptState;
+
+    (void)arg;
+
+    while (queue_tail != queue_head)
+    {
+        sample = queue[queue_tail & (SAMPLER_QUEUE_SIZE - 1u)];
+
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        queue_tail++;
+        store = channels[sample.channel].config.store;
+        Cy_SysLib_ExitCriticalSection(interruptState);
+
+        if (NULL != store)
+        {
+            (void)ts_store_append(store, sample.epoch, sample.value);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sampler_init
+********************************************************************************
+* Summary:
+*  Disables all channels, sets up the SysTick as the 1 ms sub-second counter
+*  (stopped until a channel is due) and registers the RTC tick hook.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sampler_init(void)
+{
+    memset(channels, 0, sizeof(channels));
+    due_mask = 0u;
+    queue_head = 0u;
+    queue_tail = 0u;
+
+    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU, (SystemCoreClock / MS_PER_SECOND) - 1u);
+    Cy_SysTick_Disable();
+    (void)Cy_SysTick_SetCallback(0u, on_subtick);
+    NVIC_SetPriority(SysTick_IRQn, SAMPLER_SUBTICK_IRQ_PRIORITY);
+
+    rtc_tick_set_hook(on_second);
+}
+
+/*******************************************************************************
+* Function Name: sampler_clock_changed
+********************************************************************************
+* Summary:
+*  Adapts the sampler to a new CPU clock: the SysTick reload keeps one
+*  millisecond, and the time since the second is carried over so that the
+*  delays measured in this second stay correct. Must be called with
+*  interrupts disabled, after SystemCoreClock has been updated.
+*
+* Parameters:
+*  uint32_t old_hz : CPU clock before the change
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sampler_clock_changed(uint32_t old_hz)
+{
+    uint32_t now = cycle_count_get();
+
+    second_offset_ns += (int32_t)(((uint64_t)(now - second_cycles) * NS_PER_SECOND) / old_hz);
+    second_cycles = now;
+
+    Cy_SysTick_SetReload((SystemCoreClock / MS_PER_SECOND) - 1u);
+}
+
+/*******************************************************************************
+* Function Name: sampler_configure
+********************************************************************************
+* Summary:
+*  Sets the schedule of a channel and clears its statistics. The change
+*  takes effect on the next RTC second.
+*
+* Parameters:
+*  uint32_t channel                       : Channel, below SAMPLER_CHANNELS
+*  const sampler_channel_config_t *config : Schedule, acquisition and store
+*
+* Return:
+*  bool : false if the configuration is invalid
+*
+*******************************************************************************/
+bool sampler_configure(uint32_t channel, const sampler_channel_config_t *config)
+{
+    uint32_t interruptState;
+
+    if ((channel >= SAMPLER_CHANNELS) || (config->phase_ms > SAMPLER_MAX_PHASE_MS) ||
+        ((0u != config->period_s) && (NULL == config->read)))
+    {
+        return false;
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    memset(&channels[channel], 0, sizeof(channels[channel]));
+    channels[channel].config = *config;
+    due_mask &= ~(1uL << channel);
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sampler_get_stats
+********************************************************************************
+* Summary:
+*  Returns a consistent copy of the statistics of a channel.
+*
+* Parameters:
+*  uint32_t channel        : Channel, below SAMPLER_CHANNELS
+*  sampler_stats_t *stats  : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sampler_get_stats(uint32_t channel, sampler_stats_t *stats)
+{
+    uint32_t interruptState;
+    uint64_t jitter_sq_sum;
+
+    if (channel >= SAMPLER_CHANNELS)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+    *stats = channels[channel].stats;
+    jitter_sq_sum = channels[channel].jitter_sq_sum;
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    stats->rms_jitter_ns = (0u != stats->jitter_count) ?
+                           isqrt(jitter_sq_sum / stats->jitter_count) : 0u;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   sampler.h
+*
+* Description: This file contains the declarations of the sampling scheduler, which
+*              triggers the channels on RTC second boundaries with sub-second phases.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "ts_store.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SAMPLER_CHANNELS             (4u)
+
+/* Samples passed from the interrupts to the work item, must be a power of
+ * two */
+#define SAMPLER_QUEUE_SIZE           (16u)
+
+/* Phases are counted in milliseconds after the RTC second */
+#define SAMPLER_MAX_PHASE_MS         (999u)
+
+/* The sub-second counter interrupt has the priority of the RTC tick, so
+ * neither preempts the other */
+#define SAMPLER_SUBTICK_IRQ_PRIORITY (2u)
+
+/* Coalescing key of the work item that stores the samples */
+#define SAMPLER_WORK_KEY             (2u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Performs an acquisition on a channel; called in interrupt context */
+typedef int32_t (*sampler_read_t)(uint32_t channel);
+
+typedef struct
+{
+    uint32_t period_s;           /* 0 disables the channel; the channel is sampled
+                                  * when the RTC time is a multiple of the period,
+                                  * so 60 samples on the minute */
+    uint32_t phase_ms;           /* Delay after the RTC second */
+    sampler_read_t read;
+    ts_store_t *store;           /* Receives the samples, can be NULL */
+} sampler_channel_config_t;
+
+typedef struct
+{
+    uint32_t samples;            /* Acquisitions */
+    uint32_t dropped;            /* Samples lost because the queue was full */
+    uint32_t missed;             /* Phases not reached before the next second */
+    uint32_t last_epoch;         /* RTC second of the last sample */
+    int32_t last_value;
+    uint32_t max_latency_ns;     /* Trigger delay after the nominal time */
+    int32_t min_jitter_ns;       /* Period error: change of the delay between */
+    int32_t max_jitter_ns;       /* consecutive samples */
+    uint32_t rms_jitter_ns;
+    uint32_t jitter_count;       /* Periods measured */
+} sampler_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void sampler_init(void);
+void sampler_clock_changed(uint32_t old_hz);
+bool sampler_configure(uint32_t channel, const sampler_channel_config_t *config);
+void sampler_get_stats(uint32_t channel, sampler_stats_t *stats);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SAMPLER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,202 @@
+/******************************************************************************
+* File Name:   time_utils.c
+*
+* Description: This file contains the calendar and epoch conversion helpers
+*              shared by the RTC based modules. The epoch used throughout the
+*              application is the number of seconds since 01/01/2000 00:00:00,
+*              which matches the year range of the RTC.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "time_utils.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DAYS_PER_YEAR            (365u)
+#define DAYS_PER_LEAP_YEAR       (366u)
+#define HOURS_PER_HALF_DAY       (12u)
+
+#define IS_LEAP_YEAR(year) \
+(((0U == ((year) % 4UL)) && (0U != ((year) % 100UL))) || (0U == ((year) % 400UL)))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Number of days before the first day of each month in a non-leap year */
+static const uint16_t days_before_month[CY_RTC_MONTHS_PER_YEAR] =
+{
+    0u, 31u, 59u, 90u, 120u, 151u, 181u, 212u, 243u, 273u, 304u, 334u
+};
+
+/*******************************************************************************
+* Function Name: time_utils_days_in_month
+********************************************************************************
+* Summary:
+*  Returns the number of days of the given month, taking leap years into
+*  account.
+*
+* Parameters:
+*  uint32_t month : Month, value range is 1-12
+*  uint32_t year  : Full year, for example 2024
+*
+* Return:
+*  uint32_t : Number of days in the month
+*
+*******************************************************************************/
+uint32_t time_utils_days_in_month(uint32_t month, uint32_t year)
+{
+    uint32_t days;
+
+    if (month == CY_RTC_MONTHS_PER_YEAR)
+    {
+        days = CY_RTC_DAYS_IN_DECEMBER;
+    }
+    else
+    {
+        days = (uint32_t)(days_before_month[month] - days_before_month[month - 1u]);
+    }
+
+    if ((2u == month) && IS_LEAP_YEAR(year))
+    {
+        days++;
+    }
+
+    return days;
+}
+
+/*******************************************************************************
+* Function Name: time_utils_to_epoch
+********************************************************************************
+* Summary:
+*  Converts an RTC date and time to the number of seconds elapsed since
+*  01/01/2000 00:00:00. Both the 24-hour and the 12-hour formats are supported.
+*
+* Parameters:
+*  const cy_stc_rtc_config_t *dateTime : Date and time read from the RTC
+*
+* Return:
+*  uint32_t : Seconds since the epoch
+*
+*******************************************************************************/
+uint32_t time_utils_to_epoch(const cy_stc_rtc_config_t *dateTime)
+{
+    uint32_t year = dateTime->year;
+    uint32_t hour = dateTime->hour;
+    uint32_t days;
+
+    if (CY_RTC_12_HOURS == dateTime->hrFormat)
+    {
+        hour %= HOURS_PER_HALF_DAY;
+        if (CY_RTC_PM == dateTime->amPm)
+        {
+            hour += HOURS_PER_HALF_DAY;
+        }
+    }
+
+    /* Every fourth year of the RTC range is a leap year, 2000 included */
+    days = (year * DAYS_PER_YEAR) + ((year + 3u) / 4u);
+    days += days_before_month[dateTime->month - 1u];
+    if ((dateTime->month > 2u) && IS_LEAP_YEAR(year + TIME_UTILS_BASE_YEAR))
+    {
+        days++;
+    }
+    days += dateTime->date - 1u;
+
+    return (days * TIME_UTILS_SEC_PER_DAY) + (hour * TIME_UTILS_SEC_PER_HOUR) +
+           (dateTime->min * TIME_UTILS_SEC_PER_MIN) + dateTime->sec;
+}
+
+/*******************************************************************************
+* Function Name: time_utils_from_epoch
+********************************************************************************
+* Summary:
+*  Converts the number of seconds elapsed since 01/01/2000 00:00:00 to an RTC
+*  date and time in the 24-hour format.
+*
+* Parameters:
+*  uint32_t epoch                 : Seconds since the epoch
+*  cy_stc_rtc_config_t *dateTime  : Converted date and time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void time_utils_from_epoch(uint32_t epoch, cy_stc_rtc_config_t *dateTime)
+{
+    uint32_t days = epoch / TIME_UTILS_SEC_PER_DAY;
+    uint32_t secs = epoch % TIME_UTILS_SEC_PER_DAY;
+    uint32_t year = 0u;
+    uint32_t month = 1u;
+    uint32_t year_days;
+    uint32_t month_days;
+
+    dateTime->hour = secs / TIME_UTILS_SEC_PER_HOUR;
+    secs %= TIME_UTILS_SEC_PER_HOUR;
+    dateTime->min = secs / TIME_UTILS_SEC_PER_MIN;
+    dateTime->sec = secs % TIME_UTILS_SEC_PER_MIN;
+    dateTime->hrFormat = CY_RTC_24_HOURS;
+    dateTime->amPm = CY_RTC_AM;
+
+    /* 01/01/2000 was a Saturday; the RTC numbers Sunday as 1 */
+    dateTime->dayOfWeek = ((days + 6u) % 7u) + 1u;
+
+    year_days = IS_LEAP_YEAR(year + TIME_UTILS_BASE_YEAR) ? DAYS_PER_LEAP_YEAR : DAYS_PER_YEAR;
+    while (days >= year_days)
+    {
+        days -= year_days;
+        year++;
+        year_days = IS_LEAP_YEAR(year + TIME_UTILS_BASE_YEAR) ? DAYS_PER_LEAP_YEAR : DAYS_PER_YEAR;
+    }
+
+    month_days = time_utils_days_in_month(month, year + TIME_UTILS_BASE_YEAR);
+    while (days >= month_days)
+    {
+        days -= month_days;
+        month++;
+        month_days = time_utils_days_in_month(month, year + TIME_UTILS_BASE_YEAR);
+    }
+
+    dateTime->year = year;
+    dateTime->month = month;
+    dateTime->date = days + 1u;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/******************************************************************************
+* File Name:   time_utils.h
+*
+* Description: This file contains the declarations of the calendar and epoch
+*              conversion helpers shared by the RTC based modules.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIME_UTILS_H
+#define TIME_UTILS_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* The RTC counts years from this base value (value range is 0-99) */
+#define TIME_UTILS_BASE_YEAR     (2000u)
+
+#define TIME_UTILS_SEC_PER_MIN   (60u)
+#define TIME_UTILS_SEC_PER_HOUR  (3600u)
+#define TIME_UTILS_SEC_PER_DAY   (86400u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t time_utils_to_epoch(const cy_stc_rtc_config_t *dateTime);
+void time_utils_from_epoch(uint32_t epoch, cy_stc_rtc_config_t *dateTime);
+uint32_t time_utils_days_in_month(uint32_t month, uint32_t year);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TIME_UTILS_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,429 @@
+/******************************************************************************
+* File Name:   timekeeping.c
+*
+* Description: This file contains the shadow time. The shadow is updated once per
+*              RTC second and carries a time-quality word (state, drift estimate
+*              and time since the last set or sync), so that readers get both
+*              values atomically without accessing the RTC.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "timekeeping.h"
+#include "time_utils.h"
+#include "event_log.h"
+#include "rtc_tick.h"
+#include "cycle_count.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_ATTEMPTS             (4u)    /* Maximum number of attempts for RTC operation */
+#define INIT_DELAY_MS            (5u)    /* delay 5 milliseconds before trying again */
+
+/* A step is only written this early in the RTC second, so that the second
+ * cannot end between the read and the write, retries included */
+#define STEP_WINDOW_MS           (500u)
+#define MS_PER_SECOND            (1000u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile time_reading_t shadow;
+
+/* Time of the last set or sync, used to age the quality word */
+static uint32_t last_sync_epoch;
+
+static const char * const state_names[] =
+{
+    "unset",
+    "manual",
+    "synced",
+    "holdover"
+};
+
+/*******************************************************************************
+* Function Name: make_quality
+********************************************************************************
+* Summary:
+*  Replaces the age field of a quality word with the minutes elapsed since the
+*  last set or sync.
+*
+* Parameters:
+*  uint32_t quality : Current quality word
+*  uint32_t epoch   : Current time in seconds since the epoch
+*
+* Return:
+*  uint32_t : Updated quality word
+*
+*******************************************************************************/
+static uint32_t make_quality(uint32_t quality, uint32_t epoch)
+{
+    uint32_t age = (epoch >= last_sync_epoch) ?
+                   ((epoch - last_sync_epoch) / TIME_UTILS_SEC_PER_MIN) : 0u;
+
+    if (age > TIME_QUALITY_AGE_MAX)
+    {
+        age = TIME_QUALITY_AGE_MAX;
+    }
+
+    return (quality & ~TIME_QUALITY_AGE_Msk) | (age << TIME_QUALITY_AGE_Pos);
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_init
+********************************************************************************
+* Summary:
+*  Initializes the shadow time after the RTC has been initialized with the
+*  design default. The quality starts as unset.
+*
+* Parameters:
+*  uint32_t epoch : RTC time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_init(uint32_t epoch)
+{
+    last_sync_epoch = epoch;
+    shadow.epoch = epoch;
+    shadow.quality = (uint32_t)TIME_QUALITY_UNSET << TIME_QUALITY_STATE_Pos;
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_on_tick
+********************************************************************************
+* Summary:
+*  Updates the shadow time on an RTC second tick and ages the quality word.
+*
+* Parameters:
+*  uint32_t epoch : RTC time in seconds since the epoch
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_on_tick(uint32_t epoch)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    shadow.epoch = epoch;
+    shadow.quality = make_quality(shadow.quality, epoch);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_get
+********************************************************************************
+* Summary:
+*  Returns the shadow time together with its quality word. The RTC is not
+*  accessed.
+*
+* Parameters:
+*  time_reading_t *reading : Destination of the reading
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_get(time_reading_t *reading)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    reading->epoch = shadow.epoch;
+    reading->quality = shadow.quality;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_set
+********************************************************************************
+* Summary:
+*  Records that the RTC has been written with a new time, either by an
+*  operator (TIME_QUALITY_MANUAL) or from a reference (TIME_QUALITY_SYNCED).
+*  Restarts the age of the quality word. A change of state is recorded in
+*  the event log.
+*
+* Parameters:
+*  uint32_t epoch             : Time written to the RTC
+*  time_quality_state_t state : New quality state
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_set(uint32_t epoch, time_quality_state_t state)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    time_quality_state_t previous = TIME_QUALITY_STATE(shadow.quality);
+
+    last_sync_epoch = epoch;
+    shadow.epoch = epoch;
+    shadow.quality = (shadow.quality & ~(TIME_QUALITY_STATE_Msk | TIME_QUALITY_AGE_Msk)) |
+                     ((uint32_t)state << TIME_QUALITY_STATE_Pos);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    if (previous != state)
+    {
+        event_log_add(EVENT_LOG_TIME_STATE, (int32_t)state);
+    }
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_set_state
+********************************************************************************
+* Summary:
+*  Changes the quality state without touching the time, for example when the
+*  reference is lost and the clock enters holdover. A change of state is
+*  recorded in the event log.
+*
+* Parameters:
+*  time_quality_state_t state : New quality state
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_set_state(time_quality_state_t state)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+    time_quality_state_t previous = TIME_QUALITY_STATE(shadow.quality);
+
+    shadow.quality = (shadow.quality & ~TIME_QUALITY_STATE_Msk) |
+                     ((uint32_t)state << TIME_QUALITY_STATE_Pos);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    if (previous != state)
+    {
+        event_log_add(EVENT_LOG_TIME_STATE, (int32_t)state);
+    }
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_set_drift
+********************************************************************************
+* Summary:
+*  Stores the current drift estimate in the quality word. The value is
+*  saturated to the range of the field.
+*
+* Parameters:
+*  int32_t drift_dppm : Drift estimate in units of 0.1 ppm
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_set_drift(int32_t drift_dppm)
+{
+    uint32_t interruptState;
+
+    if (drift_dppm > TIME_QUALITY_DRIFT_MAX)
+    {
+        drift_dppm = TIME_QUALITY_DRIFT_MAX;
+    }
+    else if (drift_dppm < -TIME_QUALITY_DRIFT_MAX)
+    {
+        drift_dppm = -TIME_QUALITY_DRIFT_MAX;
+    }
+
+    interruptState = Cy_SysLib_EnterCriticalSection();
+
+    shadow.quality = (shadow.quality & ~TIME_QUALITY_DRIFT_Msk) |
+                     (((uint32_t)drift_dppm << TIME_QUALITY_DRIFT_Pos) & TIME_QUALITY_DRIFT_Msk);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_step
+********************************************************************************
+* Summary:
+*  Moves the RTC by a number of whole seconds and updates the shadow time.
+*  The quality word is not changed.
+*
+*  The RTC is read, moved and written back, and a second that ended in
+*  between would be lost. The step is therefore refused later than
+*  STEP_WINDOW_MS after the last RTC interrupt, and the caller tries again
+*  on a later second. The time written counts the ticks since the read and
+*  is read back; a mismatch is written again. The attempts are limited to
+*  MAX_ATTEMPTS, as the step runs in the tick work item.
+*
+* Parameters:
+*  int32_t seconds : Correction, positive to move the RTC forward
+*
+* Return:
+*  cy_en_rtc_status_t : Status of the RTC write, CY_RTC_INVALID_STATE if the
+*                       second is too advanced or the time did not read back
+*
+*******************************************************************************/
+cy_en_rtc_status_t timekeeping_step(int32_t seconds)
+{
+    uint32_t attempts = MAX_ATTEMPTS;
+    uint32_t interruptState;
+    cy_en_rtc_status_t rtc_result;
+    cy_stc_rtc_config_t dateTime;
+    cy_stc_rtc_config_t readback;
+    cycle_stats_t isr;
+    uint32_t count;
+    uint32_t epoch;
+    uint32_t target;
+
+    rtc_tick_get_isr_cycles(&isr);
+    if ((0u != isr.count) &&
+        (((cycle_count_get() - isr.last_start) / (SystemCoreClock / MS_PER_SECOND)) >= STEP_WINDOW_MS))
+    {
+        return CY_RTC_INVALID_STATE;
+    }
+
+    count = rtc_tick_count();
+    Cy_RTC_GetDateAndTime(&dateTime);
+    epoch = time_utils_to_epoch(&dateTime) + (uint32_t)seconds;
+
+    /* The RTC might be busy, try again if necessary */
+    do
+    {
+        target = epoch + (rtc_tick_count() - count);
+        time_utils_from_epoch(target, &dateTime);
+        rtc_result = Cy_RTC_SetDateAndTime(&dateTime);
+
+        if (rtc_result == CY_RTC_SUCCESS)
+        {
+            Cy_RTC_GetDateAndTime(&readback);
+            target = epoch + (rtc_tick_count() - count);
+            if (time_utils_to_epoch(&readback) != target)
+            {
+                rtc_result = CY_RTC_INVALID_STATE;
+            }
+        }
+        attempts--;
+
+        if ((rtc_result != CY_RTC_SUCCESS) && (attempts != 0u))
+        {
+            Cy_SysLib_Delay(INIT_DELAY_MS);
+        }
+    } while ((rtc_result != CY_RTC_SUCCESS) && (attempts != 0u));
+
+    rtc_tick_add_retries(MAX_ATTEMPTS - attempts - 1u);
+
+    if (rtc_result == CY_RTC_SUCCESS)
+    {
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        shadow.epoch = target;
+        Cy_SysLib_ExitCriticalSection(interruptState);
+    }
+
+    return rtc_result;
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_state_name
+********************************************************************************
+* Summary:
+*  Returns a printable name of a quality state.
+*
+* Parameters:
+*  time_quality_state_t state : Quality state
+*
+* Return:
+*  const char* : Name of the state
+*
+*******************************************************************************/
+const char *timekeeping_state_name(time_quality_state_t state)
+{
+    const char *name = "?";
+
+    if ((uint32_t)state < (sizeof(state_names) / sizeof(state_names[0])))
+    {
+        name = state_names[state];
+    }
+
+    return name;
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_last_sync
+********************************************************************************
+* Summary:
+*  Returns the time of the last set or sync, kept across a warm reset.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Time in seconds since the epoch
+*
+*******************************************************************************/
+uint32_t timekeeping_last_sync(void)
+{
+    return last_sync_epoch;
+}
+
+/*******************************************************************************
+* Function Name: timekeeping_restore
+********************************************************************************
+* Summary:
+*  Restores the quality state and the time of the last set or sync after a
+*  warm reset, so that the age of the quality word continues from before the
+*  reset. A change of state is recorded in the event log.
+*
+* Parameters:
+*  time_quality_state_t state : Quality state before the reset
+*  uint32_t sync_epoch        : Time of the last set or sync
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timekeeping_restore(time_quality_state_t state, uint32_t sync_epoch)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    last_sync_epoch = sync_epoch;
+    shadow.quality = make_quality(shadow.quality, shadow.epoch);
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+
+    timekeeping_set_state(state);
+}
+
+/* [] END OF FILE */
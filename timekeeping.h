@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name:   timekeeping.h
+*
+* Description: This file contains the declarations of the shadow time and of the
+*              time-quality word served with every time reading.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMEKEEPING_H
+#define TIMEKEEPING_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Time-quality word layout:
+ *  [3:0]   time_quality_state_t
+ *  [15:4]  drift estimate, signed, in units of 0.1 ppm
+ *  [31:16] minutes since the last set or sync, saturated at 0xFFFF */
+#define TIME_QUALITY_STATE_Pos       (0u)
+#define TIME_QUALITY_STATE_Msk       (0x0000000Fu)
+#define TIME_QUALITY_DRIFT_Pos       (4u)
+#define TIME_QUALITY_DRIFT_Msk       (0x0000FFF0u)
+#define TIME_QUALITY_AGE_Pos         (16u)
+#define TIME_QUALITY_AGE_Msk         (0xFFFF0000u)
+
+#define TIME_QUALITY_DRIFT_MAX       (2047)
+#define TIME_QUALITY_AGE_MAX         (0xFFFFu)
+
+/* Field accessors for consumers of the quality word */
+#define TIME_QUALITY_STATE(word) \
+    ((time_quality_state_t)(((word) & TIME_QUALITY_STATE_Msk) >> TIME_QUALITY_STATE_Pos))
+#define TIME_QUALITY_DRIFT_DPPM(word) \
+    (((int32_t)((word) << 16u)) >> 20)
+#define TIME_QUALITY_AGE_MIN(word) \
+    (((word) & TIME_QUALITY_AGE_Msk) >> TIME_QUALITY_AGE_Pos)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    TIME_QUALITY_UNSET = 0,      /* Design default loaded at boot */
+    TIME_QUALITY_MANUAL,         /* Set by an operator */
+    TIME_QUALITY_SYNCED,         /* Set or corrected from a reference */
+    TIME_QUALITY_HOLDOVER        /* Reference lost, free running on the last drift */
+} time_quality_state_t;
+
+/* One time reading. The quality word is captured together with the time, so
+ * the pair is always consistent. The layout is fixed (8 bytes) so that it can
+ * be copied into binary frames as is. */
+typedef struct
+{
+    uint32_t epoch;      /* Seconds since 01/01/2000 00:00:00 */
+    uint32_t quality;    /* Time-quality word */
+} time_reading_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void timekeeping_init(uint32_t epoch);
+void timekeeping_on_tick(uint32_t epoch);
+void timekeeping_get(time_reading_t *reading);
+void timekeeping_set(uint32_t epoch, time_quality_state_t state);
+void timekeeping_set_state(time_quality_state_t state);
+void timekeeping_set_drift(int32_t drift_dppm);
+cy_en_rtc_status_t timekeeping_step(int32_t seconds);
+uint32_t timekeeping_last_sync(void);
+void timekeeping_restore(time_quality_state_t state, uint32_t sync_epoch);
+const char *timekeeping_state_name(time_quality_state_t state);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TIMEKEEPING_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,709 @@
+/******************************************************************************
+* File Name:   clock_model.c
+*
+* Description: This file contains the clock model of the host harness. It runs the time
+*              modules of the firmware in virtual time: the GPS time source, the
+*              discipline loop, the timekeeping and the holdover. The RTC runs at a
+*              chosen frequency error and the GPS sentences arrive with random latency.
+*              The served time is compared with the true time once per second.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "clock_model.h"
+#include "time_utils.h"
+#include "discipline.h"
+#include "holdover.h"
+#include "gps_time.h"
+#include "event_log.h"
+#include "cycle_count.h"
+#include <math.h>
+#include <stdio.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            HOST_HW_NS_PER_SECOND
+#define NS_PER_MS                CLOCK_MODEL_NS_PER_MS
+#define NS_PER_US                (1000LL)
+
+/* CPU clock of the firmware */
+#define CPU_HZ                   (180000000u)
+
+/* Delay of the tick work item after the RTC interrupt */
+#define TICK_ITEM_DELAY_NS       (50LL * NS_PER_US)
+
+/* Time of the GPS sentence after the start of the UTC second, stated in it */
+#define FIX_DELAY_MS             (100u)
+
+/* A sentence is received one character at a time, and waits in the RX
+ * queue for the RX work item after its last character */
+#define CHAR_NS                  ((10LL * NS_PER_SECOND) / GPS_TIME_BAUD_RATE)
+#define RX_QUEUE_DELAY_NS        (2LL * NS_PER_MS)
+
+/* The served time is compared with the true time at this point of the second */
+#define SAMPLE_DELAY_NS          (500LL * NS_PER_MS)
+
+/* A busy main loop starts this long after the second */
+#define BUSY_DELAY_NS            (200LL * NS_PER_MS)
+
+/* A warm reset happens this long after the second */
+#define RESET_DELAY_NS           (300LL * NS_PER_MS)
+
+/* Start of the runs: 01/03/2024 00:00:00 */
+#define START_YEAR               (2024u)
+#define START_MONTH              (3u)
+#define START_DAY                (1u)
+
+#define SENTENCE_SIZE            (48u)
+
+/* Length of the sentences, from the '$' to the line end: the fields have a
+ * fixed width */
+#define SENTENCE_LENGTH          (38)
+
+/* Time from the start of a sentence to the RX work item that feeds it */
+#define SENTENCE_FEED_NS         ((SENTENCE_LENGTH * CHAR_NS) + RX_QUEUE_DELAY_NS)
+
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* State of the run in progress */
+typedef struct
+{
+    scenario_t scenario;
+    result_t result;
+    uint32_t k;                  /* Next true second to run */
+    int64_t item_ns;             /* Pending tick work item, -1 for none */
+    int64_t busy_start_ns;
+    int64_t busy_end_ns;
+    int64_t reset_at_ns;         /* Time of the warm reset, -1 for none */
+    double steady_sum;
+    uint32_t steady_count;
+    int64_t last_served_ns;      /* Last served time read, -1 for none */
+    int64_t adjtime_base_ns;     /* Error when the adjustment was requested */
+    int64_t slew_start_ns;       /* First tick item after the request, -1 for none */
+    int64_t cancel_at_ns;        /* Time of the cancel, -1 for none */
+    int64_t slew_stop_ns;        /* First RTC second after the cancel, -1 for none */
+} model_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* True time of the start of the run, in seconds since the epoch */
+static uint32_t start_epoch = 0u;
+
+static model_t model;
+
+/*******************************************************************************
+* Function Name: feed_sentence
+********************************************************************************
+* Summary:
+*  Passes a $GPZDA sentence for a UTC time to the GPS time source, as the
+*  RX work item does SENTENCE_FEED_NS after the start of the sentence: each
+*  character with the cycle count of the interrupt that received it.
+*
+* Parameters:
+*  uint32_t epoch  : UTC second
+*  uint32_t millis : Fraction of the second stated in the sentence
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void feed_sentence(uint32_t epoch, uint32_t millis)
+{
+    cy_stc_rtc_config_t dateTime;
+    char sentence[SENTENCE_SIZE];
+    uint8_t checksum = 0u;
+    int length;
+    int i;
+
+    time_utils_from_epoch(epoch, &dateTime);
+    length = snprintf(sentence, sizeof(sentence), "$GPZDA,%02lu%02lu%02lu.%02lu,%02lu,%02lu,%04lu,00,00",
+                      (unsigned long)dateTime.hour, (unsigned long)dateTime.min,
+                      (unsigned long)dateTime.sec, (unsigned long)(millis / 10u),
+                      (unsigned long)dateTime.date, (unsigned long)dateTime.month,
+                      (unsigned long)(dateTime.year + 2000u));
+    for (i = 1; i < length; i++)
+    {
+        checksum ^= (uint8_t)sentence[i];
+    }
+    (void)snprintf(&sentence[length], sizeof(sentence) - (size_t)length, "*%02X\r\n", checksum);
+
+    for (i = 0; '\0' != sentence[i]; i++)
+    {
+        int64_t age_ns = SENTENCE_FEED_NS - ((int64_t)(i + 1) * CHAR_NS);
+
+        gps_time_feed_at(sentence[i], cycle_count_get() -
+                         (uint32_t)((age_ns * SystemCoreClock) / NS_PER_SECOND));
+    }
+}
+
+/*******************************************************************************
+* Function Name: run_tick_item
+********************************************************************************
+* Summary:
+*  Runs the time part of the tick work item of main.c.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_tick_item(void)
+{
+    cy_stc_rtc_config_t dateTime;
+    uint32_t epoch;
+
+    Cy_RTC_GetDateAndTime(&dateTime);
+    epoch = discipline_on_tick(time_utils_to_epoch(&dateTime));
+    timekeeping_on_tick(epoch);
+    holdover_on_tick(epoch);
+}
+
+/*******************************************************************************
+* Function Name: boot
+********************************************************************************
+* Summary:
+*  Initializes the time modules from the RTC, as main() does at power-up and
+*  after a warm reset.
+*
+* Parameters:
+*  bool warm_boot : true after a warm reset
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void boot(bool warm_boot)
+{
+    cy_stc_rtc_config_t dateTime;
+
+    Cy_RTC_GetDateAndTime(&dateTime);
+    timekeeping_init(time_utils_to_epoch(&dateTime));
+    discipline_init(time_utils_to_epoch(&dateTime));
+    gps_time_init();
+    holdover_init();
+    event_log_init(warm_boot);
+}
+
+/*******************************************************************************
+* Function Name: warm_reset
+********************************************************************************
+* Summary:
+*  Resets the time modules while the RTC keeps running. The state is kept
+*  as fault_recovery_reset() and restore_config() keep it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void warm_reset(void)
+{
+    discipline_retained_t loop;
+    time_reading_t reading;
+    uint32_t sync_epoch;
+
+    timekeeping_get(&reading);
+    sync_epoch = timekeeping_last_sync();
+    discipline_capture(&loop);
+
+    boot(true);
+
+    timekeeping_restore(TIME_QUALITY_STATE(reading.quality), sync_epoch);
+    discipline_restore(&loop);
+    holdover_restore(sync_epoch);
+}
+
+/*******************************************************************************
+* Function Name: served_ns
+********************************************************************************
+* Summary:
+*  Returns the served time since the start of the run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Served time in ns
+*
+*******************************************************************************/
+static int64_t served_ns(void)
+{
+    uint32_t sec;
+    uint32_t ns;
+
+    discipline_now(&sec, &ns);
+    return ((int64_t)(int32_t)(sec - start_epoch) * NS_PER_SECOND) + ns;
+}
+
+/*******************************************************************************
+* Function Name: served_error
+********************************************************************************
+* Summary:
+*  Returns the served time minus the true time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Error in ns
+*
+*******************************************************************************/
+static int64_t served_error(void)
+{
+    return served_ns() - host_hw_time();
+}
+
+/*******************************************************************************
+* Function Name: check_served
+********************************************************************************
+* Summary:
+*  Reads the served time and records how far it went back since the last
+*  reading. Called before and after each event, where the served time can
+*  jump; between the events, it is interpolated at a rate above zero.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void check_served(void)
+{
+    int64_t served;
+
+    if (!discipline_ready())
+    {
+        model.last_served_ns = -1;
+        return;
+    }
+
+    served = served_ns();
+    if ((model.last_served_ns >= 0) && ((model.last_served_ns - served) > model.result.backward_ns))
+    {
+        model.result.backward_ns = model.last_served_ns - served;
+    }
+    model.last_served_ns = served;
+}
+
+/*******************************************************************************
+* Function Name: adjtime_expected
+********************************************************************************
+* Summary:
+*  Returns the change of the served time that the adjustment of the scenario
+*  promises at the current time: none until the tick item that follows the
+*  request, then DISCIPLINE_ADJTIME_RATE_PPB until the adjustment is done,
+*  or until the RTC second that follows a cancel, which ends the slice of
+*  the current second.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Change of the served time in ns
+*
+*******************************************************************************/
+static int64_t adjtime_expected(void)
+{
+    int64_t target = (int64_t)model.scenario.adjtime_ms * NS_PER_MS;
+    int64_t magnitude = (target < 0) ? -target : target;
+    int64_t elapsed;
+    int64_t slewed;
+
+    if (model.slew_start_ns < 0)
+    {
+        return 0;
+    }
+
+    elapsed = ((model.slew_stop_ns >= 0) ? model.slew_stop_ns : host_hw_time()) - model.slew_start_ns;
+    slewed = (elapsed * DISCIPLINE_ADJTIME_RATE_PPB) / NS_PER_SECOND;
+    if (slewed > magnitude)
+    {
+        slewed = magnitude;
+    }
+
+    return (target < 0) ? -slewed : slewed;
+}
+
+/*******************************************************************************
+* Function Name: clock_model_start
+********************************************************************************
+* Summary:
+*  Starts a run: the virtual hardware starts at the true start time with the
+*  RTC offset and drift of the scenario, and the time modules are
+*  initialized as at power-up.
+*
+* Parameters:
+*  const scenario_t *scenario : Scenario to run, copied
+*  uint32_t seed              : Seed of the sentence latencies, 0 for the
+*                               default one
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void clock_model_start(const scenario_t *scenario, uint32_t seed)
+{
+    cy_stc_rtc_config_t start = { 0 };
+    int64_t rtc_start_ns;
+
+    start.year = START_YEAR - 2000u;
+    start.month = START_MONTH;
+    start.date = START_DAY;
+    start_epoch = time_utils_to_epoch(&start);
+
+    model = (model_t){ 0 };
+    model.scenario = *scenario;
+    model.item_ns = -1;
+    model.busy_start_ns = -1;
+    model.busy_end_ns = -1;
+    model.reset_at_ns = -1;
+    model.last_served_ns = -1;
+    model.slew_start_ns = -1;
+    model.cancel_at_ns = -1;
+    model.slew_stop_ns = -1;
+
+    rtc_start_ns = ((int64_t)start_epoch * NS_PER_SECOND) + scenario->rtc_offset_ns;
+    host_hw_init((uint32_t)(rtc_start_ns / NS_PER_SECOND), rtc_start_ns % NS_PER_SECOND,
+                 scenario->rtc_drift_ppb, CPU_HZ);
+    host_hw_seed(seed);
+    boot(false);
+}
+
+/*******************************************************************************
+* Function Name: clock_model_branch
+********************************************************************************
+* Summary:
+*  Replaces the scenario of the run in progress, so that a run restored from
+*  a snapshot continues as another scenario. The seconds already run must
+*  be the same in both: the new scenario may only differ in what happens
+*  after them, such as the end of the fixes, the drift change, a later warm
+*  reset, or the length of the run.
+*
+* Parameters:
+*  const scenario_t *scenario : Scenario to continue with, copied
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void clock_model_branch(const scenario_t *scenario)
+{
+    model.scenario = *scenario;
+}
+
+/*******************************************************************************
+* Function Name: clock_model_run
+********************************************************************************
+* Summary:
+*  Runs the scenario second by second, up to a true second or the end of the
+*  scenario. In each true second, the RTC edges and the tick work items run
+*  in time order with the GPS sentence, and the error is sampled in the
+*  middle of the second. While the main loop is busy, the tick work item
+*  waits and merges the ticks that arrive, as in the work queue, and the
+*  sentences are lost. A warm reset drops the pending tick work item, and
+*  the error is not sampled until the first RTC second after it. The served
+*  time is also read before and after each event, to find where it goes
+*  back, and an adjustment of the scenario is requested after the sample
+*  of its second.
+*
+* Parameters:
+*  uint32_t until_s : True second to stop at, not run
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void clock_model_run(uint32_t until_s)
+{
+    const scenario_t *scenario = &model.scenario;
+    result_t *result = &model.result;
+    discipline_stats_t loop;
+    time_reading_t reading;
+    int64_t fix_ns;
+    int64_t reset_ns;
+    int64_t sample_ns;
+    int64_t error;
+    int64_t magnitude;
+    int64_t deviation;
+    uint32_t bound;
+    uint32_t k;
+
+    if (until_s > scenario->total_s)
+    {
+        until_s = scenario->total_s;
+    }
+
+    for (; model.k < until_s; model.k++)
+    {
+        k = model.k;
+        fix_ns = ((int64_t)k * NS_PER_SECOND) + ((int64_t)FIX_DELAY_MS * NS_PER_MS) +
+                 ((int64_t)host_hw_gaussian(scenario->noise_us) * NS_PER_US) + SENTENCE_FEED_NS;
+        sample_ns = ((int64_t)k * NS_PER_SECOND) + SAMPLE_DELAY_NS;
+        reset_ns = ((0u != scenario->reset_s) && (k == scenario->reset_s)) ?
+                   (((int64_t)k * NS_PER_SECOND) + RESET_DELAY_NS) : -1;
+        if ((k == scenario->synced_s) && (0 != scenario->drift_change_ppb))
+        {
+            host_hw_set_drift(scenario->rtc_drift_ppb + scenario->drift_change_ppb);
+        }
+        if ((0u != scenario->busy_period_s) && (0u != k) && (0u == (k % scenario->busy_period_s)))
+        {
+            model.busy_start_ns = ((int64_t)k * NS_PER_SECOND) + BUSY_DELAY_NS;
+            model.busy_end_ns = model.busy_start_ns + ((int64_t)scenario->busy_ms * NS_PER_MS);
+        }
+
+        /* RTC edges and tick items before the sentence and the reset, then up
+         * to the sample */
+        for (;;)
+        {
+            int64_t limit = (fix_ns >= 0) ? fix_ns : ((reset_ns >= 0) ? reset_ns : sample_ns);
+
+            if ((model.item_ns >= 0) && (model.item_ns <= limit) &&
+                (model.item_ns <= host_hw_next_edge()))
+            {
+                host_hw_set_time(model.item_ns);
+                check_served();
+                if ((0 != scenario->adjtime_ms) && (k > scenario->adjtime_s) && (model.slew_start_ns < 0))
+                {
+                    model.slew_start_ns = model.item_ns;
+                }
+                run_tick_item();
+                check_served();
+                if ((model.reset_at_ns >= 0) && (0 == result->reset_ready_ns))
+                {
+                    result->reset_ready_ns = model.item_ns - model.reset_at_ns;
+                }
+                model.item_ns = -1;
+            }
+            else if (host_hw_next_edge() <= limit)
+            {
+                host_hw_set_time(host_hw_next_edge());
+                check_served();
+                if ((model.cancel_at_ns >= 0) && (model.slew_stop_ns < 0))
+                {
+                    model.slew_stop_ns = host_hw_time();
+                }
+                host_hw_rtc_edge();
+                check_served();
+                if (model.item_ns < 0)
+                {
+                    model.item_ns = host_hw_time() + TICK_ITEM_DELAY_NS;
+                    if ((model.item_ns >= model.busy_start_ns) && (model.item_ns < model.busy_end_ns))
+                    {
+                        model.item_ns = model.busy_end_ns;
+                    }
+                }
+            }
+            else if (fix_ns >= 0)
+            {
+                host_hw_set_time(fix_ns);
+                check_served();
+                if ((k < scenario->synced_s) &&
+                    ((fix_ns < model.busy_start_ns) || (fix_ns >= model.busy_end_ns)))
+                {
+                    feed_sentence(start_epoch + k, FIX_DELAY_MS);
+                }
+                check_served();
+                fix_ns = -1;
+            }
+            else if (reset_ns >= 0)
+            {
+                host_hw_set_time(reset_ns);
+                discipline_get_stats(&loop);
+                result->steps = loop.steps;
+                result->lock_time_s = loop.lock_time_s;
+                result->locked = loop.ever_locked;
+                warm_reset();
+                check_served();
+                model.item_ns = -1;
+                model.reset_at_ns = reset_ns;
+                reset_ns = -1;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        host_hw_set_time(sample_ns);
+        if (!discipline_ready())
+        {
+            continue;
+        }
+        error = served_error();
+        magnitude = (error < 0) ? -error : error;
+        discipline_get_stats(&loop);
+        timekeeping_get(&reading);
+
+        if ((model.reset_at_ns >= 0) && (k < scenario->synced_s) && !loop.locked)
+        {
+            result->reset_unlocked_s++;
+        }
+
+        if ((k < scenario->synced_s) && loop.locked)
+        {
+            model.steady_sum += (double)error * (double)error;
+            model.steady_count++;
+            if (magnitude > result->steady_max_ns)
+            {
+                result->steady_max_ns = magnitude;
+            }
+        }
+
+        if ((TIME_QUALITY_SYNCED == TIME_QUALITY_STATE(reading.quality)) &&
+            (magnitude > ((int64_t)holdover_error_bound_ms(reading.quality) * NS_PER_MS)))
+        {
+            result->synced_violations++;
+        }
+
+        /* The adjustment is requested and cancelled after the sample */
+        if ((0 != scenario->adjtime_ms) && (k == scenario->adjtime_s))
+        {
+            model.adjtime_base_ns = error;
+            (void)discipline_adjtime((int64_t)scenario->adjtime_ms * NS_PER_MS, NULL);
+        }
+        else if ((0 != scenario->adjtime_ms) && (k > scenario->adjtime_s))
+        {
+            deviation = error - model.adjtime_base_ns - adjtime_expected();
+            deviation = (deviation < 0) ? -deviation : deviation;
+            if (deviation > result->adjtime_max_dev_ns)
+            {
+                result->adjtime_max_dev_ns = deviation;
+            }
+            result->adjtime_applied_ns = error - model.adjtime_base_ns;
+            if ((0u == result->adjtime_done_s) && (0 == discipline_adjtime_remaining()))
+            {
+                result->adjtime_done_s = k - scenario->adjtime_s;
+            }
+        }
+        if ((0 != scenario->adjtime_ms) && (0u != scenario->cancel_s) && (k == scenario->cancel_s))
+        {
+            result->adjtime_left_ns = discipline_adjtime_cancel();
+            model.cancel_at_ns = sample_ns;
+        }
+
+        if (TIME_QUALITY_HOLDOVER == TIME_QUALITY_STATE(reading.quality))
+        {
+            bound = holdover_error_bound_ms(reading.quality);
+            result->holdover_s++;
+            result->final_bound_ms = bound;
+            if (magnitude > result->holdover_max_ns)
+            {
+                result->holdover_max_ns = magnitude;
+            }
+            if (magnitude > ((int64_t)bound * NS_PER_MS))
+            {
+                result->bound_violations++;
+            }
+            if (((double)magnitude / ((double)bound * NS_PER_MS)) > result->bound_used)
+            {
+                result->bound_used = (double)magnitude / ((double)bound * NS_PER_MS);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: clock_model_finish
+********************************************************************************
+* Summary:
+*  Returns the results of the run, up to the last second run.
+*
+* Parameters:
+*  result_t *result : Destination of the results
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void clock_model_finish(result_t *result)
+{
+    discipline_stats_t loop;
+    holdover_stats_t holdover;
+    time_reading_t reading;
+
+    discipline_get_stats(&loop);
+    holdover_get_stats(&holdover);
+    timekeeping_get(&reading);
+
+    *result = model.result;
+    result->steps += loop.steps;
+    if (model.reset_at_ns < 0)
+    {
+        result->lock_time_s = loop.lock_time_s;
+        result->locked = loop.ever_locked;
+    }
+    result->steady_rms_ns = (0u != model.steady_count) ?
+                            sqrt(model.steady_sum / model.steady_count) : 0.0;
+    result->holdover_entries = holdover.entries;
+    result->final_state = TIME_QUALITY_STATE(reading.quality);
+}
+
+/*******************************************************************************
+* Function Name: clock_model_run_scenario
+********************************************************************************
+* Summary:
+*  Runs a whole scenario with the default seed.
+*
+* Parameters:
+*  const scenario_t *scenario : Scenario to run
+*  result_t *result           : Destination of the results
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void clock_model_run_scenario(const scenario_t *scenario, result_t *result)
+{
+    clock_model_start(scenario, 0u);
+    clock_model_run(scenario->total_s);
+    clock_model_finish(result);
+}
+
+/* [] END OF FILE */
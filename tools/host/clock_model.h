@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name:   clock_model.h
+*
+* Description: This file contains the scenarios and the results of the clock model of
+*              the host harness, which runs the time modules of the firmware in
+*              virtual time.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CLOCK_MODEL_H
+#define CLOCK_MODEL_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "host_hw.h"
+#include "timekeeping.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CLOCK_MODEL_NS_PER_MS    (1000000LL)
+#define CLOCK_MODEL_SEC_PER_DAY  (86400u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    int32_t rtc_drift_ppb;       /* Frequency error of the RTC, positive if fast */
+    uint32_t noise_us;           /* Standard deviation of the sentence latency */
+    int64_t rtc_offset_ns;       /* RTC time minus true time at the start */
+    uint32_t synced_s;           /* Fixes are received for this time */
+    uint32_t total_s;            /* Length of the run */
+    uint32_t busy_period_s;      /* The main loop is busy once per period, 0 for never */
+    uint32_t busy_ms;            /* Length of the busy time */
+    uint32_t expected_steps;
+    uint32_t reset_s;            /* Second of a warm reset, 0 for none */
+    int32_t drift_change_ppb;    /* Change of the RTC drift when the fixes stop */
+    bool over_bound;             /* The error is expected to exceed the bound */
+    uint32_t adjtime_s;          /* Second of a discipline_adjtime() request, 0 for none */
+    int32_t adjtime_ms;          /* Adjustment requested */
+    uint32_t cancel_s;           /* Second at which it is cancelled, 0 for never */
+} scenario_t;
+
+typedef struct
+{
+    uint32_t steps;
+    uint32_t lock_time_s;
+    bool locked;
+    double steady_rms_ns;        /* While synced and locked */
+    int64_t steady_max_ns;
+    uint32_t synced_violations;  /* Seconds synced with the error above the bound */
+    uint32_t holdover_entries;
+    uint32_t holdover_s;         /* Seconds checked in holdover */
+    int64_t holdover_max_ns;     /* Largest error in holdover */
+    uint32_t final_bound_ms;     /* Error bound at the end of the run */
+    uint32_t bound_violations;   /* Seconds with the error above the bound */
+    double bound_used;           /* Largest ratio of the error to the bound */
+    int64_t reset_ready_ns;      /* From the warm reset to the first RTC second */
+    uint32_t reset_unlocked_s;   /* Seconds synced but unlocked after the warm reset */
+    int64_t backward_ns;         /* Largest step back of the served time */
+    int64_t adjtime_max_dev_ns;  /* Largest deviation from the promised slew */
+    int64_t adjtime_applied_ns;  /* Change of the error from the request to the end */
+    int64_t adjtime_left_ns;     /* Adjustment returned by the cancel */
+    uint32_t adjtime_done_s;     /* From the request until nothing remained */
+    time_quality_state_t final_state;
+} result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void clock_model_start(const scenario_t *scenario, uint32_t seed);
+void clock_model_branch(const scenario_t *scenario);
+void clock_model_run(uint32_t until_s);
+void clock_model_finish(result_t *result);
+void clock_model_run_scenario(const scenario_t *scenario, result_t *result);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CLOCK_MODEL_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,388 @@
+/******************************************************************************
+* File Name:   clock_sim.c
+*
+* Description: This file contains a host program that runs the scenarios of the
+*              clock model: the discipline loop with fixes, the holdover, changes of
+*              the RTC drift and warm resets. For each scenario the served time is
+*              compared with the true time once per second.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "clock_model.h"
+#include "host_snapshot.h"
+#include "discipline.h"
+#include <stdio.h>
+#include <time.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_MS                CLOCK_MODEL_NS_PER_MS
+#define SECONDS_PER_DAY          CLOCK_MODEL_SEC_PER_DAY
+
+#define SCENARIO_COUNT           (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/* Largest deviation of an adjustment from the promised slew: the rounding
+ * of the interpolation from the cycle counter */
+#define ADJTIME_TOLERANCE_NS     (10)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const scenario_t scenarios[] =
+{
+    /* name                 drift      noise  offset                synced              total                  busy         steps  reset                  change  over    adjtime  ms     cancel */
+    { "+20 ppm, 50 us",      20000,    50u,   0LL,                  3600u,              3600u,                 0u,   0u,    0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "-35 ppm, 200 us",    -35000,    200u,  150LL * NS_PER_MS,    3600u,              3600u,                 0u,   0u,    0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "3.4 s offset",        10000,    50u,   3400LL * NS_PER_MS,   3600u,              3600u,                 0u,   0u,    1u,    0u,                    0,      false,  0u,      0,     0u },
+    { "busy 2.5 s per min",  20000,    50u,   0LL,                  3600u,              3600u,                 60u,  2500u, 0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "busy, RTC at +0.89 s", -1,      50u,   890LL * NS_PER_MS,    7200u,              7200u,                 60u,  2500u, 0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "holdover +23.7 ppm",  23700,    50u,   200LL * NS_PER_MS,    SECONDS_PER_DAY,    4u * SECONDS_PER_DAY,  0u,   0u,    0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "holdover -41.3 ppm", -41300,    50u,   -300LL * NS_PER_MS,   SECONDS_PER_DAY,    4u * SECONDS_PER_DAY,  0u,   0u,    0u,    0u,                    0,      false,  0u,      0,     0u },
+    { "drift +1.8 ppm",      23700,    50u,   200LL * NS_PER_MS,    SECONDS_PER_DAY,    4u * SECONDS_PER_DAY,  0u,   0u,    0u,    0u,                    1800,   false,  0u,      0,     0u },
+    { "drift -1.8 ppm",     -41300,    50u,   -300LL * NS_PER_MS,   SECONDS_PER_DAY,    4u * SECONDS_PER_DAY,  0u,   0u,    0u,    0u,                    -1800,  false,  0u,      0,     0u },
+    { "drift +2.5 ppm",      23700,    50u,   200LL * NS_PER_MS,    SECONDS_PER_DAY,    4u * SECONDS_PER_DAY,  0u,   0u,    0u,    0u,                    2500,   true,   0u,      0,     0u },
+    { "reset while synced", -35000,    50u,   150LL * NS_PER_MS,    7200u,              7200u,                 0u,   0u,    0u,    3600u,                 0,      false,  0u,      0,     0u },
+    { "reset in holdover",   23700,    50u,   200LL * NS_PER_MS,    SECONDS_PER_DAY,    3u * SECONDS_PER_DAY,  0u,   0u,    0u,    2u * SECONDS_PER_DAY,  0,      false,  0u,      0,     0u },
+    { "adjtime +2.3 s",      0,        50u,   0LL,                  0u,                 7200u,                 0u,   0u,    0u,    0u,                    0,      false,  600u,    2300,  0u },
+    { "adjtime -1.234 s",    0,        50u,   0LL,                  0u,                 7200u,                 0u,   0u,    0u,    0u,                    0,      false,  600u,    -1234, 0u },
+    { "adjtime cancelled",   0,        50u,   0LL,                  0u,                 7200u,                 0u,   0u,    0u,    0u,                    0,      false,  600u,    2300,  1800u },
+};
+
+/*******************************************************************************
+* Function Name: elapsed_ms
+********************************************************************************
+* Summary:
+*  Returns the wall-clock time since a start.
+*
+* Parameters:
+*  const struct timespec *start : Start, from CLOCK_MONOTONIC
+*
+* Return:
+*  double : Milliseconds since the start
+*
+*******************************************************************************/
+static double elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)(now.tv_sec - start->tv_sec) * 1e3) +
+           ((double)(now.tv_nsec - start->tv_nsec) / 1e6);
+}
+
+/*******************************************************************************
+* Function Name: reset_before
+********************************************************************************
+* Summary:
+*  Returns the second of the warm reset of a scenario if it happens while
+*  synced, before a branch can be taken.
+*
+* Parameters:
+*  const scenario_t *scenario : Scenario
+*
+* Return:
+*  uint32_t : Second of the reset, 0 for none
+*
+*******************************************************************************/
+static uint32_t reset_before(const scenario_t *scenario)
+{
+    return (scenario->reset_s < scenario->synced_s) ? scenario->reset_s : 0u;
+}
+
+/*******************************************************************************
+* Function Name: same_results
+********************************************************************************
+* Summary:
+*  Compares the results of two runs. The runs are deterministic, so the
+*  results of a branched run must be exactly those of the full run.
+*
+* Parameters:
+*  const result_t *a : Results of a run
+*  const result_t *b : Results of the other run
+*
+* Return:
+*  bool : true if every result is the same
+*
+*******************************************************************************/
+static bool same_results(const result_t *a, const result_t *b)
+{
+    return (a->steps == b->steps) && (a->lock_time_s == b->lock_time_s) &&
+           (a->locked == b->locked) && (a->steady_rms_ns == b->steady_rms_ns) &&
+           (a->steady_max_ns == b->steady_max_ns) && (a->synced_violations == b->synced_violations) &&
+           (a->holdover_entries == b->holdover_entries) && (a->holdover_s == b->holdover_s) &&
+           (a->holdover_max_ns == b->holdover_max_ns) && (a->final_bound_ms == b->final_bound_ms) &&
+           (a->bound_violations == b->bound_violations) && (a->bound_used == b->bound_used) &&
+           (a->reset_ready_ns == b->reset_ready_ns) && (a->reset_unlocked_s == b->reset_unlocked_s) &&
+           (a->backward_ns == b->backward_ns) && (a->adjtime_max_dev_ns == b->adjtime_max_dev_ns) &&
+           (a->adjtime_applied_ns == b->adjtime_applied_ns) &&
+           (a->adjtime_left_ns == b->adjtime_left_ns) && (a->adjtime_done_s == b->adjtime_done_s) &&
+           (a->final_state == b->final_state);
+}
+
+/*******************************************************************************
+* Function Name: run_branches
+********************************************************************************
+* Summary:
+*  Runs the synced part of the first holdover scenario once, takes a
+*  snapshot at the end of the fixes, and runs from it every scenario with
+*  the same synced part. The snapshot goes through a file, and is restored
+*  before each branch. Each branch must give exactly the results of its
+*  full run.
+*
+* Parameters:
+*  const result_t *results : Results of the full runs
+*  const double *run_ms    : Wall-clock times of the full runs
+*
+* Return:
+*  bool : true if every branch gave the results of its full run
+*
+*******************************************************************************/
+static bool run_branches(const result_t *results, const double *run_ms)
+{
+    const scenario_t *base = NULL;
+    host_snapshot_t saved = { 0 };
+    host_snapshot_t loaded = { 0 };
+    struct timespec start;
+    result_t result;
+    FILE *file;
+    double prefix_ms;
+    double branches_ms = 0.0;
+    double full_ms = 0.0;
+    double restore_ms = 0.0;
+    uint32_t branches = 0u;
+    bool passed = true;
+    size_t i;
+
+    for (i = 0u; (i < SCENARIO_COUNT) && (NULL == base); i++)
+    {
+        if ((scenarios[i].synced_s < scenarios[i].total_s) && (0 == scenarios[i].adjtime_ms))
+        {
+            base = &scenarios[i];
+        }
+    }
+    if (NULL == base)
+    {
+        return true;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    clock_model_start(base, 0u);
+    clock_model_run(base->synced_s);
+    prefix_ms = elapsed_ms(&start);
+
+    file = tmpfile();
+    if ((NULL == file) || !host_snapshot_save(&saved) || !host_snapshot_write(&saved, file) ||
+        (0 != fseek(file, 0L, SEEK_SET)) || !host_snapshot_read(&loaded, file))
+    {
+        printf("snapshot: cannot save or load it: FAIL\n");
+        return false;
+    }
+    (void)fclose(file);
+
+    for (i = 0u; i < SCENARIO_COUNT; i++)
+    {
+        const scenario_t *scenario = &scenarios[i];
+
+        if ((scenario->rtc_drift_ppb != base->rtc_drift_ppb) || (scenario->noise_us != base->noise_us) ||
+            (scenario->rtc_offset_ns != base->rtc_offset_ns) || (scenario->synced_s != base->synced_s) ||
+            (scenario->busy_period_s != base->busy_period_s) || (scenario->busy_ms != base->busy_ms) ||
+            (reset_before(scenario) != reset_before(base)) || (scenario->total_s <= scenario->synced_s) ||
+            (0 != scenario->adjtime_ms))
+        {
+            continue;
+        }
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &start);
+        host_snapshot_restore(&loaded);
+        restore_ms += elapsed_ms(&start);
+        clock_model_branch(scenario);
+        clock_model_run(scenario->total_s);
+        clock_model_finish(&result);
+        branches_ms += elapsed_ms(&start);
+        full_ms += run_ms[i];
+        branches++;
+
+        if (!same_results(&result, &results[i]))
+        {
+            printf("snapshot: branch \"%s\" differs from its full run\n", scenario->name);
+            passed = false;
+        }
+    }
+
+    printf("snapshot of %lu bytes after %lu s of \"%s\", in %.1f ms: %lu branches in %.1f ms,\n"
+           "%-20s against %.1f ms for the full runs, restored in %.1f us each: %s\n",
+           (unsigned long)loaded.size, (unsigned long)base->synced_s, base->name, prefix_ms,
+           (unsigned long)branches, branches_ms, "", full_ms,
+           (0u != branches) ? ((restore_ms * 1e3) / branches) : 0.0, passed ? "PASS" : "FAIL");
+
+    host_snapshot_free(&saved);
+    host_snapshot_free(&loaded);
+
+    return passed;
+}
+
+/*******************************************************************************
+* Function Name: check_adjtime
+********************************************************************************
+* Summary:
+*  Checks and prints the results of an adjustment scenario. It fails if the
+*  served time went back, if it left the promised slew at
+*  DISCIPLINE_ADJTIME_RATE_PPB by more than ADJTIME_TOLERANCE_NS, or if it
+*  did not move by exactly the adjustment, less what a cancel returned.
+*
+* Parameters:
+*  const scenario_t *scenario : Scenario run
+*  const result_t *result     : Results of the run
+*
+* Return:
+*  bool : true if the adjustment passed
+*
+*******************************************************************************/
+static bool check_adjtime(const scenario_t *scenario, const result_t *result)
+{
+    int64_t target = ((int64_t)scenario->adjtime_ms * NS_PER_MS) - result->adjtime_left_ns;
+    bool passed = (0 == result->backward_ns) &&
+                  (result->adjtime_max_dev_ns <= ADJTIME_TOLERANCE_NS) &&
+                  (target == result->adjtime_applied_ns);
+
+    printf("%-20s slewed %+.6f ms of %+ld ms%s in %lu s, at up to %ld ns from %d ppm,\n"
+           "%-20s served time back by up to %ld ns: %s\n",
+           scenario->name, (double)result->adjtime_applied_ns / 1e6, (long)scenario->adjtime_ms,
+           (0u != scenario->cancel_s) ? " (cancelled)" : "", (unsigned long)result->adjtime_done_s,
+           (long)result->adjtime_max_dev_ns, DISCIPLINE_ADJTIME_RATE_PPB / 1000,
+           "", (long)result->backward_ns, passed ? "PASS" : "FAIL");
+
+    return passed;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs every scenario and prints its results. A run fails if the loop did
+*  not lock, if the number of steps is not the expected one, or if the
+*  error exceeded DISCIPLINE_LOCK_NS while locked. A holdover run also fails
+*  if the holdover was not entered or if the error exceeded the error bound,
+*  or, for a drift change beyond the uncertainty, if it never exceeded it,
+*  and a synced run with a warm reset fails if the loop lost its lock.
+*  The holdover scenarios are then run again from a snapshot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int : 0 if every scenario passed, 1 otherwise
+*
+*******************************************************************************/
+int main(void)
+{
+    result_t results[SCENARIO_COUNT];
+    double run_ms[SCENARIO_COUNT];
+    struct timespec start;
+    bool passed;
+    bool all_passed = true;
+    size_t i;
+
+    for (i = 0u; i < SCENARIO_COUNT; i++)
+    {
+        result_t result;
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &start);
+        clock_model_run_scenario(&scenarios[i], &result);
+        run_ms[i] = elapsed_ms(&start);
+        results[i] = result;
+
+        if (0 != scenarios[i].adjtime_ms)
+        {
+            passed = check_adjtime(&scenarios[i], &result);
+            all_passed = all_passed && passed;
+            continue;
+        }
+
+        passed = result.locked && (scenarios[i].expected_steps == result.steps) &&
+                 (result.steady_max_ns < DISCIPLINE_LOCK_NS);
+        if (scenarios[i].synced_s < scenarios[i].total_s)
+        {
+            /* The holdover statistics restart with a warm reset */
+            passed = passed && (TIME_QUALITY_HOLDOVER == result.final_state) &&
+                     ((0u != scenarios[i].reset_s) || (1u == result.holdover_entries)) &&
+                     ((0u != result.bound_violations) == scenarios[i].over_bound);
+        }
+        else if (0u != scenarios[i].reset_s)
+        {
+            passed = passed && (0u == result.reset_unlocked_s);
+        }
+        all_passed = all_passed && passed;
+
+        printf("%-20s steps %lu, lock after %lu s, synced RMS %.1f us (max %.1f us)%s\n",
+               scenarios[i].name, (unsigned long)result.steps,
+               result.locked ? (unsigned long)result.lock_time_s : 0uL, result.steady_rms_ns / 1000.0,
+               (double)result.steady_max_ns / 1000.0,
+               ((scenarios[i].synced_s < scenarios[i].total_s) || (0u != scenarios[i].reset_s)) ? "" :
+               (passed ? ": PASS" : ": FAIL"));
+        if ((0u != scenarios[i].reset_s) && (scenarios[i].synced_s < scenarios[i].total_s))
+        {
+            printf("%-20s warm reset: served again after %.1f ms\n",
+                   "", (double)result.reset_ready_ns / 1e6);
+        }
+        else if (0u != scenarios[i].reset_s)
+        {
+            printf("%-20s warm reset: served again after %.1f ms, unlocked for %lu s after it: %s\n",
+                   "", (double)result.reset_ready_ns / 1e6, (unsigned long)result.reset_unlocked_s,
+                   passed ? "PASS" : "FAIL");
+        }
+        if (scenarios[i].synced_s < scenarios[i].total_s)
+        {
+            printf("%-20s holdover %lu s, max error %.3f ms, final bound %lu ms, up to %.0f%% of the bound,\n"
+                   "%-20s over bound %lu s%s: %s\n",
+                   "", (unsigned long)result.holdover_s, (double)result.holdover_max_ns / 1e6,
+                   (unsigned long)result.final_bound_ms, result.bound_used * 100.0,
+                   "", (unsigned long)result.bound_violations,
+                   scenarios[i].over_bound ? " (expected)" : "", passed ? "PASS" : "FAIL");
+        }
+    }
+
+    all_passed = run_branches(results, run_ms) && all_passed;
+
+    return all_passed ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,227 @@
+/******************************************************************************
+* File Name:   cy_pdl.h
+*
+* Description: Host stand-in for the parts of the PDL used by the modules that the
+*              host harnesses build. Only the types, registers and functions those
+*              modules use are declared; the functions are implemented by host_hw.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Compiler and core macros */
+#define __STATIC_INLINE          static inline
+#define __STATIC_FORCEINLINE     static inline __attribute__((always_inline))
+#define CY_NOINLINE              __attribute__((noinline))
+#define CY_NOINIT
+#define CY_RAMFUNC_BEGIN
+#define CY_RAMFUNC_END
+
+#define __DMB()                  __sync_synchronize()
+#define __CLZ(x)                 ((uint8_t)__builtin_clz(x))
+
+/* Cycle counter enable bits */
+#define DWT_CTRL_CYCCNTENA_Msk         (1uL)
+#define CoreDebug_DEMCR_TRCENA_Msk     (1uL << 24)
+
+/* RTC ranges */
+#define CY_RTC_MAX_SEC_OR_MIN          (59u)
+#define CY_RTC_MAX_HOURS_24H           (23u)
+#define CY_RTC_MONTHS_PER_YEAR         (12u)
+#define CY_RTC_DAYS_IN_DECEMBER        (31u)
+
+/* Register fields */
+#define _FLD2VAL(field, value)         (((uint32_t)(value) & field ## _Msk) >> field ## _Pos)
+#define BACKUP_RTC_TIME_RTC_SEC_Pos    (0u)
+#define BACKUP_RTC_TIME_RTC_SEC_Msk    (0x0000007Fu)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+typedef enum
+{
+    CY_RTC_SUCCESS = 0,
+    CY_RTC_BAD_PARAM,
+    CY_RTC_TIMEOUT,
+    CY_RTC_INVALID_STATE,
+    CY_RTC_UNKNOWN
+} cy_en_rtc_status_t;
+
+typedef enum
+{
+    CY_RTC_24_HOURS = 0,
+    CY_RTC_12_HOURS
+} cy_en_rtc_hours_format_t;
+
+typedef enum
+{
+    CY_RTC_AM = 0,
+    CY_RTC_PM
+} cy_en_rtc_am_pm_t;
+
+typedef struct
+{
+    uint32_t sec;
+    uint32_t min;
+    uint32_t hour;
+    cy_en_rtc_hours_format_t hrFormat;
+    cy_en_rtc_am_pm_t amPm;
+    uint32_t dayOfWeek;
+    uint32_t date;
+    uint32_t month;
+    uint32_t year;
+} cy_stc_rtc_config_t;
+
+typedef struct
+{
+    uint32_t format;
+    uint32_t hour;
+    uint32_t dayOfMonth;
+    uint32_t weekOfMonth;
+    uint32_t dayOfWeek;
+    uint32_t month;
+} cy_stc_rtc_dst_format_t;
+
+typedef struct
+{
+    cy_stc_rtc_dst_format_t startDst;
+    cy_stc_rtc_dst_format_t stopDst;
+} cy_stc_rtc_dst_t;
+
+typedef enum
+{
+    SysTick_IRQn = -1
+} IRQn_Type;
+
+typedef enum
+{
+    CY_SYSTICK_CLOCK_SOURCE_CLK_LF = 0,
+    CY_SYSTICK_CLOCK_SOURCE_CLK_CPU = 4
+} cy_en_systick_clock_source_t;
+
+typedef void (*Cy_SysTick_Callback)(void);
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern uint32_t SystemCoreClock;
+extern DWT_Type *DWT;
+extern CoreDebug_Type *CoreDebug;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+/* The harnesses are single threaded: exclusive accesses always succeed and
+ * the critical sections only return a dummy state */
+__STATIC_INLINE uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    return *addr;
+}
+
+__STATIC_INLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    *addr = value;
+    return 0u;
+}
+
+__STATIC_INLINE void __CLREX(void)
+{
+}
+
+__STATIC_INLINE uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+__STATIC_INLINE void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    (void)IRQn;
+    (void)priority;
+}
+
+void Cy_SysLib_Delay(uint32_t milliseconds);
+void Cy_RTC_GetDateAndTime(cy_stc_rtc_config_t *dateTime);
+cy_en_rtc_status_t Cy_RTC_SetDateAndTime(const cy_stc_rtc_config_t *dateTime);
+void Cy_SysTick_Init(cy_en_systick_clock_source_t clockSource, uint32_t interval);
+void Cy_SysTick_Enable(void);
+void Cy_SysTick_Disable(void);
+void Cy_SysTick_Clear(void);
+void Cy_SysTick_SetReload(uint32_t value);
+Cy_SysTick_Callback Cy_SysTick_SetCallback(uint32_t number, Cy_SysTick_Callback function);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CY_PDL_H */
+
+/* [] END OF FILE */
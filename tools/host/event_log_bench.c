@@ -0,0 +1,449 @@
+/******************************************************************************
+* File Name:   event_log_bench.c
+*
+* Description: This file contains a host program that checks the range queries of
+*              event_log.c against a linear scan of the records appended, on logs of
+*              random sizes that wrap around the ring and clocks that are set back, and
+*              measures the cost of a query on a full log.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "event_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            (1000000000LL)
+
+/* Logs of random sizes, up to LOG_WRAPS times the capacity, and the random
+ * queries checked on each */
+#define LOGS                     (500u)
+#define LOG_WRAPS                (4u)
+#define QUERIES_PER_LOG          (100u)
+
+/* One record in SET_BACK_ODDS is older than the previous one, by up to
+ * SET_BACK_MAX_S */
+#define SET_BACK_ODDS            (50u)
+#define SET_BACK_MAX_S           (600u)
+
+/* Full log of the latency test: one record every FILL_STEP_S, as command 9
+ * fills it, and ranges of RANGE_S */
+#define FILL_STEP_S              (3u)
+#define RANGE_S                  (300u)
+#define TIMED_QUERIES            (100000u)
+
+/* Time of the first record: 01/03/2024 00:00:00 */
+#define START_EPOCH              (762566400u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Records returned by a query */
+typedef struct
+{
+    event_log_record_t *records;
+    uint32_t count;
+} collect_t;
+
+/* Cost of the queries on full logs */
+typedef struct
+{
+    uint32_t queries;
+    uint32_t max_probes;
+    uint32_t max_skipped;        /* Records read out of the range */
+    uint64_t skipped;
+} cost_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* State of the random generator */
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+* Function Name: random_next
+********************************************************************************
+* Summary:
+*  Returns a pseudo-random number (xorshift32).
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Random number
+*
+*******************************************************************************/
+static uint32_t random_next(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/*******************************************************************************
+* Function Name: now_ns
+********************************************************************************
+* Summary:
+*  Returns the time of a monotonic clock of the host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time in ns
+*
+*******************************************************************************/
+static int64_t now_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t)now.tv_sec * NS_PER_SECOND) + now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: collect_record
+********************************************************************************
+* Summary:
+*  Visitor of the checked queries: copies the record.
+*
+* Parameters:
+*  const event_log_record_t *record : Record in the range
+*  void *context                    : collect_t
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void collect_record(const event_log_record_t *record, void *context)
+{
+    collect_t *collect = (collect_t *)context;
+
+    collect->records[collect->count] = *record;
+    collect->count++;
+}
+
+/*******************************************************************************
+* Function Name: count_record
+********************************************************************************
+* Summary:
+*  Visitor of the timed queries: only counts the record.
+*
+* Parameters:
+*  const event_log_record_t *record : Record in the range
+*  void *context                    : uint32_t counter
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void count_record(const event_log_record_t *record, void *context)
+{
+    (void)record;
+    (*(uint32_t *)context)++;
+}
+
+/*******************************************************************************
+* Function Name: fill_log
+********************************************************************************
+* Summary:
+*  Clears the log and appends records at random intervals, some of them
+*  older than the previous one. The records are also kept in the reference,
+*  with the time the log gives them: the time of the previous record when
+*  they are older.
+*
+* Parameters:
+*  uint32_t count                : Records to append
+*  event_log_record_t *reference : Destination of the records appended
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void fill_log(uint32_t count, event_log_record_t *reference)
+{
+    uint32_t epoch = START_EPOCH;
+    uint32_t last = 0u;
+    uint32_t i;
+
+    event_log_clear();
+    for (i = 0u; i < count; i++)
+    {
+        if (0u == (random_next() % SET_BACK_ODDS))
+        {
+            epoch -= random_next() % SET_BACK_MAX_S;
+        }
+        else
+        {
+            epoch += random_next() % 20u;
+        }
+
+        reference[i].epoch = ((0u != i) && (epoch < last)) ? last : epoch;
+        reference[i].value = (int32_t)random_next();
+        reference[i].type = (uint8_t)(random_next() % (uint32_t)EVENT_LOG_TYPE_COUNT);
+        reference[i].flags = ((0u != i) && (epoch < last)) ? EVENT_LOG_FLAG_CLAMPED : 0u;
+        last = reference[i].epoch;
+
+        event_log_add_at(epoch, (event_log_type_t)reference[i].type, reference[i].value);
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_query
+********************************************************************************
+* Summary:
+*  Runs event_log_query() on a range and compares the records with a linear
+*  scan of the records appended, from the oldest one still in the ring.
+*
+* Parameters:
+*  const event_log_record_t *reference : Records appended
+*  uint32_t count                      : Number of records appended
+*  uint32_t start                      : Start of the range
+*  uint32_t end                        : End of the range
+*  collect_t *collect                  : Buffer for the results
+*  cost_t *cost                        : Cost of the query, updated on a full log
+*
+* Return:
+*  bool : true if the results match
+*
+*******************************************************************************/
+static bool check_query(const event_log_record_t *reference, uint32_t count, uint32_t start,
+                        uint32_t end, collect_t *collect, cost_t *cost)
+{
+    event_log_query_stats_t stats;
+    uint32_t oldest = (count > EVENT_LOG_CAPACITY) ? (count - EVENT_LOG_CAPACITY) : 0u;
+    uint32_t returned;
+    uint32_t expected = 0u;
+    bool match = true;
+    uint32_t i;
+
+    collect->count = 0u;
+    returned = event_log_query(start, end, collect_record, collect, &stats);
+
+    for (i = oldest; i < count; i++)
+    {
+        if ((reference[i].epoch >= start) && (reference[i].epoch <= end))
+        {
+            match = match && (expected < collect->count) &&
+                    (collect->records[expected].epoch == reference[i].epoch) &&
+                    (collect->records[expected].value == reference[i].value) &&
+                    (collect->records[expected].type == reference[i].type) &&
+                    (collect->records[expected].flags == reference[i].flags);
+            expected++;
+        }
+    }
+
+    if (count >= EVENT_LOG_CAPACITY)
+    {
+        cost->queries++;
+        cost->skipped += stats.scanned - stats.matches;
+        if (stats.probes > cost->max_probes)
+        {
+            cost->max_probes = stats.probes;
+        }
+        if ((stats.scanned - stats.matches) > cost->max_skipped)
+        {
+            cost->max_skipped = stats.scanned - stats.matches;
+        }
+    }
+
+    return match && (expected == collect->count) && (returned == collect->count) &&
+           (stats.matches == returned);
+}
+
+/*******************************************************************************
+* Function Name: time_queries
+********************************************************************************
+* Summary:
+*  Fills the log with records every FILL_STEP_S, as command 9 does, and
+*  times random ranges of RANGE_S with the index and with a linear scan
+*  from the oldest record.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void time_queries(void)
+{
+    uint32_t span = EVENT_LOG_CAPACITY * FILL_STEP_S;
+    uint32_t visited = 0u;
+    uint32_t scanned;
+    uint64_t linear_scanned = 0u;
+    uint32_t start;
+    int64_t begin;
+    int64_t lookup_ns;
+    int64_t query_ns;
+    int64_t linear_ns;
+    uint32_t i;
+
+    event_log_clear();
+    for (i = 0u; i < (EVENT_LOG_CAPACITY + (EVENT_LOG_CAPACITY / 2u)); i++)
+    {
+        event_log_add_at(START_EPOCH + (i * FILL_STEP_S), EVENT_LOG_TEST, (int32_t)i);
+    }
+
+    /* A range of one second costs the lookup and at most one record */
+    random_state = 7u;
+    begin = now_ns();
+    for (i = 0u; i < TIMED_QUERIES; i++)
+    {
+        start = START_EPOCH + ((EVENT_LOG_CAPACITY / 2u) * FILL_STEP_S) + (random_next() % span);
+        (void)event_log_query(start, start, count_record, &scanned, NULL);
+    }
+    lookup_ns = now_ns() - begin;
+
+    random_state = 7u;
+    begin = now_ns();
+    for (i = 0u; i < TIMED_QUERIES; i++)
+    {
+        start = START_EPOCH + ((EVENT_LOG_CAPACITY / 2u) * FILL_STEP_S) + (random_next() % span);
+        (void)event_log_query(start, start + RANGE_S - 1u, count_record, &visited, NULL);
+    }
+    query_ns = now_ns() - begin;
+
+    random_state = 7u;
+    begin = now_ns();
+    for (i = 0u; i < TIMED_QUERIES; i++)
+    {
+        start = START_EPOCH + ((EVENT_LOG_CAPACITY / 2u) * FILL_STEP_S) + (random_next() % span);
+        (void)event_log_linear_lookup_cycles(start, &scanned);
+        linear_scanned += scanned;
+    }
+    linear_ns = now_ns() - begin;
+
+    printf("full log, a record every %lu s, ranges of %lu s: %.1f records per range\n",
+           (unsigned long)FILL_STEP_S, (unsigned long)RANGE_S, (double)visited / TIMED_QUERIES);
+    printf("  lookup with the index %.0f ns, query %.0f ns including the records returned\n",
+           (double)lookup_ns / TIMED_QUERIES, (double)query_ns / TIMED_QUERIES);
+    printf("  lookup by a linear scan %.0f ns, %.0f records read on average\n",
+           (double)linear_ns / TIMED_QUERIES, (double)linear_scanned / TIMED_QUERIES);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Checks LOGS logs of random sizes with QUERIES_PER_LOG random ranges
+*  each, then times the queries on a full log.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int : 0 if every query matched the linear scan, 1 otherwise
+*
+*******************************************************************************/
+int main(void)
+{
+    event_log_record_t *reference;
+    collect_t collect;
+    cost_t cost = { 0 };
+    uint32_t failures = 0u;
+    uint32_t count;
+    uint32_t first;
+    uint32_t last;
+    uint32_t span;
+    uint32_t a;
+    uint32_t b;
+    uint32_t log;
+    uint32_t i;
+
+    reference = malloc(LOG_WRAPS * EVENT_LOG_CAPACITY * sizeof(event_log_record_t));
+    collect.records = malloc(EVENT_LOG_CAPACITY * sizeof(event_log_record_t));
+    if ((NULL == reference) || (NULL == collect.records))
+    {
+        return 1;
+    }
+
+    printf("%lu records in blocks of %lu, %lu logs of up to %lu records, %lu queries per log\n",
+           (unsigned long)EVENT_LOG_CAPACITY, (unsigned long)EVENT_LOG_BLOCK_SIZE,
+           (unsigned long)LOGS, (unsigned long)(LOG_WRAPS * EVENT_LOG_CAPACITY),
+           (unsigned long)QUERIES_PER_LOG);
+
+    for (log = 0u; log < LOGS; log++)
+    {
+        /* Every tenth log is exactly full, or full and one block more */
+        count = 1u + (random_next() % (LOG_WRAPS * EVENT_LOG_CAPACITY));
+        if (0u == (log % 10u))
+        {
+            count = EVENT_LOG_CAPACITY + (((log / 10u) % 2u) * EVENT_LOG_BLOCK_SIZE);
+        }
+        fill_log(count, reference);
+
+        first = reference[(count > EVENT_LOG_CAPACITY) ? (count - EVENT_LOG_CAPACITY) : 0u].epoch;
+        last = reference[count - 1u].epoch;
+        span = (last - first) + 1u;
+        for (i = 0u; i < QUERIES_PER_LOG; i++)
+        {
+            /* Ranges also start before the oldest record and end after the
+             * newest one */
+            a = (first - (span / 10u)) + (random_next() % (span + (span / 5u)));
+            b = (first - (span / 10u)) + (random_next() % (span + (span / 5u)));
+            failures += check_query(reference, count, (a < b) ? a : b, (a < b) ? b : a,
+                                    &collect, &cost) ? 0u : 1u;
+        }
+    }
+
+    printf("full logs: up to %lu index entries compared, up to %lu records read out of the range,"
+           " %.1f on average\n", (unsigned long)cost.max_probes, (unsigned long)cost.max_skipped,
+           (0u != cost.queries) ? ((double)cost.skipped / cost.queries) : 0.0);
+
+    time_queries();
+
+    printf("%lu queries checked against a linear scan, %lu mismatches: %s\n",
+           (unsigned long)(LOGS * QUERIES_PER_LOG), (unsigned long)failures,
+           (0u == failures) ? "PASS" : "FAIL");
+
+    free(reference);
+    free(collect.records);
+
+    return (0u == failures) ? 0 : 1;
+}
+
+/* [] END OF FILE */
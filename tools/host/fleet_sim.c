@@ -0,0 +1,340 @@
+/******************************************************************************
+* File Name:   fleet_sim.c
+*
+* Description: This file contains a host program that runs the clock model for a fleet
+*              of boards, each with its own RTC drift, offset, sentence latency, busy
+*              main loop, warm reset and change of drift in holdover. The boards are
+*              shared among worker processes, one per CPU core by default, and the
+*              program reports the simulated board-seconds per wall-clock second.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "clock_model.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            HOST_HW_NS_PER_SECOND
+#define NS_PER_MS                CLOCK_MODEL_NS_PER_MS
+
+/* Defaults of the command line */
+#define DEFAULT_BOARDS           (64u)
+#define DEFAULT_HOURS            (12u)
+
+/* Range of the board parameters */
+#define MAX_DRIFT_PPB            (50000u)
+#define MIN_NOISE_US             (20u)
+#define MAX_NOISE_US             (200u)
+#define MAX_OFFSET_MS            (900u)
+#define MAX_DRIFT_CHANGE_PPB     (800u)
+
+/* One board in BUSY_BOARDS has a busy main loop, one in RESET_BOARDS a warm
+ * reset */
+#define BUSY_BOARDS              (4u)
+#define RESET_BOARDS             (8u)
+
+/* Failed boards listed in detail */
+#define MAX_LISTED               (10u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    scenario_t scenario;
+    result_t result;
+    uint32_t worker;
+    bool passed;
+} board_t;
+
+/* Shared by the worker processes: the next board to run and the results */
+typedef struct
+{
+    atomic_uint next;
+    board_t boards[];
+} fleet_t;
+
+/*******************************************************************************
+* Function Name: board_random
+********************************************************************************
+* Summary:
+*  Returns a pseudo-random number of the parameter sequence of a board.
+*
+* Parameters:
+*  uint32_t *state : State of the sequence, not 0
+*
+* Return:
+*  uint32_t : Random number
+*
+*******************************************************************************/
+static uint32_t board_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/*******************************************************************************
+* Function Name: make_board
+********************************************************************************
+* Summary:
+*  Draws the parameters of a board from its index, so that a board runs the
+*  same whatever the worker. The fixes stop in the middle of the run.
+*
+* Parameters:
+*  uint32_t index        : Index of the board
+*  uint32_t total_s      : Length of the run
+*  scenario_t *scenario  : Destination of the parameters
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void make_board(uint32_t index, uint32_t total_s, scenario_t *scenario)
+{
+    uint32_t state = 0x9E3779B9u ^ (index * 0x85EBCA6Bu);
+
+    (void)board_random(&state);
+    *scenario = (scenario_t){ 0 };
+    scenario->name = "board";
+    scenario->rtc_drift_ppb = (int32_t)(board_random(&state) % ((2u * MAX_DRIFT_PPB) + 1u)) -
+                              (int32_t)MAX_DRIFT_PPB;
+    scenario->noise_us = MIN_NOISE_US + (board_random(&state) % (MAX_NOISE_US - MIN_NOISE_US + 1u));
+    scenario->rtc_offset_ns = ((int64_t)(board_random(&state) % ((2u * MAX_OFFSET_MS) + 1u)) -
+                               (int64_t)MAX_OFFSET_MS) * NS_PER_MS;
+    scenario->synced_s = total_s / 2u;
+    scenario->total_s = total_s;
+    scenario->drift_change_ppb = (int32_t)(board_random(&state) % ((2u * MAX_DRIFT_CHANGE_PPB) + 1u)) -
+                                 (int32_t)MAX_DRIFT_CHANGE_PPB;
+    if (0u == (index % BUSY_BOARDS))
+    {
+        scenario->busy_period_s = 60u;
+        scenario->busy_ms = 2500u;
+    }
+    if (1u == (index % RESET_BOARDS))
+    {
+        scenario->reset_s = total_s / 4u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: run_worker
+********************************************************************************
+* Summary:
+*  Takes the next board from the shared counter and runs it, until every
+*  board has been taken. A worker that draws short runs takes more boards,
+*  so the load stays balanced without a fixed split.
+*
+* Parameters:
+*  fleet_t *fleet    : Shared state
+*  uint32_t boards   : Number of boards
+*  uint32_t total_s  : Length of each run
+*  uint32_t worker   : Index of the worker
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_worker(fleet_t *fleet, uint32_t boards, uint32_t total_s, uint32_t worker)
+{
+    board_t *board;
+    uint32_t index;
+
+    for (;;)
+    {
+        index = atomic_fetch_add(&fleet->next, 1u);
+        if (index >= boards)
+        {
+            break;
+        }
+
+        board = &fleet->boards[index];
+        make_board(index, total_s, &board->scenario);
+        clock_model_start(&board->scenario, index + 1u);
+        clock_model_run(total_s);
+        clock_model_finish(&board->result);
+
+        board->worker = worker;
+        board->passed = board->result.locked &&
+                        (0u == board->result.synced_violations) &&
+                        (TIME_QUALITY_HOLDOVER == board->result.final_state) &&
+                        (0u == board->result.bound_violations) &&
+                        (0u == board->result.reset_unlocked_s);
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the fleet. The board state of the firmware modules is static, one
+*  instance per process, so each worker is a process that runs one board at
+*  a time. A board fails if the loop did not lock, if the error exceeded the
+*  error bound, synced or in holdover, or if the loop lost its lock after a
+*  warm reset.
+*
+* Parameters:
+*  int argc    : Number of arguments
+*  char **argv : [boards [workers [hours]]]
+*
+* Return:
+*  int : 0 if every board passed, 1 otherwise
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint32_t boards = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_BOARDS;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t workers = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) :
+                       ((cores > 0) ? (uint32_t)cores : 1u);
+    uint32_t total_s = ((argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : DEFAULT_HOURS) * 3600u;
+    size_t size;
+    fleet_t *fleet;
+    struct timespec begin;
+    struct timespec end;
+    double wall_s;
+    double worst_steady = 0.0;
+    double worst_bound = 0.0;
+    uint32_t slowest_lock = 0u;
+    uint32_t slowest_board = 0u;
+    uint32_t failed = 0u;
+    uint32_t worker;
+    uint32_t i;
+    pid_t pid;
+
+    if ((0u == boards) || (0u == workers) || (0u == total_s))
+    {
+        fprintf(stderr, "usage: %s [boards [workers [hours]]]\n", argv[0]);
+        return 1;
+    }
+
+    size = sizeof(fleet_t) + ((size_t)boards * sizeof(board_t));
+    fleet = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == fleet)
+    {
+        perror("mmap");
+        return 1;
+    }
+    atomic_init(&fleet->next, 0u);
+
+    printf("%lu boards of %lu hours on %lu workers (%ld cores)\n", (unsigned long)boards,
+           (unsigned long)(total_s / 3600u), (unsigned long)workers, cores);
+    fflush(stdout);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (worker = 0u; worker < workers; worker++)
+    {
+        pid = fork();
+        if (0 == pid)
+        {
+            run_worker(fleet, boards, total_s, worker);
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+    }
+    while (wait(NULL) > 0)
+    {
+        /* Wait for every worker */
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    wall_s = (double)(end.tv_sec - begin.tv_sec) + ((double)(end.tv_nsec - begin.tv_nsec) / 1e9);
+
+    for (i = 0u; i < boards; i++)
+    {
+        const board_t *board = &fleet->boards[i];
+
+        if (!board->passed)
+        {
+            if (failed < MAX_LISTED)
+            {
+                printf("board %lu FAIL: drift %ld ppb, noise %lu us, offset %lld ms, change %ld ppb,"
+                       " steady max %.1f us, %lu s synced and %lu s in holdover over bound\n",
+                       (unsigned long)i, (long)board->scenario.rtc_drift_ppb,
+                       (unsigned long)board->scenario.noise_us,
+                       (long long)(board->scenario.rtc_offset_ns / NS_PER_MS),
+                       (long)board->scenario.drift_change_ppb,
+                       (double)board->result.steady_max_ns / 1000.0,
+                       (unsigned long)board->result.synced_violations,
+                       (unsigned long)board->result.bound_violations);
+            }
+            failed++;
+        }
+        if ((double)board->result.steady_max_ns > worst_steady)
+        {
+            worst_steady = (double)board->result.steady_max_ns;
+        }
+        if (board->result.bound_used > worst_bound)
+        {
+            worst_bound = board->result.bound_used;
+        }
+        if (board->result.lock_time_s > slowest_lock)
+        {
+            slowest_lock = board->result.lock_time_s;
+            slowest_board = i;
+        }
+    }
+
+    printf("slowest lock %lu s (board %lu), worst synced error %.1f us,"
+           " holdover error up to %.0f%% of the bound\n",
+           (unsigned long)slowest_lock, (unsigned long)slowest_board, worst_steady / 1000.0,
+           worst_bound * 100.0);
+    printf("%.0f board-seconds in %.2f s: %.0f board-seconds per second\n",
+           (double)boards * total_s, wall_s, ((double)boards * total_s) / wall_s);
+    printf("%lu of %lu boards passed: %s\n", (unsigned long)(boards - failed),
+           (unsigned long)boards, (0u == failed) ? "PASS" : "FAIL");
+
+    (void)munmap(fleet, size);
+
+    return (0u == failed) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,680 @@
+/******************************************************************************
+* File Name:   host_hw.c
+*
+* Description: This file contains the virtual hardware of the host harnesses. The
+*              time only moves when the harness sets it. The cycle counter follows
+*              the time at the CPU clock, and the RTC counts its seconds at a
+*              frequency error given in ppb. The functions of rtc_tick.c that the
+*              modules call are replaced here, so no interrupt is involved.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "host_hw.h"
+#include "rtc_snapshot.h"
+#include "time_utils.h"
+#include <math.h>
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+uint32_t SystemCoreClock = 0u;
+
+static DWT_Type dwt;
+static CoreDebug_Type core_debug;
+DWT_Type *DWT = &dwt;
+CoreDebug_Type *CoreDebug = &core_debug;
+
+/* Time since the start of the run */
+static int64_t time_ns = 0;
+
+/* Seconds shown by the RTC, the true time of its first edge and its period */
+static uint32_t rtc_epoch = 0u;
+static double rtc_first_edge_ns = 0.0;
+static double rtc_period_ns = 0.0;
+static uint32_t rtc_edges = 0u;
+
+/* SysTick: reload value, callback and time of the next interrupt, -1 while
+ * it is disabled */
+static uint32_t systick_reload = 0u;
+static Cy_SysTick_Callback systick_callback = NULL;
+static int64_t systick_next_ns = -1;
+
+/* State of the replaced rtc_tick.c */
+static cycle_stats_t isr_cycles;
+static rtc_tick_hook_t tick_hook = NULL;
+static uint32_t retries = 0u;
+
+/* State of the random generator */
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+* Function Name: host_hw_init
+********************************************************************************
+* Summary:
+*  Starts the virtual hardware at time 0.
+*
+* Parameters:
+*  uint32_t rtc_epoch     : Seconds shown by the RTC at time 0
+*  int64_t rtc_phase_ns   : Time already elapsed in that RTC second, 0 to
+*                           999999999
+*  int32_t rtc_drift_ppb  : Frequency error of the RTC, positive if it runs
+*                           fast
+*  uint32_t cpu_hz        : CPU clock
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_init(uint32_t rtc_epoch_at_0, int64_t rtc_phase_ns, int32_t rtc_drift_ppb,
+                  uint32_t cpu_hz)
+{
+    time_ns = 0;
+    rtc_epoch = rtc_epoch_at_0;
+    rtc_period_ns = (double)HOST_HW_NS_PER_SECOND /
+                    (1.0 + ((double)rtc_drift_ppb / (double)HOST_HW_NS_PER_SECOND));
+    rtc_first_edge_ns = ((double)(HOST_HW_NS_PER_SECOND - rtc_phase_ns) * rtc_period_ns) /
+                        (double)HOST_HW_NS_PER_SECOND;
+    rtc_edges = 0u;
+    SystemCoreClock = cpu_hz;
+    dwt.CYCCNT = 0u;
+    systick_reload = 0u;
+    systick_callback = NULL;
+    systick_next_ns = -1;
+    isr_cycles = (cycle_stats_t){ 0 };
+    tick_hook = NULL;
+    retries = 0u;
+    random_state = 1u;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_set_time
+********************************************************************************
+* Summary:
+*  Moves the time forward and the cycle counter with it. The RTC edges are
+*  not processed; the harness calls host_hw_rtc_edge() for each of them.
+*
+* Parameters:
+*  int64_t new_time_ns : Time since the start of the run
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_set_time(int64_t new_time_ns)
+{
+    if (new_time_ns > time_ns)
+    {
+        time_ns = new_time_ns;
+    }
+    dwt.CYCCNT = (uint32_t)(((__int128)time_ns * SystemCoreClock) / HOST_HW_NS_PER_SECOND);
+}
+
+/*******************************************************************************
+* Function Name: host_hw_time
+********************************************************************************
+* Summary:
+*  Returns the time since the start of the run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time in ns
+*
+*******************************************************************************/
+int64_t host_hw_time(void)
+{
+    return time_ns;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_next_edge
+********************************************************************************
+* Summary:
+*  Returns the time of the next second of the RTC.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time in ns
+*
+*******************************************************************************/
+int64_t host_hw_next_edge(void)
+{
+    return (int64_t)llround(rtc_first_edge_ns + ((double)rtc_edges * rtc_period_ns));
+}
+
+/*******************************************************************************
+* Function Name: host_hw_set_drift
+********************************************************************************
+* Summary:
+*  Changes the frequency error of the RTC, as a temperature change would.
+*  The next second of the RTC keeps its time; the new period applies to the
+*  seconds after it.
+*
+* Parameters:
+*  int32_t rtc_drift_ppb : Frequency error of the RTC, positive if it runs
+*                          fast
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_set_drift(int32_t rtc_drift_ppb)
+{
+    rtc_first_edge_ns += (double)rtc_edges * rtc_period_ns;
+    rtc_edges = 0u;
+    rtc_period_ns = (double)HOST_HW_NS_PER_SECOND /
+                    (1.0 + ((double)rtc_drift_ppb / (double)HOST_HW_NS_PER_SECOND));
+}
+
+/*******************************************************************************
+* Function Name: host_hw_rtc_edge
+********************************************************************************
+* Summary:
+*  Moves the time to the next second of the RTC and runs what the RTC
+*  interrupt does: the RTC counts the second, the tick is counted and timed,
+*  and the tick hook runs. The harness then runs the tick work item when the
+*  main loop would. To model the interrupt latency, the harness moves the
+*  time past the edge first; the interrupt then starts at that time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_rtc_edge(void)
+{
+    host_hw_set_time(host_hw_next_edge());
+    rtc_edges++;
+    rtc_epoch++;
+
+    isr_cycles.count++;
+    isr_cycles.last_start = dwt.CYCCNT;
+
+    if (NULL != tick_hook)
+    {
+        tick_hook(isr_cycles.count);
+    }
+}
+
+/*******************************************************************************
+* Function Name: systick_period
+********************************************************************************
+* Summary:
+*  Returns the SysTick period, reload + 1 CPU cycles.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Period in ns
+*
+*******************************************************************************/
+static int64_t systick_period(void)
+{
+    return ((int64_t)(systick_reload + 1u) * HOST_HW_NS_PER_SECOND) / SystemCoreClock;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_next_subtick
+********************************************************************************
+* Summary:
+*  Returns the time of the next SysTick interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time in ns, -1 if the SysTick is disabled
+*
+*******************************************************************************/
+int64_t host_hw_next_subtick(void)
+{
+    return systick_next_ns;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_subtick
+********************************************************************************
+* Summary:
+*  Runs the SysTick interrupt due next. The counter keeps its schedule, so
+*  the latency of an interrupt, modelled by moving the time past it first,
+*  does not delay the following ones.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_subtick(void)
+{
+    if (systick_next_ns >= 0)
+    {
+        host_hw_set_time(systick_next_ns);
+        systick_next_ns += systick_period();
+        if (NULL != systick_callback)
+        {
+            systick_callback();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: host_hw_random
+********************************************************************************
+* Summary:
+*  Returns a pseudo-random number. The sequence restarts with
+*  host_hw_init(), so the runs are repeatable.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Random number
+*
+*******************************************************************************/
+uint32_t host_hw_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_seed
+********************************************************************************
+* Summary:
+*  Restarts the pseudo-random sequence from a seed, after host_hw_init(), so
+*  that runs of the same scenario differ.
+*
+* Parameters:
+*  uint32_t seed : Start of the sequence, 0 for the one of host_hw_init()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_hw_seed(uint32_t seed)
+{
+    random_state = (0u != seed) ? seed : 1u;
+}
+
+/*******************************************************************************
+* Function Name: host_hw_gaussian
+********************************************************************************
+* Summary:
+*  Returns a normally distributed pseudo-random number.
+*
+* Parameters:
+*  uint32_t sigma : Standard deviation
+*
+* Return:
+*  int32_t : Random number
+*
+*******************************************************************************/
+int32_t host_hw_gaussian(uint32_t sigma)
+{
+    double u1 = ((double)host_hw_random() + 1.0) / 4294967297.0;
+    double u2 = (double)host_hw_random() / 4294967296.0;
+
+    return (int32_t)lround((double)sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
+
+/*******************************************************************************
+* Function Name: Cy_RTC_GetDateAndTime
+********************************************************************************
+* Summary:
+*  Returns the time shown by the virtual RTC.
+*
+* Parameters:
+*  cy_stc_rtc_config_t *dateTime : Destination of the time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_RTC_GetDateAndTime(cy_stc_rtc_config_t *dateTime)
+{
+    time_utils_from_epoch(rtc_epoch, dateTime);
+}
+
+/*******************************************************************************
+* Function Name: Cy_RTC_SetDateAndTime
+********************************************************************************
+* Summary:
+*  Writes the virtual RTC. As assumed by the firmware, the write does not
+*  move the second edges.
+*
+* Parameters:
+*  const cy_stc_rtc_config_t *dateTime : Time to write
+*
+* Return:
+*  cy_en_rtc_status_t : CY_RTC_SUCCESS
+*
+*******************************************************************************/
+cy_en_rtc_status_t Cy_RTC_SetDateAndTime(const cy_stc_rtc_config_t *dateTime)
+{
+    rtc_epoch = time_utils_to_epoch(dateTime);
+    return CY_RTC_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: rtc_snapshot_read
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_snapshot.c. The stand-in keeps the seconds
+*  since the epoch instead of the BCD registers.
+*
+* Parameters:
+*  rtc_snapshot_t *snapshot : Destination of the snapshot
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_snapshot_read(rtc_snapshot_t *snapshot)
+{
+    snapshot->time = rtc_epoch;
+    snapshot->date = 0u;
+}
+
+/*******************************************************************************
+* Function Name: rtc_snapshot_decode
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_snapshot.c: converts a snapshot of
+*  rtc_snapshot_read() to the time.
+*
+* Parameters:
+*  const rtc_snapshot_t *snapshot : Snapshot
+*  cy_stc_rtc_config_t *dateTime  : Destination of the time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_snapshot_decode(const rtc_snapshot_t *snapshot, cy_stc_rtc_config_t *dateTime)
+{
+    time_utils_from_epoch(snapshot->time, dateTime);
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_Init
+********************************************************************************
+* Summary:
+*  Sets up the virtual SysTick and starts it, as the PDL does. Only the CPU
+*  clock source is modelled.
+*
+* Parameters:
+*  cy_en_systick_clock_source_t clockSource : Clock source
+*  uint32_t interval                        : Reload value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysTick_Init(cy_en_systick_clock_source_t clockSource, uint32_t interval)
+{
+    (void)clockSource;
+    systick_reload = interval;
+    Cy_SysTick_Clear();
+    Cy_SysTick_Enable();
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_Enable
+********************************************************************************
+* Summary:
+*  Starts the virtual SysTick if it is stopped.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysTick_Enable(void)
+{
+    if (systick_next_ns < 0)
+    {
+        systick_next_ns = time_ns + systick_period();
+    }
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_Disable
+********************************************************************************
+* Summary:
+*  Stops the virtual SysTick.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysTick_Disable(void)
+{
+    systick_next_ns = -1;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_Clear
+********************************************************************************
+* Summary:
+*  Restarts the period of the virtual SysTick if it runs.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysTick_Clear(void)
+{
+    if (systick_next_ns >= 0)
+    {
+        systick_next_ns = time_ns + systick_period();
+    }
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_SetReload
+********************************************************************************
+* Summary:
+*  Changes the reload value; the period in progress is not changed.
+*
+* Parameters:
+*  uint32_t value : Reload value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysTick_SetReload(uint32_t value)
+{
+    systick_reload = value;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysTick_SetCallback
+********************************************************************************
+* Summary:
+*  Registers the function run by the virtual SysTick interrupt. Only one
+*  callback is modelled.
+*
+* Parameters:
+*  uint32_t number              : Callback slot
+*  Cy_SysTick_Callback function : Function to run
+*
+* Return:
+*  Cy_SysTick_Callback : Previous callback
+*
+*******************************************************************************/
+Cy_SysTick_Callback Cy_SysTick_SetCallback(uint32_t number, Cy_SysTick_Callback function)
+{
+    Cy_SysTick_Callback previous = systick_callback;
+
+    (void)number;
+    systick_callback = function;
+    return previous;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysLib_Delay
+********************************************************************************
+* Summary:
+*  Moves the time forward by a delay.
+*
+* Parameters:
+*  uint32_t milliseconds : Delay
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysLib_Delay(uint32_t milliseconds)
+{
+    host_hw_set_time(time_ns + ((int64_t)milliseconds * 1000000));
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_count
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_tick.c: returns the number of RTC seconds.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Tick count
+*
+*******************************************************************************/
+uint32_t rtc_tick_count(void)
+{
+    return isr_cycles.count;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_get_isr_cycles
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_tick.c: returns the timing of the RTC
+*  interrupt, whose start is the RTC edge.
+*
+* Parameters:
+*  cycle_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_get_isr_cycles(cycle_stats_t *stats)
+{
+    *stats = isr_cycles;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_set_hook
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_tick.c: registers the function run on each
+*  RTC edge.
+*
+* Parameters:
+*  rtc_tick_hook_t hook : Function to run, NULL for none
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_set_hook(rtc_tick_hook_t hook)
+{
+    tick_hook = hook;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_add_retries
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_tick.c: counts the RTC write retries.
+*
+* Parameters:
+*  uint32_t count : Retries to add
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void rtc_tick_add_retries(uint32_t count)
+{
+    retries += count;
+}
+
+/*******************************************************************************
+* Function Name: rtc_tick_retries
+********************************************************************************
+* Summary:
+*  Replaces the function of rtc_tick.c: returns the RTC write retries.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Retries
+*
+*******************************************************************************/
+uint32_t rtc_tick_retries(void)
+{
+    return retries;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name:   host_hw.h
+*
+* Description: This file contains the declarations of the virtual hardware of the
+*              host harnesses: a time base in nanoseconds, the DWT cycle counter
+*              and an RTC that runs at a chosen frequency error.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef HOST_HW_H
+#define HOST_HW_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "rtc_tick.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HOST_HW_NS_PER_SECOND    (1000000000LL)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void host_hw_init(uint32_t rtc_epoch, int64_t rtc_phase_ns, int32_t rtc_drift_ppb,
+                  uint32_t cpu_hz);
+void host_hw_set_time(int64_t time_ns);
+int64_t host_hw_time(void);
+int64_t host_hw_next_edge(void);
+void host_hw_set_drift(int32_t rtc_drift_ppb);
+void host_hw_rtc_edge(void);
+int64_t host_hw_next_subtick(void);
+void host_hw_subtick(void);
+uint32_t host_hw_random(void);
+void host_hw_seed(uint32_t seed);
+int32_t host_hw_gaussian(uint32_t sigma);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* HOST_HW_H */
+
+/* [] END OF FILE */
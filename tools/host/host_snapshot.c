@@ -0,0 +1,225 @@
+/******************************************************************************
+* File Name:   host_snapshot.c
+*
+* Description: This file contains the snapshots of the host harness. The state of a run
+*              is in the static variables of the firmware modules, of the virtual
+*              hardware and of the model, so a snapshot copies the whole static data of
+*              the program, between the linker symbols __data_start and _end. Restoring
+*              it returns every module to the second it was taken at.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "host_snapshot.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SNAPSHOT_MAGIC           (0x50414E53u) /* "SNAP" */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Start of a snapshot file, followed by the data */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t base;
+    uint64_t size;
+} snapshot_header_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Bounds of the static data, from the linker of the GNU toolchain */
+extern char __data_start[];
+extern char _end[];
+
+/*******************************************************************************
+* Function Name: host_snapshot_save
+********************************************************************************
+* Summary:
+*  Copies the static data of the program into the snapshot. The copy is
+*  allocated on the first save, and reused by the next ones.
+*
+* Parameters:
+*  host_snapshot_t *snapshot : Snapshot, zeroed before the first save
+*
+* Return:
+*  bool : false if the copy could not be allocated
+*
+*******************************************************************************/
+bool host_snapshot_save(host_snapshot_t *snapshot)
+{
+    size_t size = (size_t)(_end - __data_start);
+
+    if ((NULL == snapshot->data) || (size != snapshot->size))
+    {
+        free(snapshot->data);
+        snapshot->data = malloc(size);
+        if (NULL == snapshot->data)
+        {
+            snapshot->size = 0u;
+            return false;
+        }
+    }
+    snapshot->base = (uintptr_t)__data_start;
+    snapshot->size = size;
+    (void)memcpy(snapshot->data, __data_start, size);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: host_snapshot_restore
+********************************************************************************
+* Summary:
+*  Copies the snapshot back over the static data of the program. The state
+*  holds pointers, such as the hooks the modules register, so a snapshot is
+*  only restored in the process that saved it, or in a process forked from
+*  it; host_snapshot_read() checks this for a file.
+*
+* Parameters:
+*  const host_snapshot_t *snapshot : Snapshot saved
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_snapshot_restore(const host_snapshot_t *snapshot)
+{
+    (void)memcpy(__data_start, snapshot->data, snapshot->size);
+}
+
+/*******************************************************************************
+* Function Name: host_snapshot_write
+********************************************************************************
+* Summary:
+*  Writes the snapshot to a file, after a header with the address and the
+*  size of the data.
+*
+* Parameters:
+*  const host_snapshot_t *snapshot : Snapshot saved
+*  FILE *file                      : File open for writing
+*
+* Return:
+*  bool : false on a write error
+*
+*******************************************************************************/
+bool host_snapshot_write(const host_snapshot_t *snapshot, FILE *file)
+{
+    snapshot_header_t header = { 0 };
+
+    header.magic = SNAPSHOT_MAGIC;
+    header.base = (uint64_t)snapshot->base;
+    header.size = (uint64_t)snapshot->size;
+
+    return (1u == fwrite(&header, sizeof(header), 1u, file)) &&
+           (snapshot->size == fwrite(snapshot->data, 1u, snapshot->size, file));
+}
+
+/*******************************************************************************
+* Function Name: host_snapshot_read
+********************************************************************************
+* Summary:
+*  Reads a snapshot written by host_snapshot_write(). The snapshot is refused
+*  if its data is not at the address and of the size of the static data of
+*  this process: it was written by another program, or by another run of a
+*  position-independent one. Build with -no-pie to restore a file in a later
+*  run.
+*
+* Parameters:
+*  host_snapshot_t *snapshot : Destination, zeroed or saved before
+*  FILE *file                : File open for reading
+*
+* Return:
+*  bool : false on a read error or a snapshot of another program
+*
+*******************************************************************************/
+bool host_snapshot_read(host_snapshot_t *snapshot, FILE *file)
+{
+    snapshot_header_t header;
+    size_t size = (size_t)(_end - __data_start);
+
+    if ((1u != fread(&header, sizeof(header), 1u, file)) || (SNAPSHOT_MAGIC != header.magic) ||
+        ((uint64_t)(uintptr_t)__data_start != header.base) || ((uint64_t)size != header.size))
+    {
+        return false;
+    }
+    if ((NULL == snapshot->data) || (size != snapshot->size))
+    {
+        free(snapshot->data);
+        snapshot->data = malloc(size);
+        if (NULL == snapshot->data)
+        {
+            snapshot->size = 0u;
+            return false;
+        }
+    }
+    snapshot->base = (uintptr_t)__data_start;
+    snapshot->size = size;
+
+    return (size == fread(snapshot->data, 1u, size, file));
+}
+
+/*******************************************************************************
+* Function Name: host_snapshot_free
+********************************************************************************
+* Summary:
+*  Frees the copy of a snapshot.
+*
+* Parameters:
+*  host_snapshot_t *snapshot : Snapshot
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_snapshot_free(host_snapshot_t *snapshot)
+{
+    free(snapshot->data);
+    *snapshot = (host_snapshot_t){ 0 };
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,86 @@
+/******************************************************************************
+* File Name:   host_snapshot.h
+*
+* Description: This file contains the declarations of the snapshots of the host
+*              harness, copies of the state of a run to branch other runs from.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef HOST_SNAPSHOT_H
+#define HOST_SNAPSHOT_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Copy of the static data of the program. Keep it out of static variables,
+ * which it would restore over itself */
+typedef struct
+{
+    uintptr_t base;              /* Address of the data saved */
+    size_t size;                 /* Bytes saved */
+    uint8_t *data;               /* Copy of the data, allocated by the save */
+} host_snapshot_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool host_snapshot_save(host_snapshot_t *snapshot);
+void host_snapshot_restore(const host_snapshot_t *snapshot);
+bool host_snapshot_write(const host_snapshot_t *snapshot, FILE *file);
+bool host_snapshot_read(host_snapshot_t *snapshot, FILE *file);
+void host_snapshot_free(host_snapshot_t *snapshot);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* HOST_SNAPSHOT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,292 @@
+/******************************************************************************
+* File Name:   sampler_sim.c
+*
+* Description: This file contains a host program that runs the sampling scheduler of
+*              the firmware in virtual time for one hour. The RTC and SysTick interrupts
+*              start with a random latency; the program measures each trigger against
+*              the interrupt and against the true RTC edge, and compares the result
+*              with the statistics of the sampler.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "host_hw.h"
+#include "sampler.h"
+#include "ts_store.h"
+#include "work_queue.h"
+#include "time_utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_MS                (1000000LL)
+
+/* Virtual CPU clock and RTC frequency error */
+#define CPU_HZ                   (100000000u)
+#define RTC_DRIFT_PPB            (20000)
+
+/* Length of the run in RTC seconds */
+#define RUN_S                    (3600u)
+
+/* Interrupt latency: a fixed entry time plus the absolute value of a normal
+ * distribution, for the time the interrupts are masked */
+#define LATENCY_MIN_NS           (120u)
+#define LATENCY_SIGMA_NS         (500u)
+
+/* The sampler statistics may differ from the harness by one cycle per delay */
+#define RMS_TOLERANCE_NS         (10.0)
+
+/* Start of the run: 01/03/2024 00:00:00 */
+#define START_YEAR               (2024u)
+#define START_MONTH              (3u)
+#define START_DAY                (1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Period errors measured by the harness */
+typedef struct
+{
+    uint32_t expected;           /* Samples due in the run */
+    int64_t last_isr_delay_ns;   /* Delay after the RTC interrupt plus the phase */
+    int64_t last_true_delay_ns;  /* Delay after the RTC edge plus the phase */
+    bool have_delay;
+    double isr_sq_sum;
+    double true_sq_sum;
+    uint32_t periods;
+    int64_t max_true_delay_ns;
+} check_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int32_t read_channel(uint32_t channel);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static ts_store_t store;
+
+static const sampler_channel_config_t configs[] =
+{
+    { .period_s = 1u,  .phase_ms = 0u,   .read = read_channel, .store = &store },
+    { .period_s = 1u,  .phase_ms = 500u, .read = read_channel, .store = NULL },
+    { .period_s = 60u, .phase_ms = 0u,   .read = read_channel, .store = NULL },
+    { .period_s = 10u, .phase_ms = 250u, .read = read_channel, .store = NULL },
+};
+
+#define CHANNELS                 (sizeof(configs) / sizeof(configs[0]))
+
+static check_t checks[CHANNELS];
+
+/* True time of the last RTC edge and start of its interrupt */
+static int64_t edge_ns = 0;
+static int64_t isr_start_ns = 0;
+
+/*******************************************************************************
+* Function Name: latency
+********************************************************************************
+* Summary:
+*  Returns a random interrupt latency.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Latency in ns
+*
+*******************************************************************************/
+static int64_t latency(void)
+{
+    return (int64_t)LATENCY_MIN_NS + llabs((long long)host_hw_gaussian(LATENCY_SIGMA_NS));
+}
+
+/*******************************************************************************
+* Function Name: read_channel
+********************************************************************************
+* Summary:
+*  Acquisition of the channels, called by the sampler from the interrupts.
+*  Measures the delay of the trigger after the RTC interrupt and after the
+*  RTC edge, and the change of both delays since the previous period.
+*
+* Parameters:
+*  uint32_t channel : Channel sampled
+*
+* Return:
+*  int32_t : Sample, the trigger time in ms
+*
+*******************************************************************************/
+static int32_t read_channel(uint32_t channel)
+{
+    check_t *check = &checks[channel];
+    int64_t phase_ns = (int64_t)configs[channel].phase_ms * NS_PER_MS;
+    int64_t isr_delay = host_hw_time() - isr_start_ns - phase_ns;
+    int64_t true_delay = host_hw_time() - edge_ns - phase_ns;
+
+    if (check->have_delay)
+    {
+        check->isr_sq_sum += (double)(isr_delay - check->last_isr_delay_ns) *
+                             (double)(isr_delay - check->last_isr_delay_ns);
+        check->true_sq_sum += (double)(true_delay - check->last_true_delay_ns) *
+                              (double)(true_delay - check->last_true_delay_ns);
+        check->periods++;
+    }
+    if (true_delay > check->max_true_delay_ns)
+    {
+        check->max_true_delay_ns = true_delay;
+    }
+
+    check->last_isr_delay_ns = isr_delay;
+    check->last_true_delay_ns = true_delay;
+    check->have_delay = true;
+
+    return (int32_t)(host_hw_time() / NS_PER_MS);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the sampler for RUN_S RTC seconds. The interrupts run in time order,
+*  each followed by the work items it posted. A channel fails if a sample is
+*  missing, missed or dropped, or if the RMS jitter of the sampler differs
+*  from the one measured by the harness from the RTC interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int : 0 if every channel passed, 1 otherwise
+*
+*******************************************************************************/
+int main(void)
+{
+    cy_stc_rtc_config_t start = { 0 };
+    sampler_stats_t stats;
+    ts_store_stats_t store_stats;
+    uint32_t start_epoch;
+    uint32_t edges = 0u;
+    uint32_t channel;
+    double isr_rms;
+    double true_rms;
+    bool passed;
+    bool all_passed = true;
+
+    start.year = START_YEAR - 2000u;
+    start.month = START_MONTH;
+    start.date = START_DAY;
+    start_epoch = time_utils_to_epoch(&start);
+
+    host_hw_init(start_epoch, 0, RTC_DRIFT_PPB, CPU_HZ);
+    ts_store_init(&store);
+    sampler_init();
+    for (channel = 0u; channel < CHANNELS; channel++)
+    {
+        (void)sampler_configure(channel, &configs[channel]);
+        checks[channel] = (check_t){ 0 };
+    }
+
+    /* The sub-second counter stops after the last phase of the last second */
+    while ((edges < RUN_S) || (host_hw_next_subtick() >= 0))
+    {
+        if ((host_hw_next_subtick() >= 0) &&
+            ((edges >= RUN_S) || (host_hw_next_subtick() < host_hw_next_edge())))
+        {
+            host_hw_set_time(host_hw_next_subtick() + latency());
+            host_hw_subtick();
+        }
+        else
+        {
+            edge_ns = host_hw_next_edge();
+            isr_start_ns = edge_ns + latency();
+            host_hw_set_time(isr_start_ns);
+            host_hw_rtc_edge();
+            edges++;
+            for (channel = 0u; channel < CHANNELS; channel++)
+            {
+                if (0u == ((start_epoch + edges) % configs[channel].period_s))
+                {
+                    checks[channel].expected++;
+                }
+            }
+        }
+        (void)work_queue_drain();
+    }
+
+    printf("%lu RTC seconds at %lu MHz, interrupt latency %lu ns + |N(0, %lu ns)|\n",
+           (unsigned long)RUN_S, (unsigned long)(CPU_HZ / 1000000u),
+           (unsigned long)LATENCY_MIN_NS, (unsigned long)LATENCY_SIGMA_NS);
+
+    for (channel = 0u; channel < CHANNELS; channel++)
+    {
+        sampler_get_stats(channel, &stats);
+        isr_rms = (0u != checks[channel].periods) ?
+                  sqrt(checks[channel].isr_sq_sum / checks[channel].periods) : 0.0;
+        true_rms = (0u != checks[channel].periods) ?
+                   sqrt(checks[channel].true_sq_sum / checks[channel].periods) : 0.0;
+
+        passed = (stats.samples == checks[channel].expected) && (0u == stats.missed) &&
+                 (0u == stats.dropped) && (fabs((double)stats.rms_jitter_ns - isr_rms) <= RMS_TOLERANCE_NS);
+        if (NULL != configs[channel].store)
+        {
+            ts_store_get_stats(configs[channel].store, &store_stats);
+            passed = passed && (store_stats.appended == stats.samples);
+        }
+        all_passed = all_passed && passed;
+
+        printf("channel %lu (%lu s, +%lu ms): %lu of %lu samples, %lu missed, %lu dropped\n",
+               (unsigned long)channel, (unsigned long)configs[channel].period_s,
+               (unsigned long)configs[channel].phase_ms, (unsigned long)stats.samples,
+               (unsigned long)checks[channel].expected, (unsigned long)stats.missed,
+               (unsigned long)stats.dropped);
+        printf("  RMS jitter: sampler %lu ns, from the interrupt %.0f ns, from the RTC edge %.0f ns\n",
+               (unsigned long)stats.rms_jitter_ns, isr_rms, true_rms);
+        printf("  max latency: sampler %lu ns, from the RTC edge %lld ns: %s\n",
+               (unsigned long)stats.max_latency_ns, (long long)checks[channel].max_true_delay_ns,
+               passed ? "PASS" : "FAIL");
+    }
+
+    return all_passed ? 0 : 1;
+}
+
+/* [] END OF FILE */
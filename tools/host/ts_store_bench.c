@@ -0,0 +1,716 @@
+/******************************************************************************
+* File Name:   ts_store_bench.c
+*
+* Description: This file contains a host program that appends realistic series to the
+*              time-series store of the firmware, reports the bytes per sample, times
+*              the append and the queries, and checks every query against a linear scan
+*              of all the samples appended.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "ts_store.h"
+#include "adc_sim.h"
+#include "time_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_SECOND            (1000000000LL)
+
+/* Length of each series */
+#define RUN_S                    (7u * TIME_UTILS_SEC_PER_DAY)
+
+/* Random queries per series and per tier */
+#define QUERIES                  (2000u)
+
+/* Size of an uncompressed sample: time and value */
+#define RAW_SAMPLE_BYTES         (8.0)
+
+/* Start of the series: 01/03/2024 00:00:00 */
+#define START_YEAR               (2024u)
+#define START_MONTH              (3u)
+#define START_DAY                (1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    SERIES_ADC,                  /* Channel 0 of adc_sim.c every second, as main.c stores */
+    SERIES_TEMPERATURE,          /* Slow random walk every 10 s, 1% of the samples lost */
+    SERIES_RANDOM                /* Random values at random intervals: the worst case */
+} series_kind_t;
+
+typedef struct
+{
+    const char *name;
+    series_kind_t kind;
+} series_t;
+
+/* Samples appended, in time order */
+typedef struct
+{
+    uint32_t *epochs;
+    int32_t *values;
+    uint32_t count;
+} reference_t;
+
+/* Summaries of a tier computed from the reference: closed ones, then the
+ * open one */
+typedef struct
+{
+    ts_store_summary_t *items;
+    int64_t *sums;
+    uint32_t count;
+} periods_t;
+
+/* Results collected by the visitors */
+typedef struct
+{
+    uint32_t *epochs;
+    int32_t *values;
+    ts_store_summary_t *summaries;
+    uint32_t count;
+    int64_t checksum;
+} collect_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const series_t series[] =
+{
+    { "adc_sim channel 0, 1 s", SERIES_ADC },
+    { "temperature, 10 s",      SERIES_TEMPERATURE },
+    { "random values",          SERIES_RANDOM },
+};
+
+static const uint32_t tier_seconds[TS_STORE_TIER_COUNT] =
+{
+    TIME_UTILS_SEC_PER_MIN,
+    TIME_UTILS_SEC_PER_HOUR,
+    TIME_UTILS_SEC_PER_DAY
+};
+
+static const uint32_t tier_capacity[TS_STORE_TIER_COUNT] =
+{
+    TS_STORE_MINUTES,
+    TS_STORE_HOURS,
+    TS_STORE_DAYS
+};
+
+static const char *const tier_names[TS_STORE_TIER_COUNT] = { "minute", "hour", "day" };
+
+static ts_store_t store;
+
+/* State of the random generator */
+static uint32_t random_state = 1u;
+
+/*******************************************************************************
+* Function Name: random_next
+********************************************************************************
+* Summary:
+*  Returns a pseudo-random number (xorshift32).
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Random number
+*
+*******************************************************************************/
+static uint32_t random_next(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/*******************************************************************************
+* Function Name: now_ns
+********************************************************************************
+* Summary:
+*  Returns the time of a monotonic clock of the host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int64_t : Time in ns
+*
+*******************************************************************************/
+static int64_t now_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t)now.tv_sec * NS_PER_SECOND) + now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: make_series
+********************************************************************************
+* Summary:
+*  Generates the samples of a series.
+*
+* Parameters:
+*  series_kind_t kind    : Series to generate
+*  uint32_t start        : Time of the first sample
+*  reference_t *samples  : Destination of the samples
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void make_series(series_kind_t kind, uint32_t start, reference_t *samples)
+{
+    uint32_t epoch = start;
+    int32_t value = 2150;        /* 21.50 degC */
+
+    samples->count = 0u;
+    while (epoch < (start + RUN_S))
+    {
+        switch (kind)
+        {
+            case SERIES_ADC:
+                samples->epochs[samples->count] = epoch;
+                samples->values[samples->count++] = adc_sim_read(0u);
+                epoch += 1u;
+                break;
+            case SERIES_TEMPERATURE:
+                value += (int32_t)(random_next() % 3u) - 1;
+                if (0u != (random_next() % 100u))
+                {
+                    samples->epochs[samples->count] = epoch;
+                    samples->values[samples->count++] = value;
+                }
+                epoch += 10u;
+                break;
+            default:
+                samples->epochs[samples->count] = epoch;
+                samples->values[samples->count++] = (int32_t)random_next();
+                epoch += 1u + (random_next() % 30u);
+                break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: group_periods
+********************************************************************************
+* Summary:
+*  Groups samples or summaries into the periods of a tier, as the store does:
+*  each item is added to the period that contains its start.
+*
+* Parameters:
+*  const uint32_t *starts       : Time of each item
+*  const int32_t *mins          : Lowest value of each item
+*  const int32_t *maxs          : Highest value of each item
+*  const int64_t *sums          : Sum of each item
+*  const uint32_t *counts       : Samples of each item
+*  uint32_t items               : Number of items
+*  uint32_t period              : Length of a period of the tier
+*  periods_t *periods           : Destination of the periods
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void group_periods(const uint32_t *starts, const int32_t *mins, const int32_t *maxs,
+                          const int64_t *sums, const uint32_t *counts, uint32_t items,
+                          uint32_t period, periods_t *periods)
+{
+    ts_store_summary_t *current = NULL;
+    uint32_t start;
+    uint32_t i;
+
+    periods->count = 0u;
+    for (i = 0u; i < items; i++)
+    {
+        start = starts[i] - (starts[i] % period);
+        if ((NULL == current) || (current->start != start))
+        {
+            current = &periods->items[periods->count];
+            periods->sums[periods->count++] = 0;
+            *current = (ts_store_summary_t){ .start = start, .min = mins[i], .max = maxs[i] };
+        }
+        current->min = (mins[i] < current->min) ? mins[i] : current->min;
+        current->max = (maxs[i] > current->max) ? maxs[i] : current->max;
+        current->count += counts[i];
+        periods->sums[periods->count - 1u] += sums[i];
+        current->avg = (int32_t)(periods->sums[periods->count - 1u] / (int64_t)current->count);
+    }
+}
+
+/*******************************************************************************
+* Function Name: make_tiers
+********************************************************************************
+* Summary:
+*  Computes the summaries of every tier from the samples. A tier is built
+*  from the closed periods of the tier below; the last period of each tier
+*  is the open one.
+*
+* Parameters:
+*  const reference_t *samples : Samples appended
+*  periods_t *tiers           : Destination, one per tier, allocated here
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void make_tiers(const reference_t *samples, periods_t *tiers)
+{
+    uint32_t *starts = malloc(samples->count * sizeof(uint32_t));
+    int32_t *mins = malloc(samples->count * sizeof(int32_t));
+    int32_t *maxs = malloc(samples->count * sizeof(int32_t));
+    int64_t *sums = malloc(samples->count * sizeof(int64_t));
+    uint32_t *counts = malloc(samples->count * sizeof(uint32_t));
+    uint32_t items = samples->count;
+    uint32_t tier;
+    uint32_t i;
+
+    for (i = 0u; i < items; i++)
+    {
+        starts[i] = samples->epochs[i];
+        mins[i] = samples->values[i];
+        maxs[i] = samples->values[i];
+        sums[i] = samples->values[i];
+        counts[i] = 1u;
+    }
+
+    for (tier = 0u; tier < (uint32_t)TS_STORE_TIER_COUNT; tier++)
+    {
+        tiers[tier].items = malloc(samples->count * sizeof(ts_store_summary_t));
+        tiers[tier].sums = malloc(samples->count * sizeof(int64_t));
+        group_periods(starts, mins, maxs, sums, counts, items, tier_seconds[tier], &tiers[tier]);
+
+        /* The closed periods feed the next tier */
+        items = (0u != tiers[tier].count) ? (tiers[tier].count - 1u) : 0u;
+        for (i = 0u; i < items; i++)
+        {
+            starts[i] = tiers[tier].items[i].start;
+            mins[i] = tiers[tier].items[i].min;
+            maxs[i] = tiers[tier].items[i].max;
+            sums[i] = tiers[tier].sums[i];
+            counts[i] = tiers[tier].items[i].count;
+        }
+    }
+
+    free(starts);
+    free(mins);
+    free(maxs);
+    free(sums);
+    free(counts);
+}
+
+/*******************************************************************************
+* Function Name: collect_sample
+********************************************************************************
+* Summary:
+*  Sample visitor that keeps the samples.
+*
+* Parameters:
+*  uint32_t epoch : Time of the sample
+*  int32_t value  : Value of the sample
+*  void *context  : collect_t
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void collect_sample(uint32_t epoch, int32_t value, void *context)
+{
+    collect_t *collect = (collect_t *)context;
+
+    collect->epochs[collect->count] = epoch;
+    collect->values[collect->count++] = value;
+}
+
+/*******************************************************************************
+* Function Name: sum_sample
+********************************************************************************
+* Summary:
+*  Sample visitor for the timed queries: adds the value to a checksum.
+*
+* Parameters:
+*  uint32_t epoch : Time of the sample
+*  int32_t value  : Value of the sample
+*  void *context  : collect_t
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sum_sample(uint32_t epoch, int32_t value, void *context)
+{
+    ((collect_t *)context)->checksum += (int64_t)epoch + value;
+}
+
+/*******************************************************************************
+* Function Name: collect_summary
+********************************************************************************
+* Summary:
+*  Summary visitor that keeps the summaries.
+*
+* Parameters:
+*  const ts_store_summary_t *summary : Summary
+*  void *context                     : collect_t
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void collect_summary(const ts_store_summary_t *summary, void *context)
+{
+    collect_t *collect = (collect_t *)context;
+
+    collect->summaries[collect->count++] = *summary;
+}
+
+/*******************************************************************************
+* Function Name: sum_summary
+********************************************************************************
+* Summary:
+*  Summary visitor for the timed queries: adds the average to a checksum.
+*
+* Parameters:
+*  const ts_store_summary_t *summary : Summary
+*  void *context                     : collect_t
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sum_summary(const ts_store_summary_t *summary, void *context)
+{
+    ((collect_t *)context)->checksum += summary->avg;
+}
+
+/*******************************************************************************
+* Function Name: random_range
+********************************************************************************
+* Summary:
+*  Returns a random range that starts and ends within a span, with some
+*  margin before and after it so that empty and partial ranges are tried.
+*
+* Parameters:
+*  uint32_t first : Start of the span
+*  uint32_t last  : End of the span
+*  uint32_t *start: Start of the range
+*  uint32_t *end  : End of the range
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void random_range(uint32_t first, uint32_t last, uint32_t *start, uint32_t *end)
+{
+    uint32_t span = (last - first) + 1u;
+    uint32_t margin = span / 10u;
+    uint32_t a = (first - margin) + (random_next() % (span + (2u * margin)));
+    uint32_t b = (first - margin) + (random_next() % (span + (2u * margin)));
+
+    *start = (a < b) ? a : b;
+    *end = (a < b) ? b : a;
+}
+
+/*******************************************************************************
+* Function Name: check_query
+********************************************************************************
+* Summary:
+*  Runs ts_store_query() on a range and compares the samples with a linear
+*  scan of the samples appended, from the oldest sample still in the store.
+*
+* Parameters:
+*  const reference_t *samples : Samples appended
+*  uint32_t oldest            : Time of the oldest raw sample in the store
+*  uint32_t start             : Start of the range
+*  uint32_t end               : End of the range
+*  collect_t *collect         : Buffers for the results
+*
+* Return:
+*  bool : true if the results match
+*
+*******************************************************************************/
+static bool check_query(const reference_t *samples, uint32_t oldest, uint32_t start,
+                        uint32_t end, collect_t *collect)
+{
+    uint32_t returned;
+    uint32_t expected = 0u;
+    bool match = true;
+    uint32_t i;
+
+    collect->count = 0u;
+    returned = ts_store_query(&store, start, end, collect_sample, collect);
+
+    for (i = 0u; i < samples->count; i++)
+    {
+        if ((samples->epochs[i] >= oldest) && (samples->epochs[i] >= start) &&
+            (samples->epochs[i] <= end))
+        {
+            match = match && (expected < collect->count) &&
+                    (collect->epochs[expected] == samples->epochs[i]) &&
+                    (collect->values[expected] == samples->values[i]);
+            expected++;
+        }
+    }
+
+    return match && (expected == collect->count) && (returned == collect->count);
+}
+
+/*******************************************************************************
+* Function Name: check_tier
+********************************************************************************
+* Summary:
+*  Runs ts_store_query_tier() on a range and compares the summaries with the
+*  ones computed from the samples: the closed periods still kept by the
+*  tier, then the open one.
+*
+* Parameters:
+*  const periods_t *periods : Summaries of the tier computed from the samples
+*  ts_store_tier_t tier     : Tier to query
+*  uint32_t start           : Start of the range
+*  uint32_t end             : End of the range
+*  collect_t *collect       : Buffers for the results
+*
+* Return:
+*  bool : true if the results match
+*
+*******************************************************************************/
+static bool check_tier(const periods_t *periods, ts_store_tier_t tier, uint32_t start,
+                       uint32_t end, collect_t *collect)
+{
+    uint32_t closed = (0u != periods->count) ? (periods->count - 1u) : 0u;
+    uint32_t first = (closed > tier_capacity[tier]) ? (closed - tier_capacity[tier]) : 0u;
+    const ts_store_summary_t *summary;
+    const ts_store_summary_t *got;
+    uint32_t returned;
+    uint32_t expected = 0u;
+    bool match = true;
+    uint32_t i;
+
+    collect->count = 0u;
+    returned = ts_store_query_tier(&store, tier, start, end, collect_summary, collect);
+
+    for (i = first; i < periods->count; i++)
+    {
+        summary = &periods->items[i];
+        if ((summary->start <= end) && ((summary->start + tier_seconds[tier]) > start))
+        {
+            got = &collect->summaries[expected++];
+            match = match && (expected <= collect->count) && (got->start == summary->start) &&
+                    (got->min == summary->min) && (got->max == summary->max) &&
+                    (got->avg == summary->avg) && (got->count == summary->count);
+        }
+    }
+
+    return match && (expected == collect->count) && (returned == collect->count);
+}
+
+/*******************************************************************************
+* Function Name: run_series
+********************************************************************************
+* Summary:
+*  Appends a series to an empty store, then times and checks random queries
+*  of the raw samples and of each tier, and prints the results.
+*
+* Parameters:
+*  const series_t *test    : Series to run
+*  uint32_t start          : Time of the first sample
+*  reference_t *samples    : Buffers for the samples
+*  collect_t *collect      : Buffers for the query results
+*
+* Return:
+*  bool : true if every query matched the linear scan
+*
+*******************************************************************************/
+static bool run_series(const series_t *test, uint32_t start, reference_t *samples,
+                       collect_t *collect)
+{
+    periods_t tiers[TS_STORE_TIER_COUNT];
+    ts_store_stats_t stats;
+    uint32_t range_start;
+    uint32_t range_end;
+    uint32_t visited = 0u;
+    uint32_t failures = 0u;
+    uint32_t tier;
+    uint32_t last;
+    int64_t begin;
+    int64_t append_ns;
+    int64_t query_ns;
+    int64_t tier_ns;
+    uint32_t i;
+
+    make_series(test->kind, start, samples);
+    last = samples->epochs[samples->count - 1u];
+
+    ts_store_init(&store);
+    begin = now_ns();
+    for (i = 0u; i < samples->count; i++)
+    {
+        (void)ts_store_append(&store, samples->epochs[i], samples->values[i]);
+    }
+    append_ns = now_ns() - begin;
+    ts_store_get_stats(&store, &stats);
+
+    /* Raw samples: the same ranges are timed, then checked */
+    random_state = 7u;
+    begin = now_ns();
+    for (i = 0u; i < QUERIES; i++)
+    {
+        random_range(stats.oldest_raw, last, &range_start, &range_end);
+        visited += ts_store_query(&store, range_start, range_end, sum_sample, collect);
+    }
+    query_ns = now_ns() - begin;
+
+    random_state = 7u;
+    for (i = 0u; i < QUERIES; i++)
+    {
+        random_range(stats.oldest_raw, last, &range_start, &range_end);
+        failures += check_query(samples, stats.oldest_raw, range_start, range_end, collect) ? 0u : 1u;
+    }
+
+    printf("%s: %lu samples, %lu raw in %lu bytes, %.2f bytes per sample (%.1f times smaller)\n",
+           test->name, (unsigned long)stats.appended, (unsigned long)stats.raw_samples,
+           (unsigned long)stats.raw_bytes, (double)stats.raw_bytes / stats.raw_samples,
+           (RAW_SAMPLE_BYTES * stats.raw_samples) / stats.raw_bytes);
+    printf("  append %.1f ns, query %.0f ns (%.1f ns per sample returned)\n",
+           (double)append_ns / samples->count, (double)query_ns / QUERIES,
+           (0u != visited) ? ((double)query_ns / visited) : 0.0);
+
+    make_tiers(samples, tiers);
+    for (tier = 0u; tier < (uint32_t)TS_STORE_TIER_COUNT; tier++)
+    {
+        uint32_t first = (tiers[tier].count > (tier_capacity[tier] + 1u)) ?
+                         tiers[tier].items[tiers[tier].count - tier_capacity[tier] - 1u].start :
+                         start;
+
+        random_state = 11u + tier;
+        begin = now_ns();
+        for (i = 0u; i < QUERIES; i++)
+        {
+            random_range(first, last, &range_start, &range_end);
+            (void)ts_store_query_tier(&store, (ts_store_tier_t)tier, range_start, range_end,
+                                      sum_summary, collect);
+        }
+        tier_ns = now_ns() - begin;
+
+        random_state = 11u + tier;
+        for (i = 0u; i < QUERIES; i++)
+        {
+            random_range(first, last, &range_start, &range_end);
+            failures += check_tier(&tiers[tier], (ts_store_tier_t)tier, range_start, range_end,
+                                   collect) ? 0u : 1u;
+        }
+        printf("  %s tier: %lu summaries, query %.0f ns\n", tier_names[tier],
+               (unsigned long)((tiers[tier].count > (tier_capacity[tier] + 1u)) ?
+                               (tier_capacity[tier] + 1u) : tiers[tier].count),
+               (double)tier_ns / QUERIES);
+    }
+
+    for (tier = 0u; tier < (uint32_t)TS_STORE_TIER_COUNT; tier++)
+    {
+        free(tiers[tier].items);
+        free(tiers[tier].sums);
+    }
+
+    printf("  %lu queries checked against a linear scan, %lu mismatches: %s\n",
+           (unsigned long)(QUERIES * (1u + (uint32_t)TS_STORE_TIER_COUNT)),
+           (unsigned long)failures, (0u == failures) ? "PASS" : "FAIL");
+
+    return 0u == failures;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs every series for RUN_S seconds.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int : 0 if every query matched the linear scan, 1 otherwise
+*
+*******************************************************************************/
+int main(void)
+{
+    cy_stc_rtc_config_t start = { 0 };
+    reference_t samples;
+    collect_t collect;
+    uint32_t start_epoch;
+    bool all_passed = true;
+    size_t i;
+
+    start.year = START_YEAR - 2000u;
+    start.month = START_MONTH;
+    start.date = START_DAY;
+    start_epoch = time_utils_to_epoch(&start);
+
+    /* At most one sample per second */
+    samples.epochs = malloc(RUN_S * sizeof(uint32_t));
+    samples.values = malloc(RUN_S * sizeof(int32_t));
+    collect.epochs = malloc(RUN_S * sizeof(uint32_t));
+    collect.values = malloc(RUN_S * sizeof(int32_t));
+    collect.summaries = malloc(RUN_S * sizeof(ts_store_summary_t));
+
+    printf("%lu blocks of %lu bytes, %lu days per series, %lu random queries per test\n",
+           (unsigned long)TS_STORE_BLOCKS, (unsigned long)TS_STORE_BLOCK_BYTES,
+           (unsigned long)(RUN_S / TIME_UTILS_SEC_PER_DAY), (unsigned long)QUERIES);
+
+    for (i = 0u; i < (sizeof(series) / sizeof(series[0])); i++)
+    {
+        all_passed = run_series(&series[i], start_epoch, &samples, &collect) && all_passed;
+    }
+
+    free(samples.epochs);
+    free(samples.values);
+    free(collect.epochs);
+    free(collect.values);
+    free(collect.summaries);
+
+    return all_passed ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Convert an execution trace dump to the Chrome trace format.
+
+The firmware sends the trace ring with the "Dump execution trace" console
+command. Save the terminal output to a file and convert the last dump in it:
+
+    python3 tools/trace2json.py terminal.log -o trace.json
+
+Open trace.json in https://ui.perfetto.dev or in chrome://tracing. The
+interrupt handlers are shown on their own tracks and the main loop on a
+third one: work items, console commands, waits for UART TX queue space and
+sleeps.
+
+The event numbers must match trace_event_t in trace.h.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# Tracks
+PID = 1
+TID_MAIN = 1
+TID_RTC_ISR = 2
+TID_UART_ISR = 3
+
+TRACK_NAMES = {
+    TID_MAIN: "Main loop",
+    TID_RTC_ISR: "RTC interrupt",
+    TID_UART_ISR: "UART interrupt",
+}
+
+# trace_event_t: event -> (track, phase, name)
+EVENT_RTC_ISR_BEGIN = 1
+EVENT_RTC_ISR_END = 2
+EVENT_UART_ISR_BEGIN = 3
+EVENT_UART_ISR_END = 4
+EVENT_WORK_BEGIN = 5
+EVENT_WORK_END = 6
+EVENT_SLEEP_BEGIN = 7
+EVENT_SLEEP_END = 8
+EVENT_TX_WAIT_BEGIN = 9
+EVENT_TX_WAIT_END = 10
+EVENT_COMMAND_BEGIN = 11
+EVENT_COMMAND_END = 12
+EVENT_CLOCK = 13
+
+EVENTS = {
+    EVENT_RTC_ISR_BEGIN: (TID_RTC_ISR, "B", "rtc_tick_isr"),
+    EVENT_RTC_ISR_END: (TID_RTC_ISR, "E", "rtc_tick_isr"),
+    EVENT_UART_ISR_BEGIN: (TID_UART_ISR, "B", "user_uart_isr"),
+    EVENT_UART_ISR_END: (TID_UART_ISR, "E", "user_uart_isr"),
+    EVENT_WORK_BEGIN: (TID_MAIN, "B", "work"),
+    EVENT_WORK_END: (TID_MAIN, "E", "work"),
+    EVENT_SLEEP_BEGIN: (TID_MAIN, "B", "sleep"),
+    EVENT_SLEEP_END: (TID_MAIN, "E", "sleep"),
+    EVENT_TX_WAIT_BEGIN: (TID_MAIN, "B", "uart tx wait"),
+    EVENT_TX_WAIT_END: (TID_MAIN, "E", "uart tx wait"),
+    EVENT_COMMAND_BEGIN: (TID_MAIN, "B", "command"),
+    EVENT_COMMAND_END: (TID_MAIN, "E", "command"),
+}
+
+HEADER = re.compile(r"TRACE BEGIN clock_mhz=(\d+) entries=(\d+) lost=(\d+)")
+ENTRY = re.compile(r"^([0-9A-Fa-f]{8}) ([0-9A-Fa-f]{2}) ([0-9A-Fa-f]{4})$")
+
+CYCLE_COUNTER_RANGE = 1 << 32
+
+
+def read_dump(lines):
+    """Returns the header values and the entries of the last dump."""
+    dump = None
+    for line in lines:
+        line = line.strip()
+        match = HEADER.search(line)
+        if match:
+            dump = {
+                "clock_mhz": int(match.group(1)),
+                "lost": int(match.group(3)),
+                "entries": [],
+                "complete": False,
+            }
+        elif dump is not None and not dump["complete"]:
+            if line == "TRACE END":
+                dump["complete"] = True
+                continue
+            match = ENTRY.match(line)
+            if match:
+                dump["entries"].append((int(match.group(1), 16),
+                                        int(match.group(2), 16),
+                                        int(match.group(3), 16)))
+    if dump is None:
+        raise ValueError("no TRACE BEGIN line found")
+    return dump
+
+
+def first_clock(dump):
+    """Returns the CPU clock in MHz at the oldest entry.
+
+    The clock events carry the old clock, so the first one tells the clock
+    before it. Without a clock event, the clock of the header applies to
+    the whole dump.
+    """
+    for _, event, arg in dump["entries"]:
+        if event == EVENT_CLOCK:
+            return arg >> 8
+    return dump["clock_mhz"]
+
+
+def convert(dump):
+    """Returns the Chrome trace events of a dump."""
+    trace = []
+    for tid, name in TRACK_NAMES.items():
+        trace.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                      "args": {"name": name}})
+
+    clock_mhz = first_clock(dump)
+    if clock_mhz == 0:
+        raise ValueError("CPU clock of 0 MHz")
+
+    # Slices open per track, to drop the ends whose begin was overwritten
+    open_slices = {tid: [] for tid in TRACK_NAMES}
+    timestamp_us = 0.0
+    previous = None
+
+    trace.append({"ph": "C", "pid": PID, "tid": TID_MAIN, "ts": 0.0,
+                  "name": "CPU clock (MHz)", "args": {"MHz": clock_mhz}})
+
+    for cycles, event, arg in dump["entries"]:
+        # The cycle counter wraps; the RTC interrupt keeps the gaps below
+        # one wrap
+        if previous is not None:
+            timestamp_us += ((cycles - previous) % CYCLE_COUNTER_RANGE) / clock_mhz
+        previous = cycles
+
+        if event == EVENT_CLOCK:
+            clock_mhz = arg & 0xFF
+            if clock_mhz == 0:
+                raise ValueError("CPU clock of 0 MHz")
+            trace.append({"ph": "C", "pid": PID, "tid": TID_MAIN, "ts": timestamp_us,
+                          "name": "CPU clock (MHz)", "args": {"MHz": clock_mhz}})
+            continue
+
+        if event not in EVENTS:
+            trace.append({"ph": "i", "pid": PID, "tid": TID_MAIN, "ts": timestamp_us,
+                          "s": "t", "name": "event %d" % event, "args": {"arg": arg}})
+            continue
+
+        tid, phase, name = EVENTS[event]
+        if event == EVENT_WORK_BEGIN:
+            name = "work 0x%04X" % arg
+        elif event == EVENT_COMMAND_BEGIN:
+            name = "command '%s'" % chr(arg) if 0x20 < arg < 0x7F else "command 0x%02X" % arg
+
+        if phase == "B":
+            open_slices[tid].append(name)
+            slice_event = {"ph": "B", "pid": PID, "tid": tid, "ts": timestamp_us, "name": name}
+            if event == EVENT_TX_WAIT_BEGIN:
+                slice_event["args"] = {"bytes": arg}
+            trace.append(slice_event)
+        elif open_slices[tid]:
+            trace.append({"ph": "E", "pid": PID, "tid": tid, "ts": timestamp_us,
+                          "name": open_slices[tid].pop()})
+
+    return trace
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert an execution trace dump to the Chrome trace format.")
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin,
+                        help="terminal output with a trace dump (default: stdin)")
+    parser.add_argument("-o", "--output", type=argparse.FileType("w"), default=sys.stdout,
+                        help="Chrome trace JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    try:
+        dump = read_dump(args.log)
+        trace = convert(dump)
+    except ValueError as error:
+        parser.error(str(error))
+
+    if not dump["complete"]:
+        print("warning: the dump has no TRACE END line, it may be truncated", file=sys.stderr)
+    if dump["lost"]:
+        print("note: %d older entries were overwritten" % dump["lost"], file=sys.stderr)
+
+    json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, args.output)
+    args.output.write("\n")
+
+
+if __name__ == "__main__":
+    main()
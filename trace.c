@@ -0,0 +1,191 @@
+/******************************************************************************
+* File Name:   trace.c
+*
+* Description: This file contains the execution trace recorder. The events are
+*              recorded by trace_record() in trace.h; this file keeps the ring and
+*              reads it back for the dump.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "trace.h"
+
+#if APP_CONFIG_TRACE
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HZ_PER_MHZ               (1000000u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+trace_ring_t trace_ring;
+
+/*******************************************************************************
+* Function Name: trace_pause
+********************************************************************************
+* Summary:
+*  Stops or resumes the recording. The ring is paused while it is dumped, so
+*  that the dump does not overwrite the entries being read.
+*
+* Parameters:
+*  bool paused : true to stop the recording
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void trace_pause(bool paused)
+{
+    trace_ring.paused = paused;
+}
+
+/*******************************************************************************
+* Function Name: trace_clear
+********************************************************************************
+* Summary:
+*  Removes all entries.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void trace_clear(void)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    trace_ring.head = 0u;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: trace_count
+********************************************************************************
+* Summary:
+*  Returns the number of entries kept in the ring.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Entries, at most TRACE_BUFFER_ENTRIES
+*
+*******************************************************************************/
+uint32_t trace_count(void)
+{
+    uint32_t head = trace_ring.head;
+
+    return (head < TRACE_BUFFER_ENTRIES) ? head : TRACE_BUFFER_ENTRIES;
+}
+
+/*******************************************************************************
+* Function Name: trace_lost
+********************************************************************************
+* Summary:
+*  Returns the number of entries overwritten since the last clear.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Overwritten entries
+*
+*******************************************************************************/
+uint32_t trace_lost(void)
+{
+    return trace_ring.head - trace_count();
+}
+
+/*******************************************************************************
+* Function Name: trace_get
+********************************************************************************
+* Summary:
+*  Reads an entry kept in the ring, oldest first. The ring should be paused
+*  while it is read.
+*
+* Parameters:
+*  uint32_t index       : 0 for the oldest entry, up to trace_count() - 1
+*  trace_entry_t *entry : Destination of the entry
+*
+* Return:
+*  bool : false if the index is out of range
+*
+*******************************************************************************/
+bool trace_get(uint32_t index, trace_entry_t *entry)
+{
+    uint32_t count = trace_count();
+
+    if (index >= count)
+    {
+        return false;
+    }
+
+    *entry = trace_ring.entries[(trace_ring.head - count + index) & TRACE_BUFFER_MASK];
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: trace_clock_changed
+********************************************************************************
+* Summary:
+*  Performance state listener. Records the clock change, so that the host
+*  tool converts the cycle counts on each side with the right clock.
+*
+* Parameters:
+*  uint32_t old_hz : CPU clock before the change
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void trace_clock_changed(uint32_t old_hz)
+{
+    trace_record(TRACE_EVENT_CLOCK,
+                 ((old_hz / HZ_PER_MHZ) << 8) | ((SystemCoreClock / HZ_PER_MHZ) & 0xFFu));
+}
+
+#endif /* APP_CONFIG_TRACE */
+
+/* [] END OF FILE */
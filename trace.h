@@ -0,0 +1,178 @@
+/******************************************************************************
+* File Name:   trace.h
+*
+* Description: This file contains the declarations of the execution trace recorder.
+*              Instrumented points record an event, a cycle count and an argument into
+*              a RAM ring; tools/trace2json.py converts a dump of the ring into the
+*              Chrome trace format.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "cycle_count.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Entries kept in the ring, a power of two. The oldest entries are
+ * overwritten. */
+#if !defined(TRACE_BUFFER_ENTRIES)
+#define TRACE_BUFFER_ENTRIES         (256u)
+#endif
+
+#define TRACE_BUFFER_MASK            (TRACE_BUFFER_ENTRIES - 1u)
+
+#if (0u != (TRACE_BUFFER_ENTRIES & TRACE_BUFFER_MASK))
+#error "TRACE_BUFFER_ENTRIES must be a power of two"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Recorded events. The values are part of the dump format: keep
+ * tools/trace2json.py in sync when they change. */
+typedef enum
+{
+    TRACE_EVENT_RTC_ISR_BEGIN = 1,   /* RTC interrupt handler */
+    TRACE_EVENT_RTC_ISR_END,
+    TRACE_EVENT_UART_ISR_BEGIN,      /* UART interrupt handler */
+    TRACE_EVENT_UART_ISR_END,
+    TRACE_EVENT_WORK_BEGIN,          /* Work item, argument: low half of the handler address */
+    TRACE_EVENT_WORK_END,
+    TRACE_EVENT_SLEEP_BEGIN,         /* Main loop waiting for an interrupt */
+    TRACE_EVENT_SLEEP_END,
+    TRACE_EVENT_TX_WAIT_BEGIN,       /* Writer waiting for UART TX queue space,
+                                      * argument: bytes not queued yet */
+    TRACE_EVENT_TX_WAIT_END,
+    TRACE_EVENT_COMMAND_BEGIN,       /* Console command, argument: command byte */
+    TRACE_EVENT_COMMAND_END,
+    TRACE_EVENT_CLOCK                /* CPU clock changed, argument: old clock in MHz
+                                      * in the high byte, new clock in the low byte */
+} trace_event_t;
+
+typedef struct
+{
+    uint32_t cycles;             /* DWT cycle count */
+    uint16_t event;              /* trace_event_t */
+    uint16_t arg;
+} trace_entry_t;
+
+/* Ring; all fields are private and only visible for trace_record() */
+typedef struct
+{
+    trace_entry_t entries[TRACE_BUFFER_ENTRIES];
+    uint32_t head;               /* Entries recorded since the last clear */
+    bool paused;
+} trace_ring_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#if APP_CONFIG_TRACE
+extern trace_ring_t trace_ring;
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if APP_CONFIG_TRACE
+void trace_pause(bool paused);
+void trace_clear(void);
+uint32_t trace_count(void);
+uint32_t trace_lost(void);
+bool trace_get(uint32_t index, trace_entry_t *entry);
+void trace_clock_changed(uint32_t old_hz);
+#endif
+
+/*******************************************************************************
+* Function Name: trace_record
+********************************************************************************
+* Summary:
+*  Records an event with the current cycle count. Safe to call from any
+*  context; interrupts are masked for a few instructions. Compiles to
+*  nothing when APP_CONFIG_TRACE is 0.
+*
+* Parameters:
+*  trace_event_t event : Event
+*  uint32_t arg        : Argument, truncated to 16 bits
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE void trace_record(trace_event_t event, uint32_t arg)
+{
+#if APP_CONFIG_TRACE
+    uint32_t primask = __get_PRIMASK();
+    trace_entry_t *entry;
+
+    __disable_irq();
+    if (!trace_ring.paused)
+    {
+        entry = &trace_ring.entries[trace_ring.head & TRACE_BUFFER_MASK];
+        entry->cycles = cycle_count_get();
+        entry->event = (uint16_t)event;
+        entry->arg = (uint16_t)arg;
+        trace_ring.head++;
+    }
+    __set_PRIMASK(primask);
+#else
+    (void)event;
+    (void)arg;
+#endif
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TRACE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,580 @@
+/******************************************************************************
+* File Name:   ts_store.c
+*
+* Description: This file contains the time-series store. Samples are appended in
+*              constant time: the time is encoded as a delta-of-delta and the value as
+*              the XOR with the previous value, both as varints, in a ring of blocks.
+*              Each sample also updates the open summary of its minute; a closed
+*              minute is added to the open hour, and a closed hour to the open day,
+*              so the history is downsampled as it ages without decoding the blocks.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "ts_store.h"
+#include "time_utils.h"
+#include "string.h"
+#include "stddef.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Largest encoding of a sample: two 32-bit varints */
+#define MAX_VARINT_BYTES         (5u)
+#define MAX_SAMPLE_BYTES         (2u * MAX_VARINT_BYTES)
+
+#define VARINT_DATA_Msk          (0x7Fu)
+#define VARINT_MORE_Msk          (0x80u)
+#define VARINT_DATA_BITS         (7u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* Length of one summary period in seconds, for each tier */
+static const uint32_t tier_seconds[TS_STORE_TIER_COUNT] =
+{
+    TIME_UTILS_SEC_PER_MIN,
+    TIME_UTILS_SEC_PER_HOUR,
+    TIME_UTILS_SEC_PER_DAY
+};
+
+static const uint32_t tier_capacity[TS_STORE_TIER_COUNT] =
+{
+    TS_STORE_MINUTES,
+    TS_STORE_HOURS,
+    TS_STORE_DAYS
+};
+
+/*******************************************************************************
+* Function Name: get_summaries
+********************************************************************************
+* Summary:
+*  Returns the summary array of the requested tier.
+*
+* Parameters:
+*  const ts_store_t *store : Store instance
+*  ts_store_tier_t tier    : Requested tier
+*
+* Return:
+*  ts_store_summary_t* : Pointer to the first summary
+*
+*******************************************************************************/
+static ts_store_summary_t *get_summaries(const ts_store_t *store, ts_store_tier_t tier)
+{
+    const ts_store_summary_t *summaries;
+
+    switch (tier)
+    {
+        case TS_STORE_MINUTE:
+            summaries = store->minute;
+            break;
+        case TS_STORE_HOUR:
+            summaries = store->hour;
+            break;
+        default:
+            summaries = store->day;
+            break;
+    }
+
+    return (ts_store_summary_t *)summaries;
+}
+
+/*******************************************************************************
+* Function Name: put_varint
+********************************************************************************
+* Summary:
+*  Writes an unsigned value as a varint: 7 bits per byte, least significant
+*  first, with the top bit set on all bytes but the last.
+*
+* Parameters:
+*  uint8_t *data  : Destination, at least MAX_VARINT_BYTES long
+*  uint32_t value : Value to write
+*
+* Return:
+*  uint32_t : Number of bytes written
+*
+*******************************************************************************/
+static uint32_t put_varint(uint8_t *data, uint32_t value)
+{
+    uint32_t length = 0u;
+
+    while (value > VARINT_DATA_Msk)
+    {
+        data[length++] = (uint8_t)((value & VARINT_DATA_Msk) | VARINT_MORE_Msk);
+        value >>= VARINT_DATA_BITS;
+    }
+    data[length++] = (uint8_t)value;
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: get_varint
+********************************************************************************
+* Summary:
+*  Reads a varint written by put_varint().
+*
+* Parameters:
+*  const uint8_t **data : Read position, advanced past the varint
+*
+* Return:
+*  uint32_t : Value read
+*
+*******************************************************************************/
+static uint32_t get_varint(const uint8_t **data)
+{
+    uint32_t value = 0u;
+    uint32_t shift = 0u;
+    uint8_t byte;
+
+    do
+    {
+        byte = **data;
+        (*data)++;
+        value |= (uint32_t)(byte & VARINT_DATA_Msk) << shift;
+        shift += VARINT_DATA_BITS;
+    } while (0u != (byte & VARINT_MORE_Msk));
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: zigzag
+********************************************************************************
+* Summary:
+*  Maps a signed value to an unsigned one with small magnitudes first
+*  (0, -1, 1, -2, ...), so that small negative values make short varints.
+*
+* Parameters:
+*  int32_t value : Signed value
+*
+* Return:
+*  uint32_t : Mapped value
+*
+*******************************************************************************/
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/*******************************************************************************
+* Function Name: unzigzag
+********************************************************************************
+* Summary:
+*  Reverses zigzag().
+*
+* Parameters:
+*  uint32_t value : Mapped value
+*
+* Return:
+*  int32_t : Signed value
+*
+*******************************************************************************/
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1u);
+}
+
+/*******************************************************************************
+* Function Name: get_block
+********************************************************************************
+* Summary:
+*  Returns a block in use, counted from the oldest.
+*
+* Parameters:
+*  const ts_store_t *store : Store instance
+*  uint32_t index          : Position from the oldest block
+*
+* Return:
+*  const ts_store_block_t* : Block
+*
+*******************************************************************************/
+static const ts_store_block_t *get_block(const ts_store_t *store, uint32_t index)
+{
+    return &store->blocks[(store->first_block + index) % TS_STORE_BLOCKS];
+}
+
+/*******************************************************************************
+* Function Name: start_block
+********************************************************************************
+* Summary:
+*  Starts a new block with a sample stored in its header. When the ring is
+*  full, the oldest block is dropped.
+*
+* Parameters:
+*  ts_store_t *store : Store instance
+*  uint32_t epoch    : Time of the sample
+*  int32_t value     : Value of the sample
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void start_block(ts_store_t *store, uint32_t epoch, int32_t value)
+{
+    ts_store_block_t *block;
+
+    if (TS_STORE_BLOCKS == store->block_count)
+    {
+        store->first_block = (store->first_block + 1u) % TS_STORE_BLOCKS;
+        store->block_count--;
+        store->evicted++;
+    }
+
+    block = &store->blocks[(store->first_block + store->block_count) % TS_STORE_BLOCKS];
+    store->block_count++;
+
+    block->first_epoch = epoch;
+    block->first_value = value;
+    block->count = 1u;
+    block->used = 0u;
+    store->last_delta = 0u;
+}
+
+/*******************************************************************************
+* Function Name: add_to_tier
+********************************************************************************
+* Summary:
+*  Adds samples to the open summary of a tier. When they belong to a later
+*  period, the open summary is closed first: it is written to the ring of
+*  the tier and added to the next coarser tier.
+*
+* Parameters:
+*  ts_store_t *store    : Store instance
+*  ts_store_tier_t tier : Tier to update
+*  uint32_t epoch       : Time of the samples
+*  int32_t min          : Lowest value of the samples
+*  int32_t max          : Highest value of the samples
+*  int64_t sum          : Sum of the values
+*  uint32_t count       : Number of samples
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void add_to_tier(ts_store_t *store, ts_store_tier_t tier, uint32_t epoch,
+                        int32_t min, int32_t max, int64_t sum, uint32_t count)
+{
+    ts_store_bucket_t *bucket = &store->open[tier];
+    ts_store_summary_t *summary;
+    uint32_t start = epoch - (epoch % tier_seconds[tier]);
+
+    if ((0u != bucket->count) && (bucket->start != start))
+    {
+        summary = &get_summaries(store, tier)[store->head[tier]];
+        summary->start = bucket->start;
+        summary->min = bucket->min;
+        summary->max = bucket->max;
+        summary->avg = (int32_t)(bucket->sum / (int64_t)bucket->count);
+        summary->count = bucket->count;
+
+        store->head[tier] = (store->head[tier] + 1u) % tier_capacity[tier];
+        if (store->used[tier] < tier_capacity[tier])
+        {
+            store->used[tier]++;
+        }
+
+        if ((uint32_t)tier + 1u < (uint32_t)TS_STORE_TIER_COUNT)
+        {
+            add_to_tier(store, (ts_store_tier_t)(tier + 1), bucket->start,
+                        bucket->min, bucket->max, bucket->sum, bucket->count);
+        }
+
+        bucket->count = 0u;
+    }
+
+    if (0u == bucket->count)
+    {
+        bucket->start = start;
+        bucket->min = min;
+        bucket->max = max;
+        bucket->sum = 0;
+    }
+    else
+    {
+        bucket->min = (min < bucket->min) ? min : bucket->min;
+        bucket->max = (max > bucket->max) ? max : bucket->max;
+    }
+    bucket->sum += sum;
+    bucket->count += count;
+}
+
+/*******************************************************************************
+* Function Name: ts_store_init
+********************************************************************************
+* Summary:
+*  Removes all samples and summaries.
+*
+* Parameters:
+*  ts_store_t *store : Store instance
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void ts_store_init(ts_store_t *store)
+{
+    memset(store, 0, sizeof(*store));
+}
+
+/*******************************************************************************
+* Function Name: ts_store_append
+********************************************************************************
+* Summary:
+*  Appends a sample. The cost is constant: the sample is encoded at the end
+*  of the newest block, or starts a new block, and the open summaries are
+*  updated. Samples must be in time order; a sample older than the newest
+*  one is rejected.
+*
+* Parameters:
+*  ts_store_t *store : Store instance
+*  uint32_t epoch    : Time of the sample, seconds since the epoch
+*  int32_t value     : Value of the sample
+*
+* Return:
+*  bool : false if the sample was rejected
+*
+*******************************************************************************/
+bool ts_store_append(ts_store_t *store, uint32_t epoch, int32_t value)
+{
+    ts_store_block_t *block;
+    uint32_t delta;
+
+    if ((0u != store->appended) && (epoch < store->last_epoch))
+    {
+        store->rejected++;
+        return false;
+    }
+
+    block = &store->blocks[(store->first_block + store->block_count - 1u) % TS_STORE_BLOCKS];
+    if ((0u == store->block_count) ||
+        ((block->used + MAX_SAMPLE_BYTES) > TS_STORE_BLOCK_BYTES) ||
+        (UINT16_MAX == block->count))
+    {
+        start_block(store, epoch, value);
+    }
+    else
+    {
+        delta = epoch - store->last_epoch;
+        block->used += (uint16_t)put_varint(&block->data[block->used],
+                                            zigzag((int32_t)(delta - store->last_delta)));
+        block->used += (uint16_t)put_varint(&block->data[block->used],
+                                            (uint32_t)(value ^ store->last_value));
+        block->count++;
+        store->last_delta = delta;
+    }
+
+    store->last_epoch = epoch;
+    store->last_value = value;
+    store->appended++;
+
+    add_to_tier(store, TS_STORE_MINUTE, epoch, value, value, value, 1u);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ts_store_query
+********************************************************************************
+* Summary:
+*  Passes the raw samples between two times, both included, to the visitor
+*  in time order. The blocks that end before the range are skipped without
+*  being decoded.
+*
+* Parameters:
+*  const ts_store_t *store           : Store instance
+*  uint32_t start                    : Start of the range
+*  uint32_t end                      : End of the range
+*  ts_store_sample_visitor_t visitor : Called for each sample in the range
+*  void *context                     : Passed to the visitor
+*
+* Return:
+*  uint32_t : Number of samples in the range
+*
+*******************************************************************************/
+uint32_t ts_store_query(const ts_store_t *store, uint32_t start, uint32_t end,
+                        ts_store_sample_visitor_t visitor, void *context)
+{
+    const ts_store_block_t *block;
+    const uint8_t *data;
+    uint32_t matches = 0u;
+    uint32_t epoch;
+    uint32_t delta;
+    int32_t value;
+    uint32_t index;
+    uint32_t i;
+
+    for (index = 0u; index < store->block_count; index++)
+    {
+        block = get_block(store, index);
+
+        /* All samples of a block are at or before the next block */
+        if (((index + 1u) < store->block_count) &&
+            (get_block(store, index + 1u)->first_epoch < start))
+        {
+            continue;
+        }
+
+        data = block->data;
+        epoch = block->first_epoch;
+        value = block->first_value;
+        delta = 0u;
+
+        for (i = 0u; i < block->count; i++)
+        {
+            if (0u != i)
+            {
+                delta += (uint32_t)unzigzag(get_varint(&data));
+                epoch += delta;
+                value ^= (int32_t)get_varint(&data);
+            }
+
+            if (epoch > end)
+            {
+                return matches;
+            }
+            if (epoch >= start)
+            {
+                matches++;
+                visitor(epoch, value, context);
+            }
+        }
+    }
+
+    return matches;
+}
+
+/*******************************************************************************
+* Function Name: ts_store_query_tier
+********************************************************************************
+* Summary:
+*  Passes the summaries of a tier whose period overlaps the range to the
+*  visitor in time order, followed by the open summary. The open summaries
+*  of the hour and day tiers do not include the open minute and hour.
+*
+* Parameters:
+*  const ts_store_t *store            : Store instance
+*  ts_store_tier_t tier               : Tier to read
+*  uint32_t start                     : Start of the range
+*  uint32_t end                       : End of the range
+*  ts_store_summary_visitor_t visitor : Called for each summary in the range
+*  void *context                      : Passed to the visitor
+*
+* Return:
+*  uint32_t : Number of summaries in the range
+*
+*******************************************************************************/
+uint32_t ts_store_query_tier(const ts_store_t *store, ts_store_tier_t tier,
+                             uint32_t start, uint32_t end,
+                             ts_store_summary_visitor_t visitor, void *context)
+{
+    const ts_store_summary_t *summaries = get_summaries(store, tier);
+    const ts_store_bucket_t *bucket = &store->open[tier];
+    uint32_t capacity = tier_capacity[tier];
+    uint32_t period = tier_seconds[tier];
+    uint32_t oldest = (store->head[tier] + capacity - store->used[tier]) % capacity;
+    ts_store_summary_t open;
+    uint32_t matches = 0u;
+    uint32_t i;
+
+    for (i = 0u; i < store->used[tier]; i++)
+    {
+        const ts_store_summary_t *summary = &summaries[(oldest + i) % capacity];
+
+        if (summary->start > end)
+        {
+            return matches;
+        }
+        if ((summary->start + period) > start)
+        {
+            matches++;
+            visitor(summary, context);
+        }
+    }
+
+    if ((0u != bucket->count) && (bucket->start <= end) && ((bucket->start + period) > start))
+    {
+        open.start = bucket->start;
+        open.min = bucket->min;
+        open.max = bucket->max;
+        open.avg = (int32_t)(bucket->sum / (int64_t)bucket->count);
+        open.count = bucket->count;
+        matches++;
+        visitor(&open, context);
+    }
+
+    return matches;
+}
+
+/*******************************************************************************
+* Function Name: ts_store_get_stats
+********************************************************************************
+* Summary:
+*  Returns the sample counters and the size of the raw blocks in use.
+*
+* Parameters:
+*  const ts_store_t *store  : Store instance
+*  ts_store_stats_t *stats  : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void ts_store_get_stats(const ts_store_t *store, ts_store_stats_t *stats)
+{
+    const ts_store_block_t *block;
+    uint32_t index;
+
+    stats->appended = store->appended;
+    stats->rejected = store->rejected;
+    stats->evicted = store->evicted;
+    stats->raw_samples = 0u;
+    stats->raw_bytes = 0u;
+    stats->oldest_raw = (0u != store->block_count) ? get_block(store, 0u)->first_epoch : 0u;
+
+    for (index = 0u; index < store->block_count; index++)
+    {
+        block = get_block(store, index);
+        stats->raw_samples += block->count;
+        stats->raw_bytes += (uint32_t)offsetof(ts_store_block_t, data) + block->used;
+    }
+}
+
+/* [] END OF FILE */
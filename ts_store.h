@@ -0,0 +1,164 @@
+/******************************************************************************
+* File Name:   ts_store.h
+*
+* Description: This file contains the declarations of the time-series store: compressed
+*              raw samples and min/max/avg summaries per minute, hour and day.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TS_STORE_H
+#define TS_STORE_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Raw samples are compressed into a ring of blocks; the oldest block is
+ * dropped when the ring is full */
+#define TS_STORE_BLOCKS          (24u)
+#define TS_STORE_BLOCK_BYTES     (256u)
+
+/* Number of summaries kept for each tier */
+#define TS_STORE_MINUTES         (360u)
+#define TS_STORE_HOURS           (168u)
+#define TS_STORE_DAYS            (90u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    TS_STORE_MINUTE = 0,
+    TS_STORE_HOUR,
+    TS_STORE_DAY,
+    TS_STORE_TIER_COUNT
+} ts_store_tier_t;
+
+/* Summary of the samples of one calendar period */
+typedef struct
+{
+    uint32_t start;              /* Start of the period, seconds since the epoch */
+    int32_t min;
+    int32_t max;
+    int32_t avg;
+    uint32_t count;
+} ts_store_summary_t;
+
+/* Summary of the period in progress */
+typedef struct
+{
+    uint32_t start;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint32_t count;
+} ts_store_bucket_t;
+
+/* The first sample is kept in the header; each following sample is the
+ * zigzag varint of its delta-of-delta time and the varint of its value
+ * XOR the previous value */
+typedef struct
+{
+    uint32_t first_epoch;
+    int32_t first_value;
+    uint16_t count;
+    uint16_t used;               /* Bytes of data[] in use */
+    uint8_t data[TS_STORE_BLOCK_BYTES];
+} ts_store_block_t;
+
+typedef struct
+{
+    ts_store_block_t blocks[TS_STORE_BLOCKS];
+    uint32_t first_block;        /* Oldest block in use */
+    uint32_t block_count;
+    ts_store_summary_t minute[TS_STORE_MINUTES];
+    ts_store_summary_t hour[TS_STORE_HOURS];
+    ts_store_summary_t day[TS_STORE_DAYS];
+    uint32_t head[TS_STORE_TIER_COUNT];      /* Next summary to write */
+    uint32_t used[TS_STORE_TIER_COUNT];      /* Summaries in use */
+    ts_store_bucket_t open[TS_STORE_TIER_COUNT];
+    uint32_t last_epoch;
+    uint32_t last_delta;
+    int32_t last_value;
+    uint32_t appended;
+    uint32_t rejected;
+    uint32_t evicted;
+} ts_store_t;
+
+typedef struct
+{
+    uint32_t appended;           /* Samples accepted since init */
+    uint32_t rejected;           /* Samples older than the newest sample */
+    uint32_t evicted;            /* Raw blocks dropped */
+    uint32_t raw_samples;        /* Samples in the raw blocks */
+    uint32_t raw_bytes;          /* Bytes of the raw blocks in use, headers included */
+    uint32_t oldest_raw;         /* Time of the oldest raw sample */
+} ts_store_stats_t;
+
+/* Called for each sample of a query, in time order */
+typedef void (*ts_store_sample_visitor_t)(uint32_t epoch, int32_t value, void *context);
+
+/* Called for each summary of a query, in time order */
+typedef void (*ts_store_summary_visitor_t)(const ts_store_summary_t *summary, void *context);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ts_store_init(ts_store_t *store);
+bool ts_store_append(ts_store_t *store, uint32_t epoch, int32_t value);
+uint32_t ts_store_query(const ts_store_t *store, uint32_t start, uint32_t end,
+                        ts_store_sample_visitor_t visitor, void *context);
+uint32_t ts_store_query_tier(const ts_store_t *store, ts_store_tier_t tier,
+                             uint32_t start, uint32_t end,
+                             ts_store_summary_visitor_t visitor, void *context);
+void ts_store_get_stats(const ts_store_t *store, ts_store_stats_t *stats);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TS_STORE_H */
+
+/* [] END OF FILE */
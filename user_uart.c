@@ -0,0 +1,801 @@
+/******************************************************************************
+* File Name:   user_uart.c
+*
+* Description: This file contains the interrupt driven USER_UART transmit and
+*              receive paths.
+*              Strings are copied into a software queue and moved to the TX FIFO
+*              by the SCB TX trigger interrupt. When the queue is full, the writer
+*              sleeps until the interrupt frees space instead of busy-waiting on
+*              the FIFO, so a terminal that deasserts CTS does not keep the CPU busy.
+*              Received bytes are moved from the RX FIFO into a software queue
+*              by the interrupt, with its cycle count, which then posts the RX
+*              work item.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "user_uart.h"
+#include "app_config.h"
+#include "trace.h"
+#include "cybsp.h"
+#include "string.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TX_BUFFER_MASK          (USER_UART_TX_BUFFER_SIZE - 1u)
+#define RX_BUFFER_MASK          (USER_UART_RX_BUFFER_SIZE - 1u)
+
+/* RX events counted as errors */
+#define RX_ERROR_EVENTS         (CY_SCB_UART_RX_OVERFLOW | CY_SCB_UART_RX_ERR_FRAME | \
+                                 CY_SCB_UART_RX_ERR_PARITY)
+
+/* The TX trigger fires when the FIFO holds less than half of its capacity */
+#define TX_FIFO_LEVEL_DIVIDER   (2u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static cy_stc_scb_uart_context_t USER_UART_context;
+
+static uint8_t tx_buffer[USER_UART_TX_BUFFER_SIZE];
+static volatile uint32_t tx_head;    /* Written by the application only */
+static volatile uint32_t tx_tail;    /* Written by the interrupt only */
+
+static user_uart_tx_stats_t tx_stats;
+
+static uint8_t rx_buffer[USER_UART_RX_BUFFER_SIZE];
+static uint32_t rx_cycles[USER_UART_RX_BUFFER_SIZE]; /* Cycle count of the interrupt */
+static uint32_t rx_last_cycles = 0u;  /* Of the last byte read */
+static volatile uint32_t rx_head;    /* Written by the interrupt only */
+static volatile uint32_t rx_tail;    /* Written by the application only */
+
+static user_uart_rx_stats_t rx_stats;
+static work_handler_t rx_work = NULL;
+
+/* SCB clock set in the Device Configurator, kept when the source changes */
+static uint32_t scb_clock_hz = 0u;
+
+/* Cost of the interrupt handler */
+static cycle_stats_t isr_cycles;
+static bool uart_ready = false;
+
+static const cy_stc_sysint_t user_uart_irq_cfg =
+{
+    .intrSrc = USER_UART_IRQ,
+    .intrPriority = USER_UART_IRQ_PRIORITY
+};
+
+/*******************************************************************************
+* Function Name: tx_fill_fifo
+********************************************************************************
+* Summary:
+*  Moves as many queued bytes as fit into the TX FIFO. Disables the TX trigger
+*  interrupt once the queue is empty.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void tx_fill_fifo(void)
+{
+    uint32_t tail = tx_tail;
+    uint32_t chunk;
+    uint32_t written;
+
+    while (tail != tx_head)
+    {
+        /* Largest contiguous run of queued bytes */
+        chunk = (tx_head - tail) & TX_BUFFER_MASK;
+        if (chunk > (USER_UART_TX_BUFFER_SIZE - tail))
+        {
+            chunk = USER_UART_TX_BUFFER_SIZE - tail;
+        }
+
+        written = Cy_SCB_UART_PutArray(USER_UART_HW, &tx_buffer[tail], chunk);
+        tail = (tail + written) & TX_BUFFER_MASK;
+
+        if (written < chunk)
+        {
+            /* FIFO full, wait for the next trigger */
+            break;
+        }
+    }
+
+    tx_tail = tail;
+
+    if (tail == tx_head)
+    {
+        Cy_SCB_SetTxInterruptMask(USER_UART_HW, 0u);
+    }
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: rx_empty_fifo
+********************************************************************************
+* Summary:
+*  Moves the received bytes from the RX FIFO into the software queue, with
+*  the cycle count of the interrupt. Bytes that do not fit are dropped and
+*  counted.
+*
+* Parameters:
+*  uint32_t cycles : Cycle count at the start of the interrupt
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void rx_empty_fifo(uint32_t cycles)
+{
+    uint32_t head = rx_head;
+
+    while (0u != Cy_SCB_UART_GetNumInRxFifo(USER_UART_HW))
+    {
+        uint32_t ch = Cy_SCB_UART_Get(USER_UART_HW);
+
+        rx_stats.bytes++;
+        if (((head + 1u) & RX_BUFFER_MASK) == rx_tail)
+        {
+            rx_stats.dropped++;
+        }
+        else
+        {
+            rx_buffer[head] = (uint8_t)ch;
+            rx_cycles[head] = cycles;
+            head = (head + 1u) & RX_BUFFER_MASK;
+        }
+    }
+
+    rx_head = head;
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: user_uart_isr
+********************************************************************************
+* Summary:
+*  USER_UART interrupt handler. Refills the TX FIFO from the software queue,
+*  empties the RX FIFO into the RX queue and posts the RX work item. The cost
+*  of the handler is accumulated in isr_cycles.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+static void user_uart_isr(void)
+{
+    uint32_t start = cycle_count_get();
+    uint32_t rx_status = Cy_SCB_GetRxInterruptStatusMasked(USER_UART_HW);
+
+    trace_record(TRACE_EVENT_UART_ISR_BEGIN, 0u);
+
+    if (0u != (Cy_SCB_GetTxInterruptStatusMasked(USER_UART_HW) & CY_SCB_UART_TX_TRIGGER))
+    {
+        tx_fill_fifo();
+        Cy_SCB_ClearTxInterrupt(USER_UART_HW, CY_SCB_UART_TX_TRIGGER);
+    }
+
+    if (0u != rx_status)
+    {
+        if (0u != (rx_status & RX_ERROR_EVENTS))
+        {
+            rx_stats.errors++;
+        }
+
+        rx_empty_fifo(start);
+        Cy_SCB_ClearRxInterrupt(USER_UART_HW, rx_status);
+
+        if ((NULL != rx_work) && (rx_head != rx_tail))
+        {
+            (void)work_queue_post(WORK_PRIORITY_NORMAL, rx_work, 0u,
+                                  USER_UART_RX_WORK_KEY);
+        }
+    }
+
+    trace_record(TRACE_EVENT_UART_ISR_END, 0u);
+    cycle_stats_add(&isr_cycles, start);
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: tx_free_space
+********************************************************************************
+* Summary:
+*  Returns the number of bytes that can be queued without waiting.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Free bytes in the TX queue
+*
+*******************************************************************************/
+static uint32_t tx_free_space(void)
+{
+    return (TX_BUFFER_MASK - ((tx_head - tx_tail) & TX_BUFFER_MASK));
+}
+
+/*******************************************************************************
+* Function Name: tx_wait_for_progress
+********************************************************************************
+* Summary:
+*  Waits until the TX interrupt has consumed queued data. The CPU sleeps in
+*  WFI while waiting. If interrupts are masked, for example on the error path,
+*  the FIFO is refilled by polling instead.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_wait_for_progress(void)
+{
+    uint32_t tail = tx_tail;
+    uint32_t interruptState;
+
+    if (0u != __get_PRIMASK())
+    {
+        tx_fill_fifo();
+    }
+    else
+    {
+        /* WFI wakes up on a pending interrupt even with PRIMASK set, so the
+         * check and the sleep cannot race with the TX interrupt. */
+        interruptState = Cy_SysLib_EnterCriticalSection();
+        if (tail == tx_tail)
+        {
+            __WFI();
+        }
+        Cy_SysLib_ExitCriticalSection(interruptState);
+    }
+}
+
+/*******************************************************************************
+* Function Name: tx_enqueue
+********************************************************************************
+* Summary:
+*  Copies bytes into the TX queue and enables the TX trigger interrupt.
+*  The caller must make sure that there is enough free space.
+*
+* Parameters:
+*  const uint8_t *data : Bytes to queue
+*  uint32_t size       : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_enqueue(const uint8_t *data, uint32_t size)
+{
+    uint32_t head = tx_head;
+    uint32_t chunk = USER_UART_TX_BUFFER_SIZE - head;
+
+    if (chunk > size)
+    {
+        chunk = size;
+    }
+
+    memcpy(&tx_buffer[head], data, chunk);
+    memcpy(&tx_buffer[0], &data[chunk], size - chunk);
+
+    tx_head = (head + size) & TX_BUFFER_MASK;
+    tx_stats.bytes += size;
+    Cy_SCB_SetTxInterruptMask(USER_UART_HW, CY_SCB_UART_TX_TRIGGER);
+}
+
+/*******************************************************************************
+* Function Name: user_uart_init
+********************************************************************************
+* Summary:
+*  Initializes and enables the USER_UART and its interrupt. Reception is
+*  interrupt driven from the start. Flow control starts with the settings of
+*  the Device Configurator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  cy_en_scb_uart_status_t : Status of the UART initialization
+*
+*******************************************************************************/
+cy_en_scb_uart_status_t user_uart_init(void)
+{
+    cy_en_scb_uart_status_t uartSta;
+
+    uartSta = Cy_SCB_UART_Init(USER_UART_HW, &USER_UART_config, &USER_UART_context);
+    if (uartSta == CY_SCB_UART_SUCCESS)
+    {
+        cycle_count_init();
+
+        Cy_SCB_UART_SetTxFifoLevel(USER_UART_HW,
+                                   Cy_SCB_GetFifoSize(USER_UART_HW) / TX_FIFO_LEVEL_DIVIDER);
+        Cy_SCB_SetTxInterruptMask(USER_UART_HW, 0u);
+        Cy_SCB_SetRxInterruptMask(USER_UART_HW, CY_SCB_UART_RX_NOT_EMPTY | RX_ERROR_EVENTS);
+
+        (void)Cy_SysInt_Init(&user_uart_irq_cfg, user_uart_isr);
+        NVIC_EnableIRQ(user_uart_irq_cfg.intrSrc);
+
+        tx_stats.cts_enabled = (0u != USER_UART_config.enableCts);
+        tx_stats.rts_level = USER_UART_config.rtsRxFifoLevel;
+
+        scb_clock_hz = Cy_SysClk_PeriPclkGetFrequency(USER_UART_CLK_DST,
+                                                      USER_UART_CLK_DIV_TYPE,
+                                                      USER_UART_CLK_DIV_NUM);
+
+        Cy_SCB_UART_Enable(USER_UART_HW);
+        uart_ready = true;
+    }
+
+    return uartSta;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_write
+********************************************************************************
+* Summary:
+*  Queues bytes for transmission. If the queue is full, the function sleeps
+*  until the TX interrupt makes room; the time spent waiting is counted as
+*  stall time.
+*
+* Parameters:
+*  const uint8_t *data : Bytes to send
+*  uint32_t size       : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_write(const uint8_t *data, uint32_t size)
+{
+    uint32_t chunk;
+    uint32_t start;
+    bool stalled = false;
+
+    start = cycle_count_get();
+
+    while (size != 0u)
+    {
+        chunk = tx_free_space();
+        if (chunk == 0u)
+        {
+            if (!stalled)
+            {
+                trace_record(TRACE_EVENT_TX_WAIT_BEGIN, size);
+            }
+            stalled = true;
+            tx_wait_for_progress();
+            continue;
+        }
+
+        if (chunk > size)
+        {
+            chunk = size;
+        }
+
+        tx_enqueue(data, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+
+    if (stalled)
+    {
+        trace_record(TRACE_EVENT_TX_WAIT_END, 0u);
+        tx_stats.stall_count++;
+        tx_stats.stall_cycles += cycle_count_get() - start;
+    }
+}
+
+/*******************************************************************************
+* Function Name: user_uart_puts
+********************************************************************************
+* Summary:
+*  Queues a null-terminated string for transmission. Waits for queue space
+*  if necessary.
+*
+* Parameters:
+*  const char *str : String to send
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_puts(const char *str)
+{
+    user_uart_write((const uint8_t *)str, (uint32_t)strlen(str));
+}
+
+/*******************************************************************************
+* Function Name: user_uart_putc
+********************************************************************************
+* Summary:
+*  Queues a single character for transmission.
+*
+* Parameters:
+*  uint8_t ch : Character to send
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_putc(uint8_t ch)
+{
+    user_uart_write(&ch, 1u);
+}
+
+/*******************************************************************************
+* Function Name: user_uart_try_puts
+********************************************************************************
+* Summary:
+*  Queues a string only if it fits into the TX queue right away. Used to pace
+*  periodic output: when the terminal does not keep up, the output is skipped
+*  instead of blocking the caller.
+*
+* Parameters:
+*  const char *str : String to send
+*
+* Return:
+*  bool : true if the string was queued, false if it was skipped
+*
+*******************************************************************************/
+bool user_uart_try_puts(const char *str)
+{
+    uint32_t size = (uint32_t)strlen(str);
+    bool queued = false;
+
+    if (size <= tx_free_space())
+    {
+        tx_enqueue((const uint8_t *)str, size);
+        queued = true;
+    }
+    else
+    {
+        tx_stats.dropped_writes++;
+    }
+
+    return queued;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_flush
+********************************************************************************
+* Summary:
+*  Waits until all queued bytes have been shifted out of the UART, for at
+*  most USER_UART_FLUSH_TIMEOUT_US, so that a deasserted CTS or a paused
+*  terminal cannot hang the caller. The wait polls instead of sleeping until
+*  the TX interrupt, which does not come while CTS holds the transmitter.
+*  Can be called with interrupts disabled. Returns immediately if the UART
+*  has not been initialized.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if all bytes were sent, false if the wait timed out
+*
+*******************************************************************************/
+bool user_uart_flush(void)
+{
+    uint32_t start;
+    uint32_t limit;
+    bool sent;
+
+    if (!uart_ready)
+    {
+        return true;
+    }
+
+    trace_record(TRACE_EVENT_TX_WAIT_BEGIN, (tx_head - tx_tail) & TX_BUFFER_MASK);
+
+    start = cycle_count_get();
+    limit = (SystemCoreClock / 1000000u) * USER_UART_FLUSH_TIMEOUT_US;
+    do
+    {
+        if ((tx_tail != tx_head) && (0u != __get_PRIMASK()))
+        {
+            tx_fill_fifo();
+        }
+        sent = (tx_tail == tx_head) && Cy_SCB_UART_IsTxComplete(USER_UART_HW);
+    } while (!sent && ((cycle_count_get() - start) < limit));
+
+    if (!sent)
+    {
+        tx_stats.flush_timeouts++;
+    }
+
+    trace_record(TRACE_EVENT_TX_WAIT_END, 0u);
+
+    return sent;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_set_flow_control
+********************************************************************************
+* Summary:
+*  Configures hardware flow control at runtime. With CTS enabled, the SCB
+*  stops shifting out the TX FIFO while CTS is deasserted and the writers
+*  sleep until the terminal is ready again. The RTS line is deasserted when
+*  the RX FIFO holds 'rts_level' or more bytes.
+*  The RTS and CTS pins must be routed to the SCB in the Device Configurator.
+*
+* Parameters:
+*  bool cts_enable    : true to honor the CTS input
+*  uint32_t rts_level : RX FIFO level for RTS, USER_UART_RTS_DISABLED to
+*                       disable RTS
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_set_flow_control(bool cts_enable, uint32_t rts_level)
+{
+    if (cts_enable)
+    {
+        Cy_SCB_UART_EnableCts(USER_UART_HW);
+    }
+    else
+    {
+        Cy_SCB_UART_DisableCts(USER_UART_HW);
+    }
+
+    Cy_SCB_UART_SetRtsFifoLevel(USER_UART_HW, rts_level);
+
+    tx_stats.cts_enabled = cts_enable;
+    tx_stats.rts_level = rts_level;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_get_tx_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the TX statistics.
+*
+* Parameters:
+*  user_uart_tx_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_get_tx_stats(user_uart_tx_stats_t *stats)
+{
+    *stats = tx_stats;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_set_rx_handler
+********************************************************************************
+* Summary:
+*  Sets the work item posted when bytes have been received. Multiple RX
+*  interrupts are coalesced into one pending item.
+*
+* Parameters:
+*  work_handler_t handler : Work handler, NULL to post nothing
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_set_rx_handler(work_handler_t handler)
+{
+    rx_work = handler;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_read_byte
+********************************************************************************
+* Summary:
+*  Takes one byte from the RX queue without waiting.
+*
+* Parameters:
+*  uint8_t *ch : Destination of the byte
+*
+* Return:
+*  bool : false if no byte was available
+*
+*******************************************************************************/
+bool user_uart_read_byte(uint8_t *ch)
+{
+    uint32_t tail = rx_tail;
+    bool available = (tail != rx_head);
+
+    if (available)
+    {
+        *ch = rx_buffer[tail];
+        rx_last_cycles = rx_cycles[tail];
+        rx_tail = (tail + 1u) & RX_BUFFER_MASK;
+    }
+
+    return available;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_rx_cycles
+********************************************************************************
+* Summary:
+*  Returns the cycle count of the interrupt that received the last byte
+*  taken by user_uart_read_byte(), to time it without the wait in the RX
+*  queue.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Cycle count at the start of the interrupt
+*
+*******************************************************************************/
+uint32_t user_uart_rx_cycles(void)
+{
+    return rx_last_cycles;
+}
+
+/*******************************************************************************
+* Function Name: user_uart_rx_pending
+********************************************************************************
+* Summary:
+*  Checks whether the RX queue holds bytes, without taking them.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if at least one byte is available
+*
+*******************************************************************************/
+bool user_uart_rx_pending(void)
+{
+    return (rx_tail != rx_head);
+}
+
+/*******************************************************************************
+* Function Name: user_uart_get_rx_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the RX statistics.
+*
+* Parameters:
+*  user_uart_rx_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_get_rx_stats(user_uart_rx_stats_t *stats)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    *stats = rx_stats;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: user_uart_get_isr_cycles
+********************************************************************************
+* Summary:
+*  Returns the cost in CPU cycles of the interrupt handler since boot, from
+*  the handler entry to its return. The hardware exception entry and exit
+*  are not included.
+*
+* Parameters:
+*  cycle_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void user_uart_get_isr_cycles(cycle_stats_t *stats)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    *stats = isr_cycles;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: user_uart_update_clock
+********************************************************************************
+* Summary:
+*  Recomputes the peripheral clock divider of the UART after a change of the
+*  clock that feeds it, so that the SCB clock and the baud rate stay as
+*  configured. The caller must flush the TX queue before the clock change: a
+*  byte shifted out while the clock changes is corrupted. A byte received at
+*  the same time may be lost and counted as an error.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if the divider was changed
+*
+*******************************************************************************/
+bool user_uart_update_clock(void)
+{
+    uint32_t divider;
+    uint32_t source_hz;
+    uint32_t new_divider;
+
+    if ((!uart_ready) || (0u == scb_clock_hz))
+    {
+        return false;
+    }
+
+    divider = Cy_SysClk_PeriPclkGetDivider(USER_UART_CLK_DST, USER_UART_CLK_DIV_TYPE,
+                                           USER_UART_CLK_DIV_NUM);
+    source_hz = Cy_SysClk_PeriPclkGetFrequency(USER_UART_CLK_DST, USER_UART_CLK_DIV_TYPE,
+                                               USER_UART_CLK_DIV_NUM) * (divider + 1u);
+
+    /* Nearest divider, the register holds the division ratio minus one */
+    new_divider = (source_hz + (scb_clock_hz / 2u)) / scb_clock_hz;
+    if (new_divider > 0u)
+    {
+        new_divider--;
+    }
+    if (new_divider > USER_UART_CLK_DIV_MAX)
+    {
+        new_divider = USER_UART_CLK_DIV_MAX;
+    }
+
+    if (new_divider == divider)
+    {
+        return false;
+    }
+
+    (void)Cy_SysClk_PeriPclkDisableDivider(USER_UART_CLK_DST, USER_UART_CLK_DIV_TYPE,
+                                           USER_UART_CLK_DIV_NUM);
+    (void)Cy_SysClk_PeriPclkSetDivider(USER_UART_CLK_DST, USER_UART_CLK_DIV_TYPE,
+                                       USER_UART_CLK_DIV_NUM, new_divider);
+    (void)Cy_SysClk_PeriPclkEnableDivider(USER_UART_CLK_DST, USER_UART_CLK_DIV_TYPE,
+                                          USER_UART_CLK_DIV_NUM);
+
+    return true;
+}
+
+/* [] END OF FILE */
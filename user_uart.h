@@ -0,0 +1,145 @@
+/******************************************************************************
+* File Name:   user_uart.h
+*
+* Description: This file contains the declarations of the interrupt driven
+*              USER_UART transmit and receive paths with optional RTS/CTS flow
+*              control.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef USER_UART_H
+#define USER_UART_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "work_queue.h"
+#include "cycle_count.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Size of the software TX queue, must be a power of two */
+#define USER_UART_TX_BUFFER_SIZE     (256u)
+
+/* Size of the software RX queue, must be a power of two */
+#define USER_UART_RX_BUFFER_SIZE     (64u)
+
+/* Longest wait of user_uart_flush(). A full TX queue and FIFO take about
+ * 24 ms at 115200 baud; the wait ends earlier if CTS holds the transmitter */
+#define USER_UART_FLUSH_TIMEOUT_US   (50000u)
+
+/* Coalescing key of the RX work item */
+#define USER_UART_RX_WORK_KEY        (1u)
+
+/* Interrupt priority of the USER_UART */
+#define USER_UART_IRQ_PRIORITY       (3u)
+
+/* Passing this RTS level to user_uart_set_flow_control() disables RTS */
+#define USER_UART_RTS_DISABLED       (0u)
+
+/* Peripheral clock divider of the USER_UART, as set in the Device
+ * Configurator */
+#if !defined(USER_UART_CLK_DST)
+#define USER_UART_CLK_DST            (PCLK_SCB3_CLOCK_SCB_EN)
+#endif
+
+#if !defined(USER_UART_CLK_DIV_TYPE)
+#define USER_UART_CLK_DIV_TYPE       (CY_SYSCLK_DIV_8_BIT)
+#endif
+
+#if !defined(USER_UART_CLK_DIV_NUM)
+#define USER_UART_CLK_DIV_NUM        (0u)
+#endif
+
+/* Highest value of the divider register */
+#if !defined(USER_UART_CLK_DIV_MAX)
+#define USER_UART_CLK_DIV_MAX        (255u)
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t bytes;              /* Bytes queued for transmission */
+    uint32_t stall_count;        /* Writes that had to wait for queue space */
+    uint32_t stall_cycles;       /* CPU cycles spent waiting for queue space */
+    uint32_t dropped_writes;     /* Paced writes skipped because the queue was busy */
+    uint32_t flush_timeouts;     /* Flushes that gave up with bytes left to send */
+    uint32_t rts_level;          /* Current RTS trigger level, 0 if disabled */
+    bool cts_enabled;
+} user_uart_tx_stats_t;
+
+typedef struct
+{
+    uint32_t bytes;              /* Bytes received */
+    uint32_t errors;             /* FIFO overflow, frame and parity errors */
+    uint32_t dropped;            /* Bytes lost because the RX queue was full */
+} user_uart_rx_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_en_scb_uart_status_t user_uart_init(void);
+void user_uart_write(const uint8_t *data, uint32_t size);
+void user_uart_puts(const char *str);
+void user_uart_putc(uint8_t ch);
+bool user_uart_try_puts(const char *str);
+bool user_uart_flush(void);
+void user_uart_set_flow_control(bool cts_enable, uint32_t rts_level);
+void user_uart_get_tx_stats(user_uart_tx_stats_t *stats);
+void user_uart_set_rx_handler(work_handler_t handler);
+bool user_uart_read_byte(uint8_t *ch);
+uint32_t user_uart_rx_cycles(void);
+bool user_uart_rx_pending(void);
+void user_uart_get_rx_stats(user_uart_rx_stats_t *stats);
+void user_uart_get_isr_cycles(cycle_stats_t *stats);
+bool user_uart_update_clock(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* USER_UART_H */
+
+/* [] END OF FILE */
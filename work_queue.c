@@ -0,0 +1,394 @@
+/******************************************************************************
+* File Name:   work_queue.c
+*
+* Description: This file contains the deferred work queue. Interrupt handlers post
+*              function and argument items; the main loop runs them in priority
+*              order. Each priority level is a lock-free multi-producer, single-
+*              consumer ring: producers reserve a slot with LDREX/STREX and publish
+*              it with a ready flag, so handlers of any priority can post without
+*              disabling interrupts. Items posted with the same coalescing key are
+*              merged while one of them is pending.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "work_queue.h"
+#include "app_config.h"
+#include "cycle_count.h"
+#include "rtc_tick.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define WORK_QUEUE_MASK          (WORK_QUEUE_SIZE - 1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    work_handler_t handler;
+    uint32_t arg;
+    uint32_t coalesce_key;
+    uint32_t post_cycles;
+    uint32_t post_tick;
+    volatile uint32_t ready;
+} work_item_t;
+
+typedef struct
+{
+    work_item_t items[WORK_QUEUE_SIZE];
+    volatile uint32_t head;      /* Free-running count of reserved slots */
+    volatile uint32_t tail;      /* Free-running count of consumed slots */
+} work_ring_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static work_ring_t rings[WORK_PRIORITY_COUNT];
+
+/* One bit per coalescing key, set while an item with that key is pending */
+static volatile uint32_t coalesce_pending = 0u;
+
+static volatile work_queue_stats_t queue_stats;
+
+/*******************************************************************************
+* Function Name: atomic_add
+********************************************************************************
+* Summary:
+*  Adds a value to a word shared between interrupt priorities.
+*
+* Parameters:
+*  volatile uint32_t *word : Word to update
+*  uint32_t value          : Value to add
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void atomic_add(volatile uint32_t *word, uint32_t value)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while (0u != __STREXW(old + value, word));
+}
+
+/*******************************************************************************
+* Function Name: atomic_fetch_or
+********************************************************************************
+* Summary:
+*  Sets bits of a shared word and returns its previous value.
+*
+* Parameters:
+*  volatile uint32_t *word : Word to update
+*  uint32_t bits           : Bits to set
+*
+* Return:
+*  uint32_t : Value before the update
+*
+*******************************************************************************/
+static uint32_t atomic_fetch_or(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while (0u != __STREXW(old | bits, word));
+
+    return old;
+}
+
+/*******************************************************************************
+* Function Name: atomic_clear
+********************************************************************************
+* Summary:
+*  Clears bits of a shared word.
+*
+* Parameters:
+*  volatile uint32_t *word : Word to update
+*  uint32_t bits           : Bits to clear
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void atomic_clear(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while (0u != __STREXW(old & ~bits, word));
+}
+
+/*******************************************************************************
+* Function Name: work_queue_post
+********************************************************************************
+* Summary:
+*  Queues a handler to be run by work_queue_drain(). Safe to call from any
+*  interrupt priority and from the main loop.
+*
+* Parameters:
+*  work_priority_t priority : Priority level of the item
+*  work_handler_t handler   : Function to run
+*  uint32_t arg             : Argument passed to the function
+*  uint32_t coalesce_key    : 0-31 to merge with a pending item of the same
+*                             key, WORK_QUEUE_NO_COALESCE otherwise
+*
+* Return:
+*  bool : false if the item was dropped because the level was full
+*
+*******************************************************************************/
+APP_RAMFUNC_BEGIN
+bool work_queue_post(work_priority_t priority, work_handler_t handler,
+                     uint32_t arg, uint32_t coalesce_key)
+{
+    work_ring_t *ring = &rings[priority];
+    work_item_t *item;
+    uint32_t key_bit = 0u;
+    uint32_t head;
+    uint32_t depth;
+
+    if (coalesce_key <= WORK_QUEUE_MAX_COALESCE_KEY)
+    {
+        key_bit = 1uL << coalesce_key;
+        if (0u != (atomic_fetch_or(&coalesce_pending, key_bit) & key_bit))
+        {
+            atomic_add(&queue_stats.coalesced, 1u);
+            return true;
+        }
+    }
+
+    /* Reserve a slot */
+    do
+    {
+        head = __LDREXW(&ring->head);
+        depth = head - ring->tail;
+        if (depth >= WORK_QUEUE_SIZE)
+        {
+            __CLREX();
+            atomic_clear(&coalesce_pending, key_bit);
+            atomic_add(&queue_stats.dropped, 1u);
+            return false;
+        }
+    } while (0u != __STREXW(head + 1u, &ring->head));
+
+    item = &ring->items[head & WORK_QUEUE_MASK];
+    item->handler = handler;
+    item->arg = arg;
+    item->coalesce_key = key_bit;
+    item->post_cycles = cycle_count_get();
+    item->post_tick = rtc_tick_count();
+
+    /* Publish the slot only once it is complete */
+    __DMB();
+    item->ready = 1u;
+
+    atomic_add(&queue_stats.posted, 1u);
+
+    /* Best effort: a concurrent post may overwrite a slightly larger value */
+    if ((depth + 1u) > queue_stats.max_depth)
+    {
+        queue_stats.max_depth = depth + 1u;
+    }
+
+    return true;
+}
+APP_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: work_queue_drain
+********************************************************************************
+* Summary:
+*  Runs the pending items, always taking the next item from the highest
+*  priority level that is not empty, until all levels are empty. Must only be
+*  called from the main loop.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of items run
+*
+*******************************************************************************/
+uint32_t work_queue_drain(void)
+{
+    work_ring_t *ring;
+    work_item_t *item;
+    work_handler_t handler;
+    uint32_t arg;
+    uint32_t latency;
+    uint32_t level;
+    uint32_t count = 0u;
+
+    level = 0u;
+    while (level < (uint32_t)WORK_PRIORITY_COUNT)
+    {
+        ring = &rings[level];
+        item = &ring->items[ring->tail & WORK_QUEUE_MASK];
+
+        if ((ring->tail == ring->head) || (0u == item->ready))
+        {
+            level++;
+            continue;
+        }
+
+        handler = item->handler;
+        arg = item->arg;
+        latency = cycle_count_get() - item->post_cycles;
+        if ((rtc_tick_count() - item->post_tick) > 1u)
+        {
+            latency = WORK_QUEUE_LATENCY_SATURATED;
+        }
+
+        /* A post with the same key from now on queues a new item */
+        if (0u != item->coalesce_key)
+        {
+            atomic_clear(&coalesce_pending, item->coalesce_key);
+        }
+
+        item->ready = 0u;
+        __DMB();
+        ring->tail = ring->tail + 1u;
+
+        queue_stats.executed++;
+        if (WORK_QUEUE_LATENCY_SATURATED == latency)
+        {
+            queue_stats.long_waits++;
+        }
+        else
+        {
+            queue_stats.total_latency += latency;
+        }
+        if (latency > queue_stats.max_latency)
+        {
+            queue_stats.max_latency = latency;
+        }
+
+        trace_record(TRACE_EVENT_WORK_BEGIN, (uint32_t)(uintptr_t)handler);
+        handler(arg);
+        trace_record(TRACE_EVENT_WORK_END, 0u);
+        count++;
+
+        /* The handler may have posted more urgent work */
+        level = 0u;
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: work_queue_is_empty
+********************************************************************************
+* Summary:
+*  Checks whether no item is pending on any level.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool : true if all levels are empty
+*
+*******************************************************************************/
+bool work_queue_is_empty(void)
+{
+    return (0u == work_queue_depth());
+}
+
+/*******************************************************************************
+* Function Name: work_queue_depth
+********************************************************************************
+* Summary:
+*  Returns the number of pending items on all levels.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t : Number of pending items
+*
+*******************************************************************************/
+uint32_t work_queue_depth(void)
+{
+    uint32_t depth = 0u;
+    uint32_t level;
+
+    for (level = 0u; level < (uint32_t)WORK_PRIORITY_COUNT; level++)
+    {
+        depth += rings[level].head - rings[level].tail;
+    }
+
+    return depth;
+}
+
+/*******************************************************************************
+* Function Name: work_queue_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the queue statistics.
+*
+* Parameters:
+*  work_queue_stats_t *stats : Destination of the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void work_queue_get_stats(work_queue_stats_t *stats)
+{
+    uint32_t interruptState = Cy_SysLib_EnterCriticalSection();
+
+    stats->posted = queue_stats.posted;
+    stats->coalesced = queue_stats.coalesced;
+    stats->dropped = queue_stats.dropped;
+    stats->executed = queue_stats.executed;
+    stats->max_depth = queue_stats.max_depth;
+    stats->max_latency = queue_stats.max_latency;
+    stats->total_latency = queue_stats.total_latency;
+    stats->long_waits = queue_stats.long_waits;
+
+    Cy_SysLib_ExitCriticalSection(interruptState);
+}
+
+/* [] END OF FILE */
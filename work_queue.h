@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name:   work_queue.h
+*
+* Description: This file contains the declarations of the deferred work queue
+*              used to move processing out of the interrupt handlers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+/******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of slots per priority level, must be a power of two */
+#define WORK_QUEUE_SIZE              (16u)
+
+/* Pass as the coalescing key to never merge an item with a pending one */
+#define WORK_QUEUE_NO_COALESCE       (0xFFFFFFFFu)
+
+/* Coalescing keys are bit positions, 0 to 31 */
+#define WORK_QUEUE_MAX_COALESCE_KEY  (31u)
+
+/* Delay recorded for an item that waited across more than one RTC tick: the
+ * cycle counter may have wrapped or changed its clock in the meantime */
+#define WORK_QUEUE_LATENCY_SATURATED (0xFFFFFFFFu)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    WORK_PRIORITY_HIGH = 0,
+    WORK_PRIORITY_NORMAL,
+    WORK_PRIORITY_LOW,
+    WORK_PRIORITY_COUNT
+} work_priority_t;
+
+typedef void (*work_handler_t)(uint32_t arg);
+
+typedef struct
+{
+    uint32_t posted;             /* Items accepted */
+    uint32_t coalesced;          /* Posts merged into a pending item */
+    uint32_t dropped;            /* Posts rejected because the level was full */
+    uint32_t executed;           /* Items run by work_queue_drain() */
+    uint32_t max_depth;          /* Highest number of pending items seen */
+    uint32_t max_latency;        /* Highest post-to-start delay, in cycles */
+    uint64_t total_latency;      /* Sum of post-to-start delays, in cycles,
+                                  * the saturated ones excluded */
+    uint32_t long_waits;         /* Items whose delay was saturated */
+} work_queue_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool work_queue_post(work_priority_t priority, work_handler_t handler,
+                     uint32_t arg, uint32_t coalesce_key);
+uint32_t work_queue_drain(void);
+bool work_queue_is_empty(void);
+uint32_t work_queue_depth(void);
+void work_queue_get_stats(work_queue_stats_t *stats);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* WORK_QUEUE_H */
+
+/* [] END OF FILE */